@@ -46,6 +46,7 @@ openhevc_files := \
     libavutil/arm/cpu.c \
     gpac/modules/openhevc_dec/openHevcWrapper.c \
     libavformat/allformats.c \
+    libavformat/async.c \
     libavformat/avio.c \
     libavformat/aviobuf.c \
     libavformat/cutils.c \
@@ -117,7 +118,12 @@ openhevc_files := \
     libavcodec/arm/hevcdsp_init_arm.c \
     libavutil/arm/asm.S \
     libavcodec/arm/hevcdsp_deblock_neon.S \
-    libavcodec/arm/hevcdsp_idct_neon.S \
+    libavcodec/arm/hevc_idct_neon.c.neon \
+    libavcodec/arm/hevc_intra_pred_neon.c.neon \
+    libavcodec/arm/hevc_mc_neon.c.neon \
+    libavcodec/arm/hevc_sao_neon.c.neon \
+    libavcodec/arm/hevcdsp_init_neon.c.neon \
+    libavcodec/arm/hevcpred_init_arm.c \
     libavcodec/arm/hevcdsp_qpel_neon.S \
     libavcodec/arm/hevcdsp_epel_neon.S \
     libavcodec/arm/dsputil_init_arm.c \
@@ -0,0 +1,168 @@
+# Conformance and performance regression run, invoked by the conformance
+# target with cmake -P.
+#
+# Every stream of CONFORMANCE_DIR is decoded by CONFORMANCE_TOOL single
+# threaded first: the SEI decoded picture hashes must all match and the MD5
+# of the output pictures becomes the reference. The stream is then decoded
+# with frame, slice and frame+slice threading for each count of
+# CONFORMANCE_THREADS and the output must be the same as the reference.
+#
+# The speed of a stream is the best of CONFORMANCE_RUNS single threaded
+# decodes. It is compared with the one stored for the stream in
+# CONFORMANCE_BASELINE, a stream more than CONFORMANCE_TOLERANCE percent
+# slower fails. Passing streams missing from the baseline are added to it,
+# and CONFORMANCE_UPDATE rewrites the stored speed of every passing stream.
+#
+# CONFORMANCE_EMULATOR, comma separated, prefixes every decode when the tool
+# is cross compiled (qemu-aarch64 -L <sysroot> for example).
+
+if(NOT CONFORMANCE_TOOL OR NOT CONFORMANCE_DIR)
+    message(FATAL_ERROR "CONFORMANCE_TOOL and CONFORMANCE_DIR must be set")
+endif()
+if(NOT CONFORMANCE_THREADS)
+    set(CONFORMANCE_THREADS 1 2 4 8 16)
+endif()
+string(REPLACE "," ";" CONFORMANCE_THREADS "${CONFORMANCE_THREADS}")
+string(REPLACE "," ";" CONFORMANCE_EMULATOR "${CONFORMANCE_EMULATOR}")
+if(NOT CONFORMANCE_TOLERANCE)
+    set(CONFORMANCE_TOLERANCE 10)
+endif()
+if(NOT CONFORMANCE_RUNS)
+    set(CONFORMANCE_RUNS 3)
+endif()
+
+file(GLOB streams
+    ${CONFORMANCE_DIR}/*.bit
+    ${CONFORMANCE_DIR}/*.bin
+    ${CONFORMANCE_DIR}/*.265
+    ${CONFORMANCE_DIR}/*.hevc
+)
+list(SORT streams)
+list(LENGTH streams nb_streams)
+if(nb_streams EQUAL 0)
+    message(FATAL_ERROR "no stream found in ${CONFORMANCE_DIR}")
+endif()
+
+# Baseline lines are "<stream> <fps>"
+set(baseline_names)
+if(CONFORMANCE_BASELINE AND EXISTS ${CONFORMANCE_BASELINE})
+    file(STRINGS ${CONFORMANCE_BASELINE} baseline_lines)
+    foreach(line ${baseline_lines})
+        if(line MATCHES "^([^ ]+) +([0-9.]+)$")
+            list(APPEND baseline_names ${CMAKE_MATCH_1})
+            set(baseline_fps_${CMAKE_MATCH_1} ${CMAKE_MATCH_2})
+        endif()
+    endforeach()
+endif()
+
+# Runs the tool and sets <prefix>_ok, _frames, _md5, _fps and _errors
+macro(decode_stream prefix stream threads type)
+    execute_process(
+        COMMAND ${CONFORMANCE_EMULATOR} ${CONFORMANCE_TOOL} -i ${stream} -p ${threads} -f ${type}
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE  errors
+    )
+    set(${prefix}_ok FALSE)
+    if(result EQUAL 0 AND output MATCHES "frames=([0-9]+) md5=([0-9a-f]+) fps=([0-9.]+) md5_errors=([0-9]+)")
+        set(${prefix}_ok     TRUE)
+        set(${prefix}_frames ${CMAKE_MATCH_1})
+        set(${prefix}_md5    ${CMAKE_MATCH_2})
+        set(${prefix}_fps    ${CMAKE_MATCH_3})
+        set(${prefix}_errors ${CMAKE_MATCH_4})
+    endif()
+endmacro()
+
+# fps values are printed with two decimals, compare them in hundredths as
+# math(EXPR) only knows integers
+macro(fps_to_int var fps)
+    if("${fps}" MATCHES "^([0-9]+)\\.([0-9])([0-9])?")
+        set(${var} "${CMAKE_MATCH_1}${CMAKE_MATCH_2}0")
+        if(CMAKE_MATCH_3)
+            set(${var} "${CMAKE_MATCH_1}${CMAKE_MATCH_2}${CMAKE_MATCH_3}")
+        endif()
+    else()
+        set(${var} "${fps}00")
+    endif()
+    string(REGEX REPLACE "^0+([0-9])" "\\1" ${var} "${${var}}")
+    math(EXPR ${var} "${${var}}")
+endmacro()
+
+set(failures 0)
+foreach(stream ${streams})
+    get_filename_component(name ${stream} NAME)
+    decode_stream(ref ${stream} 1 1)
+    if(NOT ref_ok)
+        message("FAIL ${name}: decoding failed")
+        math(EXPR failures "${failures} + 1")
+    elseif(NOT ref_errors EQUAL 0)
+        message("FAIL ${name}: ${ref_errors} pictures with an incorrect MD5")
+        math(EXPR failures "${failures} + 1")
+    else()
+        set(status "ok")
+        foreach(type 1 2 4)
+            foreach(threads ${CONFORMANCE_THREADS})
+                if(threads GREATER 1)
+                    decode_stream(run ${stream} ${threads} ${type})
+                    if(NOT run_ok)
+                        set(status "decoding failed with ${threads} threads of type ${type}")
+                    elseif(NOT run_frames EQUAL ref_frames OR NOT run_md5 STREQUAL ref_md5)
+                        set(status "output differs with ${threads} threads of type ${type}")
+                    endif()
+                endif()
+            endforeach()
+        endforeach()
+
+        if(status STREQUAL "ok")
+            set(fps ${ref_fps})
+            fps_to_int(best ${ref_fps})
+            if(CONFORMANCE_RUNS GREATER 1)
+                foreach(run RANGE 2 ${CONFORMANCE_RUNS})
+                    decode_stream(perf ${stream} 1 1)
+                    if(perf_ok)
+                        fps_to_int(cur ${perf_fps})
+                        if(cur GREATER best)
+                            set(best ${cur})
+                            set(fps  ${perf_fps})
+                        endif()
+                    endif()
+                endforeach()
+            endif()
+
+            list(FIND baseline_names ${name} index)
+            if(index EQUAL -1 OR CONFORMANCE_UPDATE)
+                if(index EQUAL -1)
+                    list(APPEND baseline_names ${name})
+                endif()
+                set(baseline_fps_${name} ${fps})
+            else()
+                fps_to_int(base ${baseline_fps_${name}})
+                math(EXPR min "${base} * (100 - ${CONFORMANCE_TOLERANCE}) / 100")
+                if(best LESS min)
+                    set(status "${fps} fps, baseline ${baseline_fps_${name}} fps")
+                endif()
+            endif()
+        endif()
+
+        if(status STREQUAL "ok")
+            message("ok   ${name}: ${ref_frames} frames, ${fps} fps")
+        else()
+            message("FAIL ${name}: ${status}")
+            math(EXPR failures "${failures} + 1")
+        endif()
+    endif()
+endforeach()
+
+if(CONFORMANCE_BASELINE)
+    set(baseline "")
+    list(SORT baseline_names)
+    foreach(name ${baseline_names})
+        set(baseline "${baseline}${name} ${baseline_fps_${name}}\n")
+    endforeach()
+    file(WRITE ${CONFORMANCE_BASELINE} "${baseline}")
+endif()
+
+if(failures GREATER 0)
+    message(FATAL_ERROR "${failures} of ${nb_streams} streams failed")
+endif()
+message("${nb_streams} streams passed")
@@ -0,0 +1,21 @@
+# Cross compilation for AArch64 Linux, the check and conformance targets run
+# through qemu-user:
+#   cmake -DCMAKE_TOOLCHAIN_FILE=MyCMakeScripts/toolchain-aarch64-linux-gnu.cmake \
+#         -DENABLE_DSPCHECK=ON ..
+#   make dspcheck
+
+set(CMAKE_SYSTEM_NAME      Linux)
+set(CMAKE_SYSTEM_PROCESSOR aarch64)
+
+set(CROSS_PREFIX  "aarch64-linux-gnu-"       CACHE STRING "Prefix of the cross compiler")
+set(CROSS_SYSROOT "/usr/aarch64-linux-gnu"   CACHE PATH   "Target root, given to qemu with -L")
+
+set(CMAKE_C_COMPILER   ${CROSS_PREFIX}gcc)
+set(CMAKE_CXX_COMPILER ${CROSS_PREFIX}g++)
+
+set(CMAKE_FIND_ROOT_PATH ${CROSS_SYSROOT})
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
+
+set(CMAKE_CROSSCOMPILING_EMULATOR qemu-aarch64 -L ${CROSS_SYSROOT})
@@ -0,0 +1,25 @@
+# Cross compilation for ARMv7 Linux with NEON, the check and conformance
+# targets run through qemu-user:
+#   cmake -DCMAKE_TOOLCHAIN_FILE=MyCMakeScripts/toolchain-arm-linux-gnueabihf.cmake \
+#         -DENABLE_DSPCHECK=ON ..
+#   make dspcheck
+
+set(CMAKE_SYSTEM_NAME      Linux)
+set(CMAKE_SYSTEM_PROCESSOR armv7l)
+
+set(CROSS_PREFIX  "arm-linux-gnueabihf-"     CACHE STRING "Prefix of the cross compiler")
+set(CROSS_SYSROOT "/usr/arm-linux-gnueabihf" CACHE PATH   "Target root, given to qemu with -L")
+
+set(CMAKE_C_COMPILER   ${CROSS_PREFIX}gcc)
+set(CMAKE_CXX_COMPILER ${CROSS_PREFIX}g++)
+set(CMAKE_ASM_COMPILER ${CROSS_PREFIX}gcc)
+
+set(CMAKE_C_FLAGS_INIT   "-march=armv7-a -mfpu=neon")
+set(CMAKE_ASM_FLAGS_INIT "-march=armv7-a -mfpu=neon")
+
+set(CMAKE_FIND_ROOT_PATH ${CROSS_SYSROOT})
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
+
+set(CMAKE_CROSSCOMPILING_EMULATOR qemu-arm -L ${CROSS_SYSROOT})
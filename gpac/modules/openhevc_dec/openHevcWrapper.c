@@ -19,14 +19,27 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 #include <stdio.h>
+#include "config.h"
 #include "openHevcWrapper.h"
 #include "libavcodec/avcodec.h"
 #include "libavformat/avformat.h"
+#include "libavutil/cpu.h"
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
 
+#if HAVE_SSE2
+#include <emmintrin.h>
+#endif
+#if HAVE_PTHREADS
+#include <pthread.h>
+#elif HAVE_W32THREADS
+#include "compat/w32pthreads.h"
+#endif
+
 #define MAX_DECODERS 2
 #define ACTIVE_NAL
+/* frame threads that still overlap when pictures are not reordered */
+#define AUTO_LOW_DELAY_FRAME_THREADS 4
 typedef struct OpenHevcWrapperContext {
     AVCodec *codec;
     AVCodecContext *c;
@@ -40,8 +53,36 @@ typedef struct OpenHevcWrapperContexts {
     int nb_decoders;
     int active_layer;
     int display_layer;
+    int target_layer;    ///< layer requested with libOpenHevcSwitchLayer(), -1 once reached
     int set_display;
     int set_vps;
+    int output_format;   ///< OpenHevc_OutputFormat of libOpenHevcGetOutputCpy()
+    int nal_length_size; ///< NAL unit length size with hvcC extradata, 0 for Annex B
+
+    int thread_budget;   ///< cores per layer with OPENHEVC_THREAD_AUTO, 0 otherwise
+    int frame_threads;   ///< current plan with OPENHEVC_THREAD_AUTO
+    int slice_threads;
+    int fed;             ///< the current decoders have been given a packet
+    int replan;          ///< reopen the decoders once they are drained
+    AVPacket *queue;     ///< packets held back while the decoders are drained
+    int nb_queued;
+    unsigned int queue_allocated;
+
+    int async_depth;     ///< queue depth with libOpenHevcStartAsync(), 0 otherwise
+    AVPacket *async_in;  ///< packets for the decoding thread, an empty one ends the stream
+    int nb_async_in;
+    AVFrame **async_out; ///< pictures waiting for libOpenHevcReceiveFrame()
+    int nb_async_out;
+    AVFrame *async_frame;
+    int async_busy;      ///< the decoding thread is working on a packet
+    int async_eof;
+    int async_abort;
+    void (*frame_callback)(void *opaque);
+    void *callback_opaque;
+    pthread_t       async_thread;
+    pthread_mutex_t async_mutex;
+    pthread_cond_t  async_cond;      ///< wakes up the decoding thread
+    pthread_cond_t  async_idle_cond; ///< signalled when the decoding thread is done with a packet
 } OpenHevcWrapperContexts;
 
 OpenHevc_Handle libOpenHevcInit(int nb_pthreads, int thread_type)
@@ -54,6 +95,7 @@ OpenHevc_Handle libOpenHevcInit(int nb_pthreads, int thread_type)
     openHevcContexts->nb_decoders   = MAX_DECODERS;
     openHevcContexts->active_layer  = MAX_DECODERS-1;
     openHevcContexts->display_layer = MAX_DECODERS-1;
+    openHevcContexts->target_layer  = -1;
     openHevcContexts->wraper = av_malloc(sizeof(OpenHevcWrapperContext*)*openHevcContexts->nb_decoders);
     for(i=0; i < openHevcContexts->nb_decoders; i++){
         openHevcContext = openHevcContexts->wraper[i] = av_malloc(sizeof(OpenHevcWrapperContext));
@@ -89,9 +131,33 @@ OpenHevc_Handle libOpenHevcInit(int nb_pthreads, int thread_type)
         /*  Set the decoder id    */
         av_opt_set_int(openHevcContext->c->priv_data, "decoder-id", i, 0);
     }
+    if (thread_type == OPENHEVC_THREAD_AUTO) {
+        openHevcContexts->thread_budget = nb_pthreads > 0 ? nb_pthreads : av_cpu_count();
+        openHevcContexts->frame_threads = openHevcContexts->thread_budget;
+        openHevcContexts->slice_threads = 1;
+        openHevcContexts->wraper[0]->parser->flags |= PARSER_FLAG_COMPLETE_FRAMES;
+    }
     return (OpenHevc_Handle) openHevcContexts;
 }
 
+static void set_thread_plan(OpenHevcWrapperContexts *openHevcContexts, AVCodecContext *c)
+{
+    int frame_threads = openHevcContexts->frame_threads;
+    int slice_threads = openHevcContexts->slice_threads;
+
+    if (frame_threads > 1 && slice_threads > 1) {
+        c->thread_type        = FF_THREAD_FRAME_SLICE;
+        c->thread_count       = slice_threads;
+        c->thread_count_frame = frame_threads;
+    } else if (slice_threads > 1) {
+        c->thread_type        = FF_THREAD_SLICE;
+        c->thread_count       = slice_threads;
+    } else {
+        c->thread_type        = FF_THREAD_FRAME;
+        c->thread_count       = frame_threads;
+    }
+}
+
 int libOpenHevcStartDecoder(OpenHevc_Handle openHevcHandle)
 {
     OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
@@ -99,6 +165,8 @@ int libOpenHevcStartDecoder(OpenHevc_Handle openHevcHandle)
     int i;
     for(i=0; i < openHevcContexts->nb_decoders; i++) {
         openHevcContext = openHevcContexts->wraper[i];
+        if (openHevcContexts->thread_budget)
+            set_thread_plan(openHevcContexts, openHevcContext->c);
         if (avcodec_open2(openHevcContext->c, openHevcContext->codec, NULL) < 0) {
             fprintf(stderr, "could not open codec\n");
             return -1;
@@ -109,11 +177,74 @@ int libOpenHevcStartDecoder(OpenHevc_Handle openHevcHandle)
     return 1;
 }
 
-int libOpenHevcDecode(OpenHevc_Handle openHevcHandle, const unsigned char *buff, int au_len, int64_t pts)
+static void layer_nal(const uint8_t *nal, int from, int to, int *seen, int *irap)
+{
+    int type  = (nal[0] >> 1) & 0x3f;
+    int layer = ((nal[0] & 1) << 5) | (nal[1] >> 3);
+
+    if (type < 32 && layer > from && layer <= to && !(*seen & (1 << layer))) {
+        *seen |= 1 << layer;
+        if (type >= 16 && type <= 23)
+            *irap |= 1 << layer;
+    }
+}
+
+/* Check that every layer above from, up to to, starts with an IRAP picture
+ * in this access unit: the only place where their decoding can begin, as
+ * their earlier pictures were never decoded. The NAL units are split on
+ * their length fields with nal_length_size, on start codes otherwise. */
+static int layers_start(const uint8_t *buf, int size, int nal_length_size,
+                        int from, int to)
+{
+    int i, j, len, seen = 0, irap = 0;
+
+    if (nal_length_size) {
+        for (i = 0; i + nal_length_size + 2 <= size; i += nal_length_size + len) {
+            for (j = 0, len = 0; j < nal_length_size; j++)
+                len = (len << 8) | buf[i + j];
+            if (len < 2 || len > size - i - nal_length_size)
+                break;
+            layer_nal(buf + i + nal_length_size, from, to, &seen, &irap);
+        }
+    } else {
+        for (i = 0; i + 4 < size; i++) {
+            if (!buf[i] && !buf[i + 1] && buf[i + 2] == 1) {
+                layer_nal(buf + i + 3, from, to, &seen, &irap);
+                i += 2;
+            }
+        }
+    }
+    return irap == (1 << (to + 1)) - (1 << (from + 1));
+}
+
+/* Apply a pending layer switch before the access unit in buf. The layers
+ * that are dropped or added are flushed, the ones below keep their
+ * references and their output goes on. */
+static void switch_layer(OpenHevcWrapperContexts *openHevcContexts, const uint8_t *buf, int size)
+{
+    int target = openHevcContexts->target_layer;
+    int i;
+
+    if (target > openHevcContexts->active_layer &&
+        !layers_start(buf, size, openHevcContexts->nal_length_size,
+                      openHevcContexts->active_layer, target))
+        return;
+
+    for (i = FFMIN(openHevcContexts->active_layer, target) + 1;
+         i <= FFMAX(openHevcContexts->active_layer, target); i++)
+        avcodec_flush_buffers(openHevcContexts->wraper[i]->c);
+    openHevcContexts->active_layer  = target;
+    openHevcContexts->display_layer = target;
+    openHevcContexts->target_layer  = -1;
+}
+
+static int decode_packet(OpenHevcWrapperContexts *openHevcContexts, const unsigned char *buff, int au_len, int64_t pts)
 {
     int got_picture[MAX_DECODERS], len=0, i, max_layer;
-    OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
     OpenHevcWrapperContext  *openHevcContext;
+
+    if (openHevcContexts->target_layer >= 0 && au_len)
+        switch_layer(openHevcContexts, buff, au_len);
     for(i =0; i < MAX_DECODERS; i++)  {
         got_picture[i]                 = 0;
         openHevcContext                = openHevcContexts->wraper[i];
@@ -129,6 +260,8 @@ int libOpenHevcDecode(OpenHevc_Handle openHevcHandle, const unsigned char *buff,
         openHevcContext->avpkt.pts  = pts;
         len                         = avcodec_decode_video2( openHevcContext->c, openHevcContext->picture,
                                                              &got_picture[i], &openHevcContext->avpkt);
+        if (au_len && openHevcContext->avpkt.side_data_elems)
+            av_packet_free_side_data(&openHevcContext->avpkt);
         if(i+1 < openHevcContexts->nb_decoders)
             openHevcContexts->wraper[i+1]->c->BL_frame = openHevcContexts->wraper[i]->c->BL_frame;
     }
@@ -136,6 +269,18 @@ int libOpenHevcDecode(OpenHevc_Handle openHevcHandle, const unsigned char *buff,
         fprintf(stderr, "Error while decoding frame \n");
         return -1;
     }
+    /* pictures before the seek target are not output, so the first one
+     * output from it on ends the seek */
+    for (i = 0; i < openHevcContexts->nb_decoders; i++) {
+        AVCodecContext *c = openHevcContexts->wraper[i]->c;
+        int64_t out_pts   = openHevcContexts->wraper[i]->picture->pkt_pts;
+        if (got_picture[i] && c->seek_pts != AV_NOPTS_VALUE &&
+            out_pts != AV_NOPTS_VALUE && out_pts >= c->seek_pts) {
+            for (i = 0; i < openHevcContexts->nb_decoders; i++)
+                openHevcContexts->wraper[i]->c->seek_pts = AV_NOPTS_VALUE;
+            break;
+        }
+    }
     if(openHevcContexts->set_display)
         max_layer = openHevcContexts->display_layer;
     else
@@ -154,6 +299,361 @@ int libOpenHevcDecode(OpenHevc_Handle openHevcHandle, const unsigned char *buff,
     return 0;
 }
 
+/* Replace every decoder by a new one with the current thread plan, keeping
+ * the settings of the old one */
+static int reopen_decoders(OpenHevcWrapperContexts *openHevcContexts)
+{
+    OpenHevcWrapperContext *openHevcContext;
+    AVCodecContext *c;
+    int i;
+
+    for (i = 0; i < openHevcContexts->nb_decoders; i++) {
+        openHevcContext = openHevcContexts->wraper[i];
+        c = avcodec_alloc_context3(openHevcContext->codec);
+        if (!c || avcodec_copy_context(c, openHevcContext->c) < 0) {
+            avcodec_free_context(&c);
+            return -1;
+        }
+        avcodec_close(openHevcContext->c);
+        av_freep(&openHevcContext->c->extradata);
+        av_freep(&openHevcContext->c);
+        openHevcContext->c = c;
+    }
+    return libOpenHevcStartDecoder(openHevcContexts) < 0 ? -1 : 0;
+}
+
+static void plan_threads(OpenHevcWrapperContexts *openHevcContexts, AVCodecParserContext *parser,
+                         int *frame_threads, int *slice_threads)
+{
+    int budget = openHevcContexts->thread_budget;
+
+    /* Frame threads scale with the pictures in flight. Without reordering
+     * each picture waits on the rows of the previous one, so only a few of
+     * them overlap and rows or tiles get the remaining cores. */
+    *frame_threads = budget;
+    if (parser->entry_points > 1 && !parser->reorder_depth)
+        *frame_threads = FFMIN(budget, AUTO_LOW_DELAY_FRAME_THREADS);
+    *slice_threads = av_clip(budget / *frame_threads, 1, parser->entry_points);
+}
+
+/* IDR and BLA pictures start a new coded video sequence: nothing after them
+ * refers to earlier pictures, so the decoders can be replaced there. The new
+ * decoders only keep the extradata, so the access unit must also carry the
+ * parameter sets: those sent in band before would be lost. */
+static int starts_sequence(const uint8_t *buf, int size)
+{
+    int i, type, ps = 0;
+
+    for (i = 0; i + 3 < size; i++) {
+        if (!buf[i] && !buf[i + 1] && buf[i + 2] == 1) {
+            type = (buf[i + 3] >> 1) & 0x3f;
+            if (type >= 32 && type <= 34) /* VPS, SPS, PPS */
+                ps |= 1 << (type - 32);
+            else if (type < 32) /* first VCL NAL unit: BLA_W_LP to IDR_N_LP */
+                return type >= 16 && type <= 20 && ps == 7;
+            i += 2;
+        }
+    }
+    return 0;
+}
+
+static int queue_packet(OpenHevcWrapperContexts *openHevcContexts, const unsigned char *buff, int au_len, int64_t pts)
+{
+    AVPacket *queue = av_fast_realloc(openHevcContexts->queue, &openHevcContexts->queue_allocated,
+                                      (openHevcContexts->nb_queued + 1) * sizeof(*queue));
+    AVPacket *pkt;
+
+    if (!queue)
+        return -1;
+    openHevcContexts->queue = queue;
+    pkt = &queue[openHevcContexts->nb_queued];
+    if (av_new_packet(pkt, au_len) < 0)
+        return -1;
+    memcpy(pkt->data, buff, au_len);
+    pkt->pts = pts;
+    openHevcContexts->nb_queued++;
+    return 0;
+}
+
+static void drop_queue(OpenHevcWrapperContexts *openHevcContexts)
+{
+    while (openHevcContexts->nb_queued)
+        av_free_packet(&openHevcContexts->queue[--openHevcContexts->nb_queued]);
+}
+
+static int decode_auto(OpenHevcWrapperContexts *openHevcContexts, const unsigned char *buff, int au_len, int64_t pts)
+{
+    AVCodecParserContext *parser = openHevcContexts->wraper[0]->parser;
+    uint8_t *out;
+    int frame_threads, slice_threads, out_size, got_picture;
+    AVPacket pkt;
+
+    if (au_len > 0) {
+        av_parser_parse2(parser, openHevcContexts->wraper[0]->c, &out, &out_size,
+                         buff, au_len, pts, pts, 0);
+        if (parser->entry_points && !openHevcContexts->replan) {
+            plan_threads(openHevcContexts, parser, &frame_threads, &slice_threads);
+            if ((frame_threads != openHevcContexts->frame_threads ||
+                 slice_threads != openHevcContexts->slice_threads) &&
+                (!openHevcContexts->fed || starts_sequence(buff, au_len))) {
+                openHevcContexts->frame_threads = frame_threads;
+                openHevcContexts->slice_threads = slice_threads;
+                openHevcContexts->replan        = 1;
+            }
+        }
+        if (!openHevcContexts->replan && !openHevcContexts->nb_queued) {
+            openHevcContexts->fed = 1;
+            return decode_packet(openHevcContexts, buff, au_len, pts);
+        }
+        if (queue_packet(openHevcContexts, buff, au_len, pts) < 0)
+            return -1;
+    }
+
+    if (openHevcContexts->replan) {
+        /* hand out what the old decoders still hold, one picture per call */
+        if (openHevcContexts->fed) {
+            got_picture = decode_packet(openHevcContexts, NULL, 0, AV_NOPTS_VALUE);
+            if (got_picture > 0)
+                return got_picture;
+        }
+        openHevcContexts->replan = 0;
+        openHevcContexts->fed    = 0;
+        if (reopen_decoders(openHevcContexts) < 0)
+            return -1;
+    }
+
+    while (openHevcContexts->nb_queued) {
+        pkt = openHevcContexts->queue[0];
+        memmove(openHevcContexts->queue, openHevcContexts->queue + 1,
+                --openHevcContexts->nb_queued * sizeof(pkt));
+        openHevcContexts->fed = 1;
+        got_picture = decode_packet(openHevcContexts, pkt.data, pkt.size, pkt.pts);
+        av_free_packet(&pkt);
+        if (got_picture)
+            return got_picture;
+    }
+    return au_len > 0 ? 0 : decode_packet(openHevcContexts, NULL, 0, pts);
+}
+
+int libOpenHevcDecode(OpenHevc_Handle openHevcHandle, const unsigned char *buff, int au_len, int64_t pts)
+{
+    OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
+
+    if (openHevcContexts->thread_budget)
+        return decode_auto(openHevcContexts, buff, au_len, pts);
+    return decode_packet(openHevcContexts, buff, au_len, pts);
+}
+
+static void *async_decode_thread(void *arg)
+{
+    OpenHevcWrapperContexts *openHevcContexts = arg;
+    AVFrame  *frame;
+    AVPacket *pkt;
+    int got_picture;
+
+    pthread_mutex_lock(&openHevcContexts->async_mutex);
+    while (!openHevcContexts->async_abort) {
+        if (!openHevcContexts->nb_async_in || openHevcContexts->async_eof ||
+            openHevcContexts->nb_async_out == openHevcContexts->async_depth) {
+            pthread_cond_wait(&openHevcContexts->async_cond, &openHevcContexts->async_mutex);
+            continue;
+        }
+
+        /* the caller only appends to the input queue, so the head stays
+         * ours while the lock is released */
+        pkt = &openHevcContexts->async_in[0];
+        openHevcContexts->async_busy = 1;
+        pthread_mutex_unlock(&openHevcContexts->async_mutex);
+
+        got_picture = libOpenHevcDecode(openHevcContexts, pkt->size ? pkt->data : NULL,
+                                        pkt->size, pkt->pts);
+        frame = NULL;
+        if (got_picture > 0)
+            frame = av_frame_clone(openHevcContexts->wraper[openHevcContexts->display_layer]->picture);
+
+        pthread_mutex_lock(&openHevcContexts->async_mutex);
+        /* the end of the stream stays queued until the decoder is drained */
+        if (pkt->size || got_picture <= 0) {
+            if (!pkt->size)
+                openHevcContexts->async_eof = 1;
+            av_free_packet(pkt);
+            memmove(openHevcContexts->async_in, openHevcContexts->async_in + 1,
+                    --openHevcContexts->nb_async_in * sizeof(*pkt));
+        }
+        if (frame)
+            openHevcContexts->async_out[openHevcContexts->nb_async_out++] = frame;
+        openHevcContexts->async_busy = 0;
+        pthread_cond_broadcast(&openHevcContexts->async_idle_cond);
+
+        if (frame && openHevcContexts->frame_callback) {
+            pthread_mutex_unlock(&openHevcContexts->async_mutex);
+            openHevcContexts->frame_callback(openHevcContexts->callback_opaque);
+            pthread_mutex_lock(&openHevcContexts->async_mutex);
+        }
+    }
+    pthread_mutex_unlock(&openHevcContexts->async_mutex);
+
+    return NULL;
+}
+
+int libOpenHevcStartAsync(OpenHevc_Handle openHevcHandle, int queue_depth)
+{
+    OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
+    int i;
+
+    if (queue_depth <= 0 || openHevcContexts->async_depth)
+        return -1;
+
+    /* pictures outlive the next decode call in the output queue */
+    for (i = 0; i < openHevcContexts->nb_decoders; i++)
+        openHevcContexts->wraper[i]->c->refcounted_frames = 1;
+
+    openHevcContexts->async_in    = av_mallocz_array(queue_depth + 1, sizeof(*openHevcContexts->async_in));
+    openHevcContexts->async_out   = av_mallocz_array(queue_depth, sizeof(*openHevcContexts->async_out));
+    openHevcContexts->async_frame = av_frame_alloc();
+    if (!openHevcContexts->async_in || !openHevcContexts->async_out || !openHevcContexts->async_frame)
+        goto fail;
+
+    pthread_mutex_init(&openHevcContexts->async_mutex, NULL);
+    pthread_cond_init(&openHevcContexts->async_cond, NULL);
+    pthread_cond_init(&openHevcContexts->async_idle_cond, NULL);
+    if (pthread_create(&openHevcContexts->async_thread, NULL, async_decode_thread, openHevcContexts)) {
+        pthread_cond_destroy(&openHevcContexts->async_idle_cond);
+        pthread_cond_destroy(&openHevcContexts->async_cond);
+        pthread_mutex_destroy(&openHevcContexts->async_mutex);
+        goto fail;
+    }
+    openHevcContexts->async_depth = queue_depth;
+    return 0;
+fail:
+    av_freep(&openHevcContexts->async_in);
+    av_freep(&openHevcContexts->async_out);
+    av_frame_free(&openHevcContexts->async_frame);
+    return -1;
+}
+
+int libOpenHevcSendPacket(OpenHevc_Handle openHevcHandle, const unsigned char *buff, int au_len, int64_t pts)
+{
+    OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
+    AVPacket *pkt;
+    int ret = 0;
+
+    /* the queues and the lock only exist once the thread is started */
+    if (!openHevcContexts->async_depth)
+        return -1;
+    if (!buff)
+        au_len = 0;
+
+    pthread_mutex_lock(&openHevcContexts->async_mutex);
+    /* one slot more than the depth, so the end of the stream always fits */
+    if (openHevcContexts->nb_async_in >= openHevcContexts->async_depth + !au_len) {
+        ret = OPENHEVC_AGAIN;
+    } else {
+        pkt = &openHevcContexts->async_in[openHevcContexts->nb_async_in];
+        av_init_packet(pkt);
+        pkt->data = NULL;
+        pkt->size = 0;
+        if (au_len && av_new_packet(pkt, au_len) < 0) {
+            ret = -1;
+        } else {
+            if (au_len)
+                memcpy(pkt->data, buff, au_len);
+            pkt->pts = pts;
+            openHevcContexts->nb_async_in++;
+            openHevcContexts->async_eof = 0;
+            pthread_cond_signal(&openHevcContexts->async_cond);
+        }
+    }
+    pthread_mutex_unlock(&openHevcContexts->async_mutex);
+
+    return ret;
+}
+
+int libOpenHevcReceiveFrame(OpenHevc_Handle openHevcHandle)
+{
+    OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
+    AVFrame *frame;
+    int ret = 0;
+
+    if (!openHevcContexts->async_depth)
+        return -1;
+
+    pthread_mutex_lock(&openHevcContexts->async_mutex);
+    if (openHevcContexts->nb_async_out) {
+        frame = openHevcContexts->async_out[0];
+        memmove(openHevcContexts->async_out, openHevcContexts->async_out + 1,
+                --openHevcContexts->nb_async_out * sizeof(frame));
+        av_frame_unref(openHevcContexts->async_frame);
+        av_frame_move_ref(openHevcContexts->async_frame, frame);
+        av_frame_free(&frame);
+        pthread_cond_signal(&openHevcContexts->async_cond);
+        ret = 1;
+    } else if (openHevcContexts->async_eof && !openHevcContexts->nb_async_in) {
+        ret = OPENHEVC_EOF;
+    }
+    pthread_mutex_unlock(&openHevcContexts->async_mutex);
+
+    return ret;
+}
+
+void libOpenHevcSetFrameCallback(OpenHevc_Handle openHevcHandle, void (*callback)(void *opaque), void *opaque)
+{
+    OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
+
+    openHevcContexts->frame_callback  = callback;
+    openHevcContexts->callback_opaque = opaque;
+}
+
+/* Wait for the decoding thread to be done with its packet, with the lock
+ * kept until async_resume() */
+static void async_wait_idle(OpenHevcWrapperContexts *openHevcContexts)
+{
+    pthread_mutex_lock(&openHevcContexts->async_mutex);
+    while (openHevcContexts->async_busy)
+        pthread_cond_wait(&openHevcContexts->async_idle_cond, &openHevcContexts->async_mutex);
+}
+
+/* Drop everything queued and wait for the decoding thread to be idle. The
+ * lock is kept, so the decoders can be used until async_resume(). */
+static void async_pause(OpenHevcWrapperContexts *openHevcContexts)
+{
+    async_wait_idle(openHevcContexts);
+    while (openHevcContexts->nb_async_in)
+        av_free_packet(&openHevcContexts->async_in[--openHevcContexts->nb_async_in]);
+    while (openHevcContexts->nb_async_out)
+        av_frame_free(&openHevcContexts->async_out[--openHevcContexts->nb_async_out]);
+    openHevcContexts->async_eof = 0;
+}
+
+static void async_resume(OpenHevcWrapperContexts *openHevcContexts)
+{
+    pthread_cond_signal(&openHevcContexts->async_cond);
+    pthread_mutex_unlock(&openHevcContexts->async_mutex);
+}
+
+static void async_stop(OpenHevcWrapperContexts *openHevcContexts)
+{
+    async_pause(openHevcContexts);
+    openHevcContexts->async_abort = 1;
+    async_resume(openHevcContexts);
+    pthread_join(openHevcContexts->async_thread, NULL);
+
+    pthread_cond_destroy(&openHevcContexts->async_idle_cond);
+    pthread_cond_destroy(&openHevcContexts->async_cond);
+    pthread_mutex_destroy(&openHevcContexts->async_mutex);
+    av_freep(&openHevcContexts->async_in);
+    av_freep(&openHevcContexts->async_out);
+    av_frame_free(&openHevcContexts->async_frame);
+    openHevcContexts->async_depth = 0;
+}
+
+static AVFrame *output_picture(OpenHevcWrapperContexts *openHevcContexts)
+{
+    if (openHevcContexts->async_depth)
+        return openHevcContexts->async_frame;
+    return openHevcContexts->wraper[openHevcContexts->display_layer]->picture;
+}
+
 void libOpenHevcCopyExtraData(OpenHevc_Handle openHevcHandle, unsigned char *extra_data, int extra_size_alloc)
 {
     int i;
@@ -165,6 +665,12 @@ void libOpenHevcCopyExtraData(OpenHevc_Handle openHevcHandle, unsigned char *ext
         memcpy( openHevcContext->c->extradata, extra_data, extra_size_alloc);
         openHevcContext->c->extradata_size = extra_size_alloc;
 	}
+    /* same test as the decoder: hvcC extradata means length-prefixed NAL
+     * units, with their length size in lengthSizeMinusOne */
+    if (extra_size_alloc > 21 && (extra_data[0] || extra_data[1] || extra_data[2] > 1))
+        openHevcContexts->nal_length_size = (extra_data[21] & 3) + 1;
+    else
+        openHevcContexts->nal_length_size = 0;
 }
 
 
@@ -172,7 +678,7 @@ void libOpenHevcGetPictureInfo(OpenHevc_Handle openHevcHandle, OpenHevc_FrameInf
 {
     OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
     OpenHevcWrapperContext  *openHevcContext  = openHevcContexts->wraper[openHevcContexts->display_layer];
-    AVFrame                 *picture          = openHevcContext->picture;
+    AVFrame                 *picture          = output_picture(openHevcContexts);
 
     openHevcFrameInfo->nYPitch    = picture->linesize[0];
 
@@ -247,7 +753,7 @@ void libOpenHevcGetPictureInfoCpy(OpenHevc_Handle openHevcHandle, OpenHevc_Frame
 
     OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
     OpenHevcWrapperContext  *openHevcContext  = openHevcContexts->wraper[openHevcContexts->display_layer];
-    AVFrame                 *picture          = openHevcContext->picture;
+    AVFrame                 *picture          = output_picture(openHevcContexts);
 
     switch (picture->format) {
         case PIX_FMT_YUV420P   :
@@ -324,6 +830,17 @@ void libOpenHevcGetPictureInfoCpy(OpenHevc_Handle openHevcHandle, OpenHevc_Frame
         default               : openHevcFrameInfo->nBitDepth   =  8; break;
     }
 
+    if (openHevcContexts->output_format & OPENHEVC_OUTPUT_8BIT && openHevcFrameInfo->nBitDepth > 8) {
+        openHevcFrameInfo->nYPitch  >>= 1;
+        openHevcFrameInfo->nUPitch  >>= 1;
+        openHevcFrameInfo->nVPitch  >>= 1;
+        openHevcFrameInfo->nBitDepth  = 8;
+    }
+    if (openHevcContexts->output_format & OPENHEVC_OUTPUT_SEMIPLANAR) {
+        openHevcFrameInfo->nUPitch <<= 1;
+        openHevcFrameInfo->nVPitch   = 0;
+    }
+
     openHevcFrameInfo->nWidth                  = picture->width;
     openHevcFrameInfo->nHeight                 = picture->height;
     openHevcFrameInfo->sample_aspect_ratio.num = picture->sample_aspect_ratio.num;
@@ -338,22 +855,260 @@ void libOpenHevcGetPictureInfoCpy(OpenHevc_Handle openHevcHandle, OpenHevc_Frame
 int libOpenHevcGetOutput(OpenHevc_Handle openHevcHandle, int got_picture, OpenHevc_Frame *openHevcFrame)
 {
     OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
-    OpenHevcWrapperContext  *openHevcContext  = openHevcContexts->wraper[openHevcContexts->display_layer];
+    AVFrame                 *picture          = output_picture(openHevcContexts);
 
     if (got_picture) {
-        openHevcFrame->pvY       = (void *) openHevcContext->picture->data[0];
-        openHevcFrame->pvU       = (void *) openHevcContext->picture->data[1];
-        openHevcFrame->pvV       = (void *) openHevcContext->picture->data[2];
+        openHevcFrame->pvY       = (void *) picture->data[0];
+        openHevcFrame->pvU       = (void *) picture->data[1];
+        openHevcFrame->pvV       = (void *) picture->data[2];
 
         libOpenHevcGetPictureInfo(openHevcHandle, &openHevcFrame->frameInfo);
     }
     return 1;
 }
 
+/* Output conversion, one row per call. shift moves the samples to the high
+ * bits of 16 bit output or down to 8 bits, the latter after adding the row
+ * of the ordered dither. */
+typedef void (*CopyRowFunc)(uint8_t *dst, const uint8_t *src, int width,
+                            int shift, const uint16_t *dither);
+typedef void (*InterleaveRowFunc)(uint8_t *dst, const uint8_t *u, const uint8_t *v,
+                                  int width, int shift, const uint16_t *dither);
+
+static const uint8_t dither_8x8[8][8] = {
+    {  0, 32,  8, 40,  2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44,  4, 36, 14, 46,  6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    {  3, 35, 11, 43,  1, 33,  9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47,  7, 39, 13, 45,  5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 },
+};
+
+static void copy_row_shl_c(uint8_t *_dst, const uint8_t *_src, int width,
+                           int shift, const uint16_t *dither)
+{
+    uint16_t *dst       = (uint16_t *) _dst;
+    const uint16_t *src = (const uint16_t *) _src;
+    int x;
+
+    for (x = 0; x < width; x++)
+        dst[x] = src[x] << shift;
+}
+
+static void copy_row_dither_c(uint8_t *dst, const uint8_t *_src, int width,
+                              int shift, const uint16_t *dither)
+{
+    const uint16_t *src = (const uint16_t *) _src;
+    int x;
+
+    for (x = 0; x < width; x++)
+        dst[x] = av_clip_uint8((src[x] + dither[x & 7]) >> shift);
+}
+
+static void interleave_row_8_c(uint8_t *dst, const uint8_t *u, const uint8_t *v,
+                               int width, int shift, const uint16_t *dither)
+{
+    int x;
+
+    for (x = 0; x < width; x++) {
+        dst[2 * x]     = u[x];
+        dst[2 * x + 1] = v[x];
+    }
+}
+
+static void interleave_row_shl_c(uint8_t *_dst, const uint8_t *_u, const uint8_t *_v,
+                                 int width, int shift, const uint16_t *dither)
+{
+    uint16_t *dst     = (uint16_t *) _dst;
+    const uint16_t *u = (const uint16_t *) _u;
+    const uint16_t *v = (const uint16_t *) _v;
+    int x;
+
+    for (x = 0; x < width; x++) {
+        dst[2 * x]     = u[x] << shift;
+        dst[2 * x + 1] = v[x] << shift;
+    }
+}
+
+static void interleave_row_dither_c(uint8_t *dst, const uint8_t *_u, const uint8_t *_v,
+                                    int width, int shift, const uint16_t *dither)
+{
+    const uint16_t *u = (const uint16_t *) _u;
+    const uint16_t *v = (const uint16_t *) _v;
+    int x;
+
+    for (x = 0; x < width; x++) {
+        dst[2 * x]     = av_clip_uint8((u[x] + dither[x & 7]) >> shift);
+        dst[2 * x + 1] = av_clip_uint8((v[x] + dither[x & 7]) >> shift);
+    }
+}
+
+#if HAVE_SSE2
+/* The C versions finish the rows, the vector loops stop at a multiple of 8
+ * samples so that the dither stays in phase. */
+static void copy_row_shl_sse2(uint8_t *_dst, const uint8_t *_src, int width,
+                              int shift, const uint16_t *dither)
+{
+    uint16_t *dst       = (uint16_t *) _dst;
+    const uint16_t *src = (const uint16_t *) _src;
+    const __m128i s     = _mm_cvtsi32_si128(shift);
+    int x;
+
+    for (x = 0; x + 8 <= width; x += 8)
+        _mm_storeu_si128((__m128i *) &dst[x],
+                         _mm_sll_epi16(_mm_loadu_si128((const __m128i *) &src[x]), s));
+    copy_row_shl_c((uint8_t *) &dst[x], (const uint8_t *) &src[x], width - x, shift, dither);
+}
+
+static void copy_row_dither_sse2(uint8_t *dst, const uint8_t *_src, int width,
+                                 int shift, const uint16_t *dither)
+{
+    const uint16_t *src = (const uint16_t *) _src;
+    const __m128i d     = _mm_load_si128((const __m128i *) dither);
+    const __m128i s     = _mm_cvtsi32_si128(shift);
+    int x;
+
+    for (x = 0; x + 16 <= width; x += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *) &src[x]);
+        __m128i b = _mm_loadu_si128((const __m128i *) &src[x + 8]);
+        a = _mm_srl_epi16(_mm_add_epi16(a, d), s);
+        b = _mm_srl_epi16(_mm_add_epi16(b, d), s);
+        _mm_storeu_si128((__m128i *) &dst[x], _mm_packus_epi16(a, b));
+    }
+    copy_row_dither_c(&dst[x], (const uint8_t *) &src[x], width - x, shift, dither);
+}
+
+static void interleave_row_8_sse2(uint8_t *dst, const uint8_t *u, const uint8_t *v,
+                                  int width, int shift, const uint16_t *dither)
+{
+    int x;
+
+    for (x = 0; x + 16 <= width; x += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *) &u[x]);
+        __m128i b = _mm_loadu_si128((const __m128i *) &v[x]);
+        _mm_storeu_si128((__m128i *) &dst[2 * x],      _mm_unpacklo_epi8(a, b));
+        _mm_storeu_si128((__m128i *) &dst[2 * x + 16], _mm_unpackhi_epi8(a, b));
+    }
+    interleave_row_8_c(&dst[2 * x], &u[x], &v[x], width - x, shift, dither);
+}
+
+static void interleave_row_shl_sse2(uint8_t *_dst, const uint8_t *_u, const uint8_t *_v,
+                                    int width, int shift, const uint16_t *dither)
+{
+    uint16_t *dst     = (uint16_t *) _dst;
+    const uint16_t *u = (const uint16_t *) _u;
+    const uint16_t *v = (const uint16_t *) _v;
+    const __m128i s   = _mm_cvtsi32_si128(shift);
+    int x;
+
+    for (x = 0; x + 8 <= width; x += 8) {
+        __m128i a = _mm_sll_epi16(_mm_loadu_si128((const __m128i *) &u[x]), s);
+        __m128i b = _mm_sll_epi16(_mm_loadu_si128((const __m128i *) &v[x]), s);
+        _mm_storeu_si128((__m128i *) &dst[2 * x],     _mm_unpacklo_epi16(a, b));
+        _mm_storeu_si128((__m128i *) &dst[2 * x + 8], _mm_unpackhi_epi16(a, b));
+    }
+    interleave_row_shl_c((uint8_t *) &dst[2 * x], (const uint8_t *) &u[x],
+                         (const uint8_t *) &v[x], width - x, shift, dither);
+}
+
+static void interleave_row_dither_sse2(uint8_t *dst, const uint8_t *_u, const uint8_t *_v,
+                                       int width, int shift, const uint16_t *dither)
+{
+    const uint16_t *u = (const uint16_t *) _u;
+    const uint16_t *v = (const uint16_t *) _v;
+    const __m128i d   = _mm_load_si128((const __m128i *) dither);
+    const __m128i s   = _mm_cvtsi32_si128(shift);
+    int x;
+
+    for (x = 0; x + 8 <= width; x += 8) {
+        __m128i a = _mm_srl_epi16(_mm_add_epi16(_mm_loadu_si128((const __m128i *) &u[x]), d), s);
+        __m128i b = _mm_srl_epi16(_mm_add_epi16(_mm_loadu_si128((const __m128i *) &v[x]), d), s);
+        a = _mm_packus_epi16(a, a);
+        b = _mm_packus_epi16(b, b);
+        _mm_storeu_si128((__m128i *) &dst[2 * x], _mm_unpacklo_epi8(a, b));
+    }
+    interleave_row_dither_c(&dst[2 * x], (const uint8_t *) &u[x], (const uint8_t *) &v[x],
+                            width - x, shift, dither);
+}
+#endif
+
+static void set_dither_row(uint16_t *dither, int y, int shift)
+{
+    int x;
+
+    for (x = 0; x < 8; x++)
+        dither[x] = dither_8x8[y & 7][x] >> (6 - shift);
+}
+
+/* Crop and convert in a single pass over the picture, openHevcFrame->frameInfo
+ * already holds the output layout */
+static void convert_output(OpenHevcWrapperContexts *openHevcContexts, const AVFrame *picture,
+                           OpenHevc_Frame_cpy *openHevcFrame, int depth, int height_c)
+{
+    const OpenHevc_FrameInfo *info = &openHevcFrame->frameInfo;
+    const int to_8bit     = depth > 8 && (openHevcContexts->output_format & OPENHEVC_OUTPUT_8BIT);
+    const int semi_planar = openHevcContexts->output_format & OPENHEVC_OUTPUT_SEMIPLANAR;
+    const int width       = info->nWidth;
+    const int width_c     = info->chromat_format == YUV444 ? width : width >> 1;
+    const int shift       = to_8bit ? depth - 8 : 16 - depth;
+    uint8_t *Y = (uint8_t *) openHevcFrame->pvY;
+    uint8_t *U = (uint8_t *) openHevcFrame->pvU;
+    uint8_t *V = (uint8_t *) openHevcFrame->pvV;
+    CopyRowFunc       copy_row       = NULL;
+    InterleaveRowFunc interleave_row = interleave_row_8_c;
+    DECLARE_ALIGNED(16, uint16_t, dither)[8];
+    int y;
+
+    if (depth > 8) {
+        copy_row       = to_8bit ? copy_row_dither_c       : copy_row_shl_c;
+        interleave_row = to_8bit ? interleave_row_dither_c : interleave_row_shl_c;
+    }
+#if HAVE_SSE2
+    if (av_get_cpu_flags() & AV_CPU_FLAG_SSE2) {
+        interleave_row = interleave_row_8_sse2;
+        if (depth > 8) {
+            copy_row       = to_8bit ? copy_row_dither_sse2       : copy_row_shl_sse2;
+            interleave_row = to_8bit ? interleave_row_dither_sse2 : interleave_row_shl_sse2;
+        }
+    }
+#endif
+
+    for (y = 0; y < info->nHeight; y++) {
+        const uint8_t *src = picture->data[0] + y * picture->linesize[0];
+        uint8_t *dst       = Y + y * info->nYPitch;
+
+        if (!copy_row) {
+            memcpy(dst, src, info->nYPitch);
+            continue;
+        }
+        if (to_8bit)
+            set_dither_row(dither, y, shift);
+        copy_row(dst, src, width, shift, dither);
+    }
+    for (y = 0; y < height_c; y++) {
+        const uint8_t *src_u = picture->data[1] + y * picture->linesize[1];
+        const uint8_t *src_v = picture->data[2] + y * picture->linesize[2];
+
+        if (to_8bit)
+            set_dither_row(dither, y, shift);
+        if (semi_planar) {
+            interleave_row(U + y * info->nUPitch, src_u, src_v, width_c, shift, dither);
+        } else if (copy_row) {
+            copy_row(U + y * info->nUPitch, src_u, width_c, shift, dither);
+            copy_row(V + y * info->nVPitch, src_v, width_c, shift, dither);
+        } else {
+            memcpy(U + y * info->nUPitch, src_u, info->nUPitch);
+            memcpy(V + y * info->nVPitch, src_v, info->nVPitch);
+        }
+    }
+}
+
 int libOpenHevcGetOutputCpy(OpenHevc_Handle openHevcHandle, int got_picture, OpenHevc_Frame_cpy *openHevcFrame)
 {
     OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
-    OpenHevcWrapperContext  *openHevcContext  = openHevcContexts->wraper[openHevcContexts->display_layer];
+    AVFrame                 *picture          = output_picture(openHevcContexts);
 
     int y;
     int y_offset, y_offset2;
@@ -361,7 +1116,7 @@ int libOpenHevcGetOutputCpy(OpenHevc_Handle openHevcHandle, int got_picture, Ope
         unsigned char *Y = (unsigned char *) openHevcFrame->pvY;
         unsigned char *U = (unsigned char *) openHevcFrame->pvU;
         unsigned char *V = (unsigned char *) openHevcFrame->pvV;
-        int height, format;
+        int height, format, depth;
         int src_stride;
         int dst_stride;
         int src_stride_c;
@@ -372,15 +1127,20 @@ int libOpenHevcGetOutputCpy(OpenHevc_Handle openHevcHandle, int got_picture, Ope
         src_stride = openHevcFrame->frameInfo.nYPitch;
         src_stride_c = openHevcFrame->frameInfo.nUPitch;
         height = openHevcFrame->frameInfo.nHeight;
+        depth  = openHevcFrame->frameInfo.nBitDepth;
 
         libOpenHevcGetPictureInfoCpy(openHevcHandle, &openHevcFrame->frameInfo);
+        if (openHevcContexts->output_format != OPENHEVC_OUTPUT_PLANAR) {
+            convert_output(openHevcContexts, picture, openHevcFrame, depth, height >> format);
+            return 1;
+        }
         dst_stride = openHevcFrame->frameInfo.nYPitch;
         dst_stride_c = openHevcFrame->frameInfo.nUPitch;
 
         y_offset = y_offset2 = 0;
 
         for (y = 0; y < height; y++) {
-            memcpy(&Y[y_offset2], &openHevcContext->picture->data[0][y_offset], dst_stride);
+            memcpy(&Y[y_offset2], &picture->data[0][y_offset], dst_stride);
             y_offset  += src_stride;
             y_offset2 += dst_stride;
         }
@@ -388,8 +1148,8 @@ int libOpenHevcGetOutputCpy(OpenHevc_Handle openHevcHandle, int got_picture, Ope
         y_offset = y_offset2 = 0;
 
         for (y = 0; y < height >> format; y++) {
-            memcpy(&U[y_offset2], &openHevcContext->picture->data[1][y_offset], dst_stride_c);
-            memcpy(&V[y_offset2], &openHevcContext->picture->data[2][y_offset], dst_stride_c);
+            memcpy(&U[y_offset2], &picture->data[1][y_offset], dst_stride_c);
+            memcpy(&V[y_offset2], &picture->data[2][y_offset], dst_stride_c);
             y_offset  += src_stride_c;
             y_offset2 += dst_stride_c;
         }
@@ -405,6 +1165,7 @@ void libOpenHevcSetDebugMode(OpenHevc_Handle openHevcHandle, int val)
 void libOpenHevcSetActiveDecoders(OpenHevc_Handle openHevcHandle, int val)
 {
     OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
+    openHevcContexts->target_layer = -1;
     if (val >= 0 && val < openHevcContexts->nb_decoders)
         openHevcContexts->active_layer = val;
     else {
@@ -426,6 +1187,23 @@ void libOpenHevcSetViewLayers(OpenHevc_Handle openHevcHandle, int val)
 }
 
 
+void libOpenHevcSwitchLayer(OpenHevc_Handle openHevcHandle, int val)
+{
+    OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
+
+    if (val < 0 || val >= openHevcContexts->nb_decoders) {
+        fprintf(stderr, "The requested layer %d can not be decoded (it exceeds the number of allocated decoders %d ) \n", val, openHevcContexts->nb_decoders);
+        return;
+    }
+    /* queued packets are left alone: the switch happens on the next one the
+     * decoding thread takes */
+    if (openHevcContexts->async_depth)
+        async_wait_idle(openHevcContexts);
+    openHevcContexts->target_layer = val == openHevcContexts->active_layer ? -1 : val;
+    if (openHevcContexts->async_depth)
+        async_resume(openHevcContexts);
+}
+
 void libOpenHevcSetCheckMD5(OpenHevc_Handle openHevcHandle, int val)
 {
     OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
@@ -452,6 +1230,34 @@ void libOpenHevcSetTemporalLayer_id(OpenHevc_Handle openHevcHandle, int val)
     
 }
 
+static const enum AVDiscard skip_mode[] = {
+    [OPENHEVC_SKIP_NONE]   = AVDISCARD_DEFAULT,
+    [OPENHEVC_SKIP_NONREF] = AVDISCARD_NONREF,
+    [OPENHEVC_SKIP_NONKEY] = AVDISCARD_NONKEY,
+};
+
+void libOpenHevcSetSkipFrame(OpenHevc_Handle openHevcHandle, int mode)
+{
+    OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
+    int i;
+
+    if (mode < 0 || mode >= FF_ARRAY_ELEMS(skip_mode))
+        return;
+    for (i = 0; i < openHevcContexts->nb_decoders; i++)
+        openHevcContexts->wraper[i]->c->skip_frame = skip_mode[mode];
+}
+
+void libOpenHevcSetSkipLoopFilter(OpenHevc_Handle openHevcHandle, int mode)
+{
+    OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
+    int i;
+
+    if (mode < 0 || mode >= FF_ARRAY_ELEMS(skip_mode))
+        return;
+    for (i = 0; i < openHevcContexts->nb_decoders; i++)
+        openHevcContexts->wraper[i]->c->skip_loop_filter = skip_mode[mode];
+}
+
 void libOpenHevcSetNoCropping(OpenHevc_Handle openHevcHandle, int val)
 {
     OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
@@ -464,20 +1270,32 @@ void libOpenHevcSetNoCropping(OpenHevc_Handle openHevcHandle, int val)
     }
 }
 
+void libOpenHevcSetOutputFormat(OpenHevc_Handle openHevcHandle, int format)
+{
+    OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
+
+    openHevcContexts->output_format = format & (OPENHEVC_OUTPUT_SEMIPLANAR | OPENHEVC_OUTPUT_8BIT);
+}
+
 void libOpenHevcClose(OpenHevc_Handle openHevcHandle)
 {
     OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
     OpenHevcWrapperContext  *openHevcContext;
     int i;
 
+    if (openHevcContexts->async_depth)
+        async_stop(openHevcContexts);
     for (i = 0; i < openHevcContexts->nb_decoders; i++){
         openHevcContext = openHevcContexts->wraper[i];
         avcodec_close(openHevcContext->c);
         av_parser_close(openHevcContext->parser);
+        av_packet_free_side_data(&openHevcContext->avpkt);
         av_freep(&openHevcContext->c);
         av_freep(&openHevcContext->picture);
         av_freep(&openHevcContext);
     }
+    drop_queue(openHevcContexts);
+    av_freep(&openHevcContexts->queue);
     av_freep(&openHevcContexts->wraper);
     av_freep(&openHevcContexts);
 }
@@ -498,6 +1316,72 @@ void libOpenHevcFlushSVC(OpenHevc_Handle openHevcHandle, int decoderId)
     openHevcContext->codec->flush(openHevcContext->c);
 }
 
+void libOpenHevcSeek(OpenHevc_Handle openHevcHandle, int64_t pts)
+{
+    OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
+    OpenHevcWrapperContext  *openHevcContext;
+    int i;
+
+    if (openHevcContexts->async_depth)
+        async_pause(openHevcContexts);
+    for (i = 0; i < openHevcContexts->nb_decoders; i++) {
+        openHevcContext = openHevcContexts->wraper[i];
+        avcodec_flush_buffers(openHevcContext->c);
+        openHevcContext->c->seek_pts = pts;
+    }
+    drop_queue(openHevcContexts);
+    if (openHevcContexts->async_depth)
+        async_resume(openHevcContexts);
+}
+
+void libOpenHevcPark(OpenHevc_Handle openHevcHandle)
+{
+    OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
+    OpenHevcWrapperContext  *openHevcContext;
+    int i;
+
+    if (openHevcContexts->async_depth)
+        async_pause(openHevcContexts);
+    for (i = 0; i < openHevcContexts->nb_decoders; i++) {
+        openHevcContext = openHevcContexts->wraper[i];
+        avcodec_flush_buffers(openHevcContext->c);
+        av_packet_free_side_data(&openHevcContext->avpkt);
+        openHevcContext->c->seek_pts = AV_NOPTS_VALUE;
+    }
+    drop_queue(openHevcContexts);
+    openHevcContexts->fed = 0;
+    if (openHevcContexts->async_depth)
+        async_resume(openHevcContexts);
+}
+
+int libOpenHevcRearm(OpenHevc_Handle openHevcHandle, const unsigned char *extra_data, int extra_size)
+{
+    OpenHevcWrapperContexts *openHevcContexts = (OpenHevcWrapperContexts *) openHevcHandle;
+    OpenHevcWrapperContext  *openHevcContext;
+    uint8_t *side_data;
+    int i, ret = 0;
+
+    if (!extra_data || extra_size <= 0)
+        return 0;
+
+    if (openHevcContexts->async_depth)
+        async_pause(openHevcContexts);
+    for (i = 0; i <= openHevcContexts->active_layer; i++) {
+        openHevcContext = openHevcContexts->wraper[i];
+        av_packet_free_side_data(&openHevcContext->avpkt);
+        side_data = av_packet_new_side_data(&openHevcContext->avpkt,
+                                            AV_PKT_DATA_NEW_EXTRADATA, extra_size);
+        if (!side_data) {
+            ret = -1;
+            break;
+        }
+        memcpy(side_data, extra_data, extra_size);
+    }
+    if (openHevcContexts->async_depth)
+        async_resume(openHevcContexts);
+    return ret;
+}
+
 const char *libOpenHevcVersion(OpenHevc_Handle openHevcHandle)
 {
     return "OpenHEVC v"NV_VERSION;
@@ -32,6 +32,9 @@ extern "C" {
 
 typedef void* OpenHevc_Handle;
 
+#define OPENHEVC_AGAIN (-2) ///< the packet queue is full, send the packet again later
+#define OPENHEVC_EOF   (-3) ///< all pictures have been received after the end of the stream
+
 typedef struct OpenHevc_Rational{
     int num; ///< numerator
     int den; ///< denominator
@@ -44,6 +47,26 @@ enum ChromaFormat {
     YUV444,
 };
 
+enum OpenHevc_ThreadType {
+    OPENHEVC_THREAD_FRAME      = 1,
+    OPENHEVC_THREAD_SLICE      = 2,
+    OPENHEVC_THREAD_FRAMESLICE = 4,
+    OPENHEVC_THREAD_AUTO       = 8, ///< plan from the stream structure, nb_pthreads cores per layer
+};
+
+/* Layout of the pictures written by libOpenHevcGetOutputCpy() */
+enum OpenHevc_OutputFormat {
+    OPENHEVC_OUTPUT_PLANAR     = 0, ///< I420, I010, ... as decoded
+    OPENHEVC_OUTPUT_SEMIPLANAR = 1, ///< NV12, or P010 with the samples in the high bits, U and V interleaved in pvU
+    OPENHEVC_OUTPUT_8BIT       = 2, ///< flag, pictures above 8 bits are dithered down to 8 bits
+};
+
+enum OpenHevc_SkipMode {
+    OPENHEVC_SKIP_NONE = 0,
+    OPENHEVC_SKIP_NONREF,   ///< pictures no other picture references
+    OPENHEVC_SKIP_NONKEY,   ///< all but IRAP pictures
+};
+
 typedef struct OpenHevc_FrameInfo
 {
    int         nYPitch;
@@ -89,11 +112,53 @@ void libOpenHevcSetCheckMD5(OpenHevc_Handle openHevcHandle, int val);
 void libOpenHevcSetDebugMode(OpenHevc_Handle openHevcHandle, int val);
 void libOpenHevcSetTemporalLayer_id(OpenHevc_Handle openHevcHandle, int val);
 void libOpenHevcSetNoCropping(OpenHevc_Handle openHevcHandle, int val);
+/* Convert to an OpenHevc_OutputFormat while libOpenHevcGetOutputCpy() crops,
+ * the pitches and bit depth from libOpenHevcGetPictureInfoCpy() follow */
+void libOpenHevcSetOutputFormat(OpenHevc_Handle openHevcHandle, int format);
 void libOpenHevcSetActiveDecoders(OpenHevc_Handle openHevcHandle, int val);
 void libOpenHevcSetViewLayers(OpenHevc_Handle openHevcHandle, int val);
+/* Move to layer val at the access unit level, without a flush of the layers
+ * kept: going down takes effect with the next packet, going up with the next
+ * one where the added layers start with an IRAP picture. The displayed
+ * layer follows. */
+void libOpenHevcSwitchLayer(OpenHevc_Handle openHevcHandle, int val);
+/* Drop pictures from their NAL unit header on, e.g. IRAP only for thumbnails */
+void libOpenHevcSetSkipFrame(OpenHevc_Handle openHevcHandle, int mode);
+/* Leave pictures without deblocking and SAO */
+void libOpenHevcSetSkipLoopFilter(OpenHevc_Handle openHevcHandle, int mode);
 void libOpenHevcClose(OpenHevc_Handle openHevcHandle);
 void libOpenHevcFlush(OpenHevc_Handle openHevcHandle);
 void libOpenHevcFlushSVC(OpenHevc_Handle openHevcHandle, int decoderId);
+/* Flush all layers and only output pictures from pts on. This only discards
+ * pictures, the input is not moved: the caller seeks its demuxer itself and
+ * then feeds packets from the IRAP at or before pts, e.g. after
+ * av_seek_frame() with AVSEEK_FLAG_BACKWARD. Pictures before pts that
+ * nothing references are skipped without being decoded. Once a picture at
+ * or after pts is output, all pictures are output again. */
+void libOpenHevcSeek(OpenHevc_Handle openHevcHandle, int64_t pts);
+/* Drop all pictures and stream state but keep the threads, picture pools
+ * and parameter sets, e.g. to keep a warm decoder around for a channel
+ * change instead of closing it. */
+void libOpenHevcPark(OpenHevc_Handle openHevcHandle);
+/* Prepare a parked decoder for a new stream, which is decoded from its
+ * first IRAP picture on. extra_data is the new stream's configuration,
+ * applied with the next packet, or NULL when it is carried in band. */
+int  libOpenHevcRearm(OpenHevc_Handle openHevcHandle, const unsigned char *extra_data, int extra_size);
+/* Decode on a thread of its own: libOpenHevcSendPacket() queues up to
+ * queue_depth packets and never waits for the decoder, pictures are taken
+ * with libOpenHevcReceiveFrame() and read with the usual getters. Layers and
+ * skip modes must be set before. */
+int  libOpenHevcStartAsync(OpenHevc_Handle openHevcHandle, int queue_depth);
+/* Queue a packet, or the end of the stream when buff is NULL. Returns
+ * OPENHEVC_AGAIN while the queue is full, -1 without libOpenHevcStartAsync(). */
+int  libOpenHevcSendPacket(OpenHevc_Handle openHevcHandle, const unsigned char *buff, int au_len, int64_t pts);
+/* Make the next decoded picture the output: 1 when there was one, 0 when
+ * none is ready yet, OPENHEVC_EOF after the last one, -1 without
+ * libOpenHevcStartAsync() */
+int  libOpenHevcReceiveFrame(OpenHevc_Handle openHevcHandle);
+/* Called from the decoding thread each time a picture is ready, e.g. to
+ * signal an eventfd the caller polls */
+void libOpenHevcSetFrameCallback(OpenHevc_Handle openHevcHandle, void (*callback)(void *opaque), void *opaque);
 
 const char *libOpenHevcVersion(OpenHevc_Handle openHevcHandle);
 
@@ -218,6 +218,7 @@ static GF_Err HEVC_AttachStream(GF_BaseDecoder *ifcg, GF_ESD *esd)
 	sOpt = gf_modules_get_option((GF_BaseInterface *)ifcg, "OpenHEVC", "ThreadingType");
 	if (sOpt && !strcmp(sOpt, "wpp")) ctx->threading_type = 2;
 	else if (sOpt && !strcmp(sOpt, "frame+wpp")) ctx->threading_type = 4;
+	else if (sOpt && !strcmp(sOpt, "auto")) ctx->threading_type = OPENHEVC_THREAD_AUTO;
 	else {
 		ctx->threading_type = 1;
 		if (!sOpt) gf_modules_set_option((GF_BaseInterface *)ifcg, "OpenHEVC", "ThreadingType", "frame");
@@ -342,14 +343,8 @@ static GF_Err HEVC_SetCapabilities(GF_BaseDecoder *ifcg, GF_CodecCapability capa
 			libOpenHevcFlush(ctx->openHevcHandle);
 		return GF_OK;
 	case GF_CODEC_MEDIA_SWITCH_QUALITY:
-		/*switch up*/
-		if (capability.cap.valueInt > 0) {
-			libOpenHevcSetViewLayers(ctx->openHevcHandle, 1);
-			libOpenHevcSetActiveDecoders(ctx->openHevcHandle, 1);
-		} else {
-			libOpenHevcSetViewLayers(ctx->openHevcHandle, 0);
-			libOpenHevcSetActiveDecoders(ctx->openHevcHandle, 0);
-		}
+		/*switch up at the next enhancement layer IRAP, down at the next AU - the base layer is never flushed*/
+		libOpenHevcSwitchLayer(ctx->openHevcHandle, capability.cap.valueInt > 0 ? 1 : 0);
 		return GF_OK;
 	case GF_CODEC_DIRECT_OUTPUT:
 		ctx->direct_output = GF_TRUE;
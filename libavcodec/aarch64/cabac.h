@@ -0,0 +1,52 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVCODEC_AARCH64_CABAC_H
+#define AVCODEC_AARCH64_CABAC_H
+
+#include "config.h"
+#if HAVE_INLINE_ASM
+
+#include "libavutil/attributes.h"
+
+#define get_cabac_bypass_run get_cabac_bypass_run_aarch64
+static av_always_inline unsigned get_cabac_bypass_run_aarch64(int *low, int range,
+                                                              int k, unsigned val)
+{
+    int l = *low, tmp;
+
+    /* low stays below 2 * range, so the unsigned compare is the C one */
+    __asm__ (
+        "1:                                                     \n\t"
+        "add        %w[low]       , %w[low]     , %w[low]       \n\t"
+        "subs       %w[tmp]       , %w[low]     , %w[range]     \n\t"
+        "csel       %w[low]       , %w[tmp]     , %w[low]       , hs \n\t"
+        "adc        %w[val]       , %w[val]     , %w[val]       \n\t"
+        "subs       %w[k]         , %w[k]       , #1            \n\t"
+        "b.ne       1b                                          \n\t"
+        : [low]"+&r"(l), [val]"+&r"(val), [tmp]"=&r"(tmp), [k]"+&r"(k)
+        : [range]"r"(range)
+        : "cc"
+    );
+    *low = l;
+    return val;
+}
+
+#endif /* HAVE_INLINE_ASM */
+
+#endif /* AVCODEC_AARCH64_CABAC_H */
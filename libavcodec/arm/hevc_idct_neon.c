@@ -0,0 +1,364 @@
+/*
+ * HEVC inverse transforms, NEON intrinsics
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <arm_neon.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/common.h"
+#include "libavutil/intreadwrite.h"
+#include "libavcodec/arm/hevcdsp_neon.h"
+
+/*
+ * Both passes transform 4 columns at a time, one int16x4_t per row, and
+ * store the result transposed: running the same column transform twice
+ * gives the columns then the rows of the C version. The rounding shift and
+ * the int16 saturation of each pass are a single vqrshrn. Only the shift of
+ * the second pass, 20 - bit depth, and the DC and residual add functions
+ * depend on the bit depth.
+ */
+
+/* odd rows of the 8, 16 and 32 point transforms, transform[4 * j],
+ * transform[2 * j] and transform[j] for odd j in hevcdsp.c */
+static const int16_t tr8_odd[4][4] = {
+    {  89,  75,  50,  18 },
+    {  75, -18, -89, -50 },
+    {  50, -89,  18,  75 },
+    {  18, -50,  75, -89 },
+};
+
+static const int16_t tr16_odd[8][8] = {
+    {  90,  87,  80,  70,  57,  43,  25,   9 },
+    {  87,  57,   9, -43, -80, -90, -70, -25 },
+    {  80,   9, -70, -87, -25,  57,  90,  43 },
+    {  70, -43, -87,   9,  90,  25, -80, -57 },
+    {  57, -80, -25,  90,  -9, -87,  43,  70 },
+    {  43, -90,  57,  25, -87,  70,   9, -80 },
+    {  25, -70,  90, -80,  43,   9, -57,  87 },
+    {   9, -25,  43, -57,  70, -80,  87, -90 },
+};
+
+static const int16_t tr32_odd[16][16] = {
+    {  90,  90,  88,  85,  82,  78,  73,  67,  61,  54,  46,  38,  31,  22,  13,   4 },
+    {  90,  82,  67,  46,  22,  -4, -31, -54, -73, -85, -90, -88, -78, -61, -38, -13 },
+    {  88,  67,  31, -13, -54, -82, -90, -78, -46,  -4,  38,  73,  90,  85,  61,  22 },
+    {  85,  46, -13, -67, -90, -73, -22,  38,  82,  88,  54,  -4, -61, -90, -78, -31 },
+    {  82,  22, -54, -90, -61,  13,  78,  85,  31, -46, -90, -67,   4,  73,  88,  38 },
+    {  78,  -4, -82, -73,  13,  85,  67, -22, -88, -61,  31,  90,  54, -38, -90, -46 },
+    {  73, -31, -90, -22,  78,  67, -38, -90, -13,  82,  61, -46, -88,  -4,  85,  54 },
+    {  67, -54, -78,  38,  85, -22, -90,   4,  90,  13, -88, -31,  82,  46, -73, -61 },
+    {  61, -73, -46,  82,  31, -88, -13,  90,  -4, -90,  22,  85, -38, -78,  54,  67 },
+    {  54, -85,  -4,  88, -46, -61,  82,  13, -90,  38,  67, -78, -22,  90, -31, -73 },
+    {  46, -90,  38,  54, -90,  31,  61, -88,  22,  67, -85,  13,  73, -82,   4,  78 },
+    {  38, -88,  73,  -4, -67,  90, -46, -31,  85, -78,  13,  61, -90,  54,  22, -82 },
+    {  31, -78,  90, -61,   4,  54, -88,  82, -38, -22,  73, -90,  67, -13, -46,  85 },
+    {  22, -61,  85, -90,  73, -38,  -4,  46, -78,  90, -82,  54, -13, -31,  67, -88 },
+    {  13, -38,  61, -78,  88, -90,  85, -73,  54, -31,   4,  22, -46,  67, -82,  90 },
+    {   4, -13,  22, -31,  38, -46,  54, -61,  67, -73,  78, -82,  85, -88,  90, -90 },
+};
+
+/* Only the first limit rows of src can be non zero, the odd parts stop
+ * there. Rows are step apart as the even part of a transform is the half
+ * size transform of the even rows. */
+static av_always_inline void tr_4(int32x4_t *dst, const int16x4_t *src,
+                                  int step, int limit)
+{
+    int32x4_t e0 = vmull_n_s16(src[0], 64);
+    int32x4_t e1 = e0;
+    int32x4_t o0 = vmull_n_s16(src[step], 83);
+    int32x4_t o1 = vmull_n_s16(src[step], 36);
+
+    e0 = vmlal_n_s16(e0, src[2 * step], 64);
+    e1 = vmlsl_n_s16(e1, src[2 * step], 64);
+    o0 = vmlal_n_s16(o0, src[3 * step], 36);
+    o1 = vmlsl_n_s16(o1, src[3 * step], 83);
+
+    dst[0] = vaddq_s32(e0, o0);
+    dst[1] = vaddq_s32(e1, o1);
+    dst[2] = vsubq_s32(e1, o1);
+    dst[3] = vsubq_s32(e0, o0);
+}
+
+#define TR_N(N, half, odd)                                                     \
+static av_always_inline void tr_ ## N(int32x4_t *dst, const int16x4_t *src,  \
+                                      int step, int limit)                   \
+{                                                                            \
+    int32x4_t e[half], o[half];                                              \
+    int i, j;                                                                \
+                                                                             \
+    tr_ ## half(e, src, 2 * step, (limit + 1) >> 1);                         \
+    for (i = 0; i < half; i++)                                               \
+        o[i] = vmull_n_s16(src[step], odd[0][i]);                            \
+    for (j = 1; 2 * j + 1 < limit; j++)                                      \
+        for (i = 0; i < half; i++)                                           \
+            o[i] = vmlal_n_s16(o[i], src[(2 * j + 1) * step], odd[j][i]);    \
+    for (i = 0; i < half; i++) {                                             \
+        dst[i]         = vaddq_s32(e[i], o[i]);                              \
+        dst[N - 1 - i] = vsubq_s32(e[i], o[i]);                              \
+    }                                                                        \
+}
+
+TR_N( 8,  4, tr8_odd)
+TR_N(16,  8, tr16_odd)
+TR_N(32, 16, tr32_odd)
+
+static av_always_inline void tr_4_luma(int32x4_t *dst, const int16x4_t *src,
+                                       int step, int limit)
+{
+    int32x4_t s0 = vmovl_s16(src[0]);
+    int32x4_t s1 = vmovl_s16(src[step]);
+    int32x4_t s2 = vmovl_s16(src[2 * step]);
+    int32x4_t s3 = vmovl_s16(src[3 * step]);
+    int32x4_t c0 = vaddq_s32(s0, s2);
+    int32x4_t c1 = vaddq_s32(s2, s3);
+    int32x4_t c2 = vsubq_s32(s0, s3);
+    int32x4_t c3 = vmulq_n_s32(s1, 74);
+
+    dst[0] = vaddq_s32(vmlaq_n_s32(vmulq_n_s32(c0, 29), c1, 55), c3);
+    dst[1] = vaddq_s32(vmlsq_n_s32(vmulq_n_s32(c2, 55), c1, 29), c3);
+    dst[2] = vmulq_n_s32(vaddq_s32(vsubq_s32(s0, s2), s3), 74);
+    dst[3] = vsubq_s32(vmlaq_n_s32(vmulq_n_s32(c0, 55), c2, 29), c3);
+}
+
+/* stores the transpose of the 4x4 block of rows r0..r3 */
+static av_always_inline void store_transposed_4x4(int16_t *dst, ptrdiff_t stride,
+                                                  int16x4_t r0, int16x4_t r1,
+                                                  int16x4_t r2, int16x4_t r3)
+{
+    int16x4x2_t t01 = vtrn_s16(r0, r1);
+    int16x4x2_t t23 = vtrn_s16(r2, r3);
+    int32x2x2_t a   = vtrn_s32(vreinterpret_s32_s16(t01.val[0]),
+                               vreinterpret_s32_s16(t23.val[0]));
+    int32x2x2_t b   = vtrn_s32(vreinterpret_s32_s16(t01.val[1]),
+                               vreinterpret_s32_s16(t23.val[1]));
+
+    vst1_s16(dst,              vreinterpret_s16_s32(a.val[0]));
+    vst1_s16(dst +     stride, vreinterpret_s16_s32(b.val[0]));
+    vst1_s16(dst + 2 * stride, vreinterpret_s16_s32(a.val[1]));
+    vst1_s16(dst + 3 * stride, vreinterpret_s16_s32(b.val[1]));
+}
+
+#define IDCT_PASS(name, tr, H, shift)                                          \
+static void name(int16_t *dst, const int16_t *src, int limit)                \
+{                                                                            \
+    int16x4_t in[H];                                                         \
+    int32x4_t out[H];                                                        \
+    int i, j;                                                                \
+                                                                             \
+    for (i = 0; i < H; i += 4) {                                             \
+        for (j = 0; j < limit; j++)                                          \
+            in[j] = vld1_s16(src + j * H + i);                               \
+        for (; j < H; j++)                                                   \
+            in[j] = vdup_n_s16(0);                                           \
+        tr(out, in, 1, limit);                                               \
+        for (j = 0; j < H; j += 4)                                           \
+            store_transposed_4x4(dst + i * H + j, H,                         \
+                                 vqrshrn_n_s32(out[j    ], shift),           \
+                                 vqrshrn_n_s32(out[j + 1], shift),           \
+                                 vqrshrn_n_s32(out[j + 2], shift),           \
+                                 vqrshrn_n_s32(out[j + 3], shift));          \
+    }                                                                        \
+}
+
+IDCT_PASS(idct_4x4_luma_pass1,    tr_4_luma, 4,  7)
+IDCT_PASS(idct_4x4_luma_pass2_8,  tr_4_luma, 4, 12)
+IDCT_PASS(idct_4x4_luma_pass2_10, tr_4_luma, 4, 10)
+IDCT_PASS(idct_4x4_luma_pass2_12, tr_4_luma, 4,  8)
+
+#define IDCT_4X4_LUMA(depth)                                                   \
+void ff_hevc_transform_4x4_luma_neon_ ## depth(int16_t *coeffs)              \
+{                                                                            \
+    int16_t tmp[4 * 4];                                                      \
+                                                                             \
+    idct_4x4_luma_pass1(tmp, coeffs, 4);                                     \
+    idct_4x4_luma_pass2_ ## depth(coeffs, tmp, 4);                           \
+}
+
+IDCT_4X4_LUMA(8)
+IDCT_4X4_LUMA(10)
+IDCT_4X4_LUMA(12)
+
+#define IDCT_PASSES(H)                                                         \
+IDCT_PASS(idct_ ## H ## x ## H ## _pass1,    tr_ ## H, H,  7)                  \
+IDCT_PASS(idct_ ## H ## x ## H ## _pass2_8,  tr_ ## H, H, 12)                  \
+IDCT_PASS(idct_ ## H ## x ## H ## _pass2_10, tr_ ## H, H, 10)                  \
+IDCT_PASS(idct_ ## H ## x ## H ## _pass2_12, tr_ ## H, H,  8)
+
+IDCT_PASSES( 4)
+IDCT_PASSES( 8)
+IDCT_PASSES(16)
+IDCT_PASSES(32)
+
+/* the limits are the ones of the C version: the first pass covers the
+ * col_limit + 4 first rows, the second the col_limit first columns */
+#define IDCT(H, depth)                                                         \
+void ff_hevc_transform_ ## H ## x ## H ## _neon_ ## depth(int16_t *coeffs,   \
+                                                          int col_limit)     \
+{                                                                            \
+    int16_t tmp[H * H];                                                      \
+                                                                             \
+    idct_ ## H ## x ## H ## _pass1(tmp, coeffs, FFMIN(col_limit + 4, H));    \
+    idct_ ## H ## x ## H ## _pass2_ ## depth(coeffs, tmp, FFMIN(col_limit, H)); \
+}
+
+#define IDCT_DC(H, depth)                                                      \
+void ff_hevc_idct_ ## H ## x ## H ## _dc_neon_ ## depth(int16_t *coeffs)     \
+{                                                                            \
+    int shift    = 14 - depth;                                               \
+    int add      = 1 << (shift - 1);                                         \
+    int16x8_t dc = vdupq_n_s16((((coeffs[0] + 1) >> 1) + add) >> shift);    \
+    int i;                                                                   \
+                                                                             \
+    for (i = 0; i < H * H; i += 8)                                           \
+        vst1q_s16(coeffs + i, dc);                                           \
+}
+
+#define IDCT_FUNCS(depth)                                                      \
+IDCT( 4, depth)                                                              \
+IDCT( 8, depth)                                                              \
+IDCT(16, depth)                                                              \
+IDCT(32, depth)                                                              \
+IDCT_DC( 4, depth)                                                           \
+IDCT_DC( 8, depth)                                                           \
+IDCT_DC(16, depth)                                                           \
+IDCT_DC(32, depth)
+
+IDCT_FUNCS(8)
+IDCT_FUNCS(10)
+IDCT_FUNCS(12)
+
+///////////////////////////////////////////////////////////////////////////////
+//
+///////////////////////////////////////////////////////////////////////////////
+static av_always_inline uint8x8_t add_residual_8(uint8x8_t pix, int16x8_t res)
+{
+    return vqmovun_s16(vqaddq_s16(vreinterpretq_s16_u16(vmovl_u8(pix)), res));
+}
+
+void ff_hevc_transform_4x4_add_neon_8(uint8_t *dst, int16_t *coeffs,
+                                      ptrdiff_t stride)
+{
+    int y;
+
+    for (y = 0; y < 4; y += 2) {
+        uint32x2_t pix = vdup_n_u32(AV_RN32(dst));
+
+        pix = vset_lane_u32(AV_RN32(dst + stride), pix, 1);
+        pix = vreinterpret_u32_u8(add_residual_8(vreinterpret_u8_u32(pix),
+                                                 vld1q_s16(coeffs)));
+        AV_WN32(dst,          vget_lane_u32(pix, 0));
+        AV_WN32(dst + stride, vget_lane_u32(pix, 1));
+        dst    += 2 * stride;
+        coeffs += 8;
+    }
+}
+
+void ff_hevc_transform_8x8_add_neon_8(uint8_t *dst, int16_t *coeffs,
+                                      ptrdiff_t stride)
+{
+    int y;
+
+    for (y = 0; y < 8; y++) {
+        vst1_u8(dst, add_residual_8(vld1_u8(dst), vld1q_s16(coeffs)));
+        dst    += stride;
+        coeffs += 8;
+    }
+}
+
+#define TRANSFORM_ADD(H)                                                       \
+void ff_hevc_transform_ ## H ## x ## H ## _add_neon_8(uint8_t *dst,          \
+                                                      int16_t *coeffs,       \
+                                                      ptrdiff_t stride)      \
+{                                                                            \
+    int x, y;                                                                \
+                                                                             \
+    for (y = 0; y < H; y++) {                                                \
+        for (x = 0; x < H; x += 16) {                                        \
+            uint8x16_t pix = vld1q_u8(dst + x);                              \
+            uint8x8_t  lo  = add_residual_8(vget_low_u8(pix),                \
+                                            vld1q_s16(coeffs + x));          \
+            uint8x8_t  hi  = add_residual_8(vget_high_u8(pix),               \
+                                            vld1q_s16(coeffs + x + 8));      \
+            vst1q_u8(dst + x, vcombine_u8(lo, hi));                          \
+        }                                                                    \
+        dst    += stride;                                                    \
+        coeffs += H;                                                         \
+    }                                                                        \
+}
+
+TRANSFORM_ADD(16)
+TRANSFORM_ADD(32)
+
+/* above 8 bit the sum is clipped to the pixel range, saturating it first
+ * does not change the clipped result */
+static av_always_inline uint16x8_t add_residual_16(uint16x8_t pix, int16x8_t res,
+                                                   int depth)
+{
+    int16x8_t sum = vqaddq_s16(vreinterpretq_s16_u16(pix), res);
+
+    sum = vminq_s16(vmaxq_s16(sum, vdupq_n_s16(0)), vdupq_n_s16((1 << depth) - 1));
+    return vreinterpretq_u16_s16(sum);
+}
+
+#define TRANSFORM_ADD_4X4_16(depth)                                            \
+void ff_hevc_transform_4x4_add_neon_ ## depth(uint8_t *_dst, int16_t *coeffs, \
+                                              ptrdiff_t stride)              \
+{                                                                            \
+    uint16_t *dst = (uint16_t *)_dst;                                        \
+    int y;                                                                   \
+                                                                             \
+    stride /= sizeof(uint16_t);                                              \
+    for (y = 0; y < 4; y += 2) {                                             \
+        uint16x8_t pix = vcombine_u16(vld1_u16(dst), vld1_u16(dst + stride)); \
+                                                                             \
+        pix = add_residual_16(pix, vld1q_s16(coeffs), depth);                \
+        vst1_u16(dst,          vget_low_u16(pix));                           \
+        vst1_u16(dst + stride, vget_high_u16(pix));                          \
+        dst    += 2 * stride;                                                \
+        coeffs += 8;                                                         \
+    }                                                                        \
+}
+
+#define TRANSFORM_ADD_16(H, depth)                                             \
+void ff_hevc_transform_ ## H ## x ## H ## _add_neon_ ## depth(uint8_t *_dst, \
+                                                              int16_t *coeffs, \
+                                                              ptrdiff_t stride) \
+{                                                                            \
+    uint16_t *dst = (uint16_t *)_dst;                                        \
+    int x, y;                                                                \
+                                                                             \
+    stride /= sizeof(uint16_t);                                              \
+    for (y = 0; y < H; y++) {                                                \
+        for (x = 0; x < H; x += 8)                                           \
+            vst1q_u16(dst + x, add_residual_16(vld1q_u16(dst + x),           \
+                                               vld1q_s16(coeffs + x), depth)); \
+        dst    += stride;                                                    \
+        coeffs += H;                                                         \
+    }                                                                        \
+}
+
+#define TRANSFORM_ADD_FUNCS(depth)                                             \
+TRANSFORM_ADD_4X4_16(depth)                                                  \
+TRANSFORM_ADD_16( 8, depth)                                                  \
+TRANSFORM_ADD_16(16, depth)                                                  \
+TRANSFORM_ADD_16(32, depth)
+
+TRANSFORM_ADD_FUNCS(10)
+TRANSFORM_ADD_FUNCS(12)
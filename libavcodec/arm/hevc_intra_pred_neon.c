@@ -0,0 +1,524 @@
+/*
+ * HEVC intra prediction, NEON intrinsics
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <arm_neon.h>
+#include <string.h>
+
+#include "config.h"
+#include "libavutil/common.h"
+#include "libavutil/intreadwrite.h"
+#include "libavcodec/arm/hevcdsp_neon.h"
+
+#define POS(x, y) src[(x) + stride * (y)]
+
+static av_always_inline uint8x8_t load_4(const uint8_t *src)
+{
+    return vreinterpret_u8_u32(vdup_n_u32(AV_RN32(src)));
+}
+
+static av_always_inline void store_4(uint8_t *dst, uint8x8_t v)
+{
+    AV_WN32(dst, vget_lane_u32(vreinterpret_u32_u8(v), 0));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Planar
+///////////////////////////////////////////////////////////////////////////////
+/*
+ * Per column, the sum of the C version is
+ *     (x + 1) * top[size] + (size - 1) * top[x] + left[size] + size
+ *   + y * (left[size] - top[x]) + (size - 1 - x) * left[y]
+ * the first line being the start of an accumulator the second one is added
+ * to every row. It stays below 16352 so it is done in 16 bit; the 4x4 block
+ * runs the 8 lane code and only stores half of it.
+ */
+static av_always_inline void pred_planar(uint8_t *src, const uint8_t *top,
+                                         const uint8_t *left, ptrdiff_t stride,
+                                         int log2_size)
+{
+    static const uint8_t lane[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    int size = 1 << log2_size;
+    int16x8_t shift = vdupq_n_s16(-(log2_size + 1));
+    int x, y;
+
+    for (x = 0; x < size; x += 8) {
+        uint8x8_t  xs    = vadd_u8(vld1_u8(lane), vdup_n_u8(x));
+        uint8x8_t  t     = vld1_u8(top + x);
+        uint8x8_t  wl    = vsub_u8(vdup_n_u8(size - 1), xs);
+        uint16x8_t delta = vsubq_u16(vdupq_n_u16(left[size]), vmovl_u8(t));
+        uint16x8_t acc   = vmull_u8(vadd_u8(xs, vdup_n_u8(1)), vdup_n_u8(top[size]));
+
+        acc = vmlal_u8(acc, t, vdup_n_u8(size - 1));
+        acc = vaddq_u16(acc, vdupq_n_u16(left[size] + size));
+        for (y = 0; y < size; y++) {
+            uint16x8_t sum = vmlal_u8(acc, wl, vdup_n_u8(left[y]));
+            uint8x8_t  res = vmovn_u16(vshlq_u16(sum, shift));
+
+            if (size == 4)
+                store_4(&POS(x, y), res);
+            else
+                vst1_u8(&POS(x, y), res);
+            acc = vaddq_u16(acc, delta);
+        }
+    }
+}
+
+#define PRED_PLANAR(size)                                                      \
+void ff_hevc_pred_planar_ ## size ## _neon_8(uint8_t *src, const uint8_t *top, \
+                                             const uint8_t *left, ptrdiff_t stride) \
+{                                                                            \
+    pred_planar(src, top, left, stride, size + 2);                           \
+}
+
+PRED_PLANAR(0)
+PRED_PLANAR(1)
+PRED_PLANAR(2)
+PRED_PLANAR(3)
+
+#undef PRED_PLANAR
+
+///////////////////////////////////////////////////////////////////////////////
+// DC
+///////////////////////////////////////////////////////////////////////////////
+void ff_hevc_pred_dc_neon_8(uint8_t *src, const uint8_t *top, const uint8_t *left,
+                            ptrdiff_t stride, int log2_size, int c_idx)
+{
+    int size = 1 << log2_size;
+    uint16x8_t sum;
+    uint64x2_t sum64;
+    uint8x16_t dc_v;
+    int dc, x, y;
+
+    if (size == 4) {
+        uint32x2_t lt = vdup_n_u32(AV_RN32(left));
+        lt  = vset_lane_u32(AV_RN32(top), lt, 1);
+        sum = vmovl_u8(vreinterpret_u8_u32(lt));
+    } else {
+        sum = vdupq_n_u16(0);
+        for (x = 0; x < size; x += 8)
+            sum = vaddq_u16(sum, vaddl_u8(vld1_u8(left + x), vld1_u8(top + x)));
+    }
+    sum64 = vpaddlq_u32(vpaddlq_u16(sum));
+    dc    = (vgetq_lane_u64(sum64, 0) + vgetq_lane_u64(sum64, 1) + size) >> (log2_size + 1);
+    dc_v  = vdupq_n_u8(dc);
+
+    for (y = 0; y < size; y++) {
+        if (size == 4)
+            store_4(&POS(0, y), vget_low_u8(dc_v));
+        else if (size == 8)
+            vst1_u8(&POS(0, y), vget_low_u8(dc_v));
+        else
+            for (x = 0; x < size; x += 16)
+                vst1q_u8(&POS(x, y), dc_v);
+    }
+
+    if (c_idx == 0 && size < 32) {
+        uint16x8_t dc3 = vdupq_n_u16(3 * dc);
+
+        for (x = 0; x < size; x += 8) {
+            uint8x8_t res = vrshrn_n_u16(vaddw_u8(dc3, size == 4 ? load_4(top) :
+                                                       vld1_u8(top + x)), 2);
+            if (size == 4)
+                store_4(&POS(x, 0), res);
+            else
+                vst1_u8(&POS(x, 0), res);
+        }
+        POS(0, 0) = (left[0] + 2 * dc + top[0] + 2) >> 2;
+        for (y = 1; y < size; y++)
+            POS(0, y) = (left[y] + 3 * dc + 2) >> 2;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Angular
+///////////////////////////////////////////////////////////////////////////////
+/* rows of a vertical mode, the horizontal modes run it on the left samples
+ * into a temporary block that is transposed */
+static av_always_inline void angular_rows(uint8_t *src, ptrdiff_t stride,
+                                          const uint8_t *ref, int angle,
+                                          int size)
+{
+    int x, y;
+
+    for (y = 0; y < size; y++) {
+        int idx  = ((y + 1) * angle) >> 5;
+        int fact = ((y + 1) * angle) & 31;
+        const uint8_t *r = ref + idx + 1;
+
+        if (fact) {
+            uint8x8_t w0 = vdup_n_u8(32 - fact);
+            uint8x8_t w1 = vdup_n_u8(fact);
+
+            if (size == 4) {
+                uint16x8_t sum = vmull_u8(load_4(r), w0);
+                sum = vmlal_u8(sum, load_4(r + 1), w1);
+                store_4(&POS(0, y), vrshrn_n_u16(sum, 5));
+            } else {
+                for (x = 0; x < size; x += 8) {
+                    uint16x8_t sum = vmull_u8(vld1_u8(r + x), w0);
+                    sum = vmlal_u8(sum, vld1_u8(r + x + 1), w1);
+                    vst1_u8(&POS(x, y), vrshrn_n_u16(sum, 5));
+                }
+            }
+        } else if (size == 4) {
+            AV_COPY32U(&POS(0, y), r);
+        } else {
+            for (x = 0; x < size; x += 8)
+                vst1_u8(&POS(x, y), vld1_u8(r + x));
+        }
+    }
+}
+
+static av_always_inline void transpose_8x8(uint8_t *dst, ptrdiff_t dst_stride,
+                                           const uint8_t *src, ptrdiff_t src_stride)
+{
+    uint8x8x2_t  t0 = vtrn_u8(vld1_u8(src),                  vld1_u8(src +     src_stride));
+    uint8x8x2_t  t1 = vtrn_u8(vld1_u8(src + 2 * src_stride), vld1_u8(src + 3 * src_stride));
+    uint8x8x2_t  t2 = vtrn_u8(vld1_u8(src + 4 * src_stride), vld1_u8(src + 5 * src_stride));
+    uint8x8x2_t  t3 = vtrn_u8(vld1_u8(src + 6 * src_stride), vld1_u8(src + 7 * src_stride));
+    uint16x4x2_t u0 = vtrn_u16(vreinterpret_u16_u8(t0.val[0]), vreinterpret_u16_u8(t1.val[0]));
+    uint16x4x2_t u1 = vtrn_u16(vreinterpret_u16_u8(t0.val[1]), vreinterpret_u16_u8(t1.val[1]));
+    uint16x4x2_t u2 = vtrn_u16(vreinterpret_u16_u8(t2.val[0]), vreinterpret_u16_u8(t3.val[0]));
+    uint16x4x2_t u3 = vtrn_u16(vreinterpret_u16_u8(t2.val[1]), vreinterpret_u16_u8(t3.val[1]));
+    uint32x2x2_t v0 = vtrn_u32(vreinterpret_u32_u16(u0.val[0]), vreinterpret_u32_u16(u2.val[0]));
+    uint32x2x2_t v1 = vtrn_u32(vreinterpret_u32_u16(u1.val[0]), vreinterpret_u32_u16(u3.val[0]));
+    uint32x2x2_t v2 = vtrn_u32(vreinterpret_u32_u16(u0.val[1]), vreinterpret_u32_u16(u2.val[1]));
+    uint32x2x2_t v3 = vtrn_u32(vreinterpret_u32_u16(u1.val[1]), vreinterpret_u32_u16(u3.val[1]));
+
+    vst1_u8(dst,                  vreinterpret_u8_u32(v0.val[0]));
+    vst1_u8(dst +     dst_stride, vreinterpret_u8_u32(v1.val[0]));
+    vst1_u8(dst + 2 * dst_stride, vreinterpret_u8_u32(v2.val[0]));
+    vst1_u8(dst + 3 * dst_stride, vreinterpret_u8_u32(v3.val[0]));
+    vst1_u8(dst + 4 * dst_stride, vreinterpret_u8_u32(v0.val[1]));
+    vst1_u8(dst + 5 * dst_stride, vreinterpret_u8_u32(v1.val[1]));
+    vst1_u8(dst + 6 * dst_stride, vreinterpret_u8_u32(v2.val[1]));
+    vst1_u8(dst + 7 * dst_stride, vreinterpret_u8_u32(v3.val[1]));
+}
+
+/* tmp is a size x size block without padding */
+static av_always_inline void transpose(uint8_t *src, ptrdiff_t stride,
+                                       const uint8_t *tmp, int size)
+{
+    int x, y;
+
+    if (size == 4) {
+        static const uint8_t idx01[8] = { 0, 4,  8, 12, 1, 5,  9, 13 };
+        static const uint8_t idx23[8] = { 2, 6, 10, 14, 3, 7, 11, 15 };
+        uint8x8x2_t t;
+        uint32x2_t r01, r23;
+
+        t.val[0] = vld1_u8(tmp);
+        t.val[1] = vld1_u8(tmp + 8);
+        r01 = vreinterpret_u32_u8(vtbl2_u8(t, vld1_u8(idx01)));
+        r23 = vreinterpret_u32_u8(vtbl2_u8(t, vld1_u8(idx23)));
+        AV_WN32(&POS(0, 0), vget_lane_u32(r01, 0));
+        AV_WN32(&POS(0, 1), vget_lane_u32(r01, 1));
+        AV_WN32(&POS(0, 2), vget_lane_u32(r23, 0));
+        AV_WN32(&POS(0, 3), vget_lane_u32(r23, 1));
+    } else {
+        for (y = 0; y < size; y += 8)
+            for (x = 0; x < size; x += 8)
+                transpose_8x8(&POS(x, y), stride, tmp + x * size + y, size);
+    }
+}
+
+static av_always_inline void pred_angular(uint8_t *src, const uint8_t *top,
+                                          const uint8_t *left, ptrdiff_t stride,
+                                          int c_idx, int mode, int size)
+{
+    static const int intra_pred_angle[] = {
+         32,  26,  21,  17, 13,  9,  5, 2, 0, -2, -5, -9, -13, -17, -21, -26, -32,
+        -26, -21, -17, -13, -9, -5, -2, 0, 2,  5,  9, 13,  17,  21,  26,  32
+    };
+    static const int inv_angle[] = {
+        -4096, -1638, -910, -630, -482, -390, -315, -256, -315, -390, -482,
+        -630, -910, -1638, -4096
+    };
+    int angle = intra_pred_angle[mode - 2];
+    int last  = (size * angle) >> 5;
+    uint8_t ref_array[3 * 32 + 4];
+    uint8_t *ref_tmp = ref_array + size;
+    const uint8_t *ref;
+    int x, y;
+
+    if (mode >= 18) {
+        ref = top - 1;
+        if (angle < 0 && last < -1) {
+            memcpy(ref_tmp, top - 1, size + 1);
+            for (x = last; x <= -1; x++)
+                ref_tmp[x] = left[-1 + ((x * inv_angle[mode - 11] + 128) >> 8)];
+            ref = ref_tmp;
+        }
+
+        angular_rows(src, stride, ref, angle, size);
+
+        if (mode == 26 && c_idx == 0 && size < 32) {
+            for (y = 0; y < size; y++)
+                POS(0, y) = av_clip_uint8(top[0] + ((left[y] - left[-1]) >> 1));
+        }
+    } else {
+        uint8_t tmp[32 * 32];
+
+        ref = left - 1;
+        if (angle < 0 && last < -1) {
+            memcpy(ref_tmp, left - 1, size + 1);
+            for (x = last; x <= -1; x++)
+                ref_tmp[x] = top[-1 + ((x * inv_angle[mode - 11] + 128) >> 8)];
+            ref = ref_tmp;
+        }
+
+        angular_rows(tmp, size, ref, angle, size);
+        transpose(src, stride, tmp, size);
+
+        if (mode == 10 && c_idx == 0 && size < 32) {
+            for (x = 0; x < size; x++)
+                POS(x, 0) = av_clip_uint8(left[0] + ((top[x] - top[-1]) >> 1));
+        }
+    }
+}
+
+#define PRED_ANGULAR(size, log2_size)                                          \
+void ff_hevc_pred_angular_ ## size ## _neon_8(uint8_t *src, const uint8_t *top, \
+                                              const uint8_t *left, ptrdiff_t stride, \
+                                              int c_idx, int mode)           \
+{                                                                            \
+    pred_angular(src, top, left, stride, c_idx, mode, 1 << log2_size);       \
+}
+
+PRED_ANGULAR(0, 2)
+PRED_ANGULAR(1, 3)
+PRED_ANGULAR(2, 4)
+PRED_ANGULAR(3, 5)
+
+#undef PRED_ANGULAR
+
+///////////////////////////////////////////////////////////////////////////////
+// Above 8 bit
+///////////////////////////////////////////////////////////////////////////////
+/*
+ * The same algorithms on 16 bit samples, 4 at a time as the sums need 32
+ * bit: the planar one reaches 2 * 32 * 4095 at 12 bit, the angular one
+ * 32 * 4095. The bit depth only matters to the clipping of the edge filters
+ * of the pure horizontal and vertical modes. The strides are in pixels.
+ */
+static av_always_inline void pred_planar_16(uint16_t *src, const uint16_t *top,
+                                            const uint16_t *left, ptrdiff_t stride,
+                                            int log2_size)
+{
+    static const uint32_t lane[4] = { 0, 1, 2, 3 };
+    int size = 1 << log2_size;
+    int32x4_t shift = vdupq_n_s32(-(log2_size + 1));
+    int x, y;
+
+    for (x = 0; x < size; x += 4) {
+        uint32x4_t xs    = vaddq_u32(vld1q_u32(lane), vdupq_n_u32(x));
+        uint32x4_t t     = vmovl_u16(vld1_u16(top + x));
+        uint32x4_t wl    = vsubq_u32(vdupq_n_u32(size - 1), xs);
+        uint32x4_t delta = vsubq_u32(vdupq_n_u32(left[size]), t);
+        uint32x4_t acc   = vmulq_n_u32(vaddq_u32(xs, vdupq_n_u32(1)), top[size]);
+
+        acc = vmlaq_n_u32(acc, t, size - 1);
+        acc = vaddq_u32(acc, vdupq_n_u32(left[size] + size));
+        for (y = 0; y < size; y++) {
+            uint32x4_t sum = vmlaq_n_u32(acc, wl, left[y]);
+            vst1_u16(&POS(x, y), vmovn_u32(vshlq_u32(sum, shift)));
+            acc = vaddq_u32(acc, delta);
+        }
+    }
+}
+
+static av_always_inline void pred_dc_16(uint16_t *src, const uint16_t *top,
+                                        const uint16_t *left, ptrdiff_t stride,
+                                        int log2_size, int c_idx)
+{
+    int size = 1 << log2_size;
+    uint32x4_t sum = vdupq_n_u32(0);
+    uint64x2_t sum64;
+    uint16x8_t dc_v;
+    int dc, x, y;
+
+    for (x = 0; x < size; x += 4)
+        sum = vaddq_u32(sum, vaddl_u16(vld1_u16(left + x), vld1_u16(top + x)));
+    sum64 = vpaddlq_u32(sum);
+    dc    = (vgetq_lane_u64(sum64, 0) + vgetq_lane_u64(sum64, 1) + size) >> (log2_size + 1);
+    dc_v  = vdupq_n_u16(dc);
+
+    for (y = 0; y < size; y++) {
+        if (size == 4)
+            vst1_u16(&POS(0, y), vget_low_u16(dc_v));
+        else
+            for (x = 0; x < size; x += 8)
+                vst1q_u16(&POS(x, y), dc_v);
+    }
+
+    /* top[x] + 3 * dc stays below 1 << 14 */
+    if (c_idx == 0 && size < 32) {
+        uint16x4_t dc3 = vdup_n_u16(3 * dc);
+
+        for (x = 0; x < size; x += 4)
+            vst1_u16(&POS(x, 0), vrshr_n_u16(vadd_u16(dc3, vld1_u16(top + x)), 2));
+        POS(0, 0) = (left[0] + 2 * dc + top[0] + 2) >> 2;
+        for (y = 1; y < size; y++)
+            POS(0, y) = (left[y] + 3 * dc + 2) >> 2;
+    }
+}
+
+static av_always_inline void angular_rows_16(uint16_t *src, ptrdiff_t stride,
+                                             const uint16_t *ref, int angle,
+                                             int size)
+{
+    int x, y;
+
+    for (y = 0; y < size; y++) {
+        int idx  = ((y + 1) * angle) >> 5;
+        int fact = ((y + 1) * angle) & 31;
+        const uint16_t *r = ref + idx + 1;
+
+        if (fact) {
+            for (x = 0; x < size; x += 4) {
+                uint32x4_t sum = vmull_n_u16(vld1_u16(r + x), 32 - fact);
+                sum = vmlal_n_u16(sum, vld1_u16(r + x + 1), fact);
+                vst1_u16(&POS(x, y), vrshrn_n_u32(sum, 5));
+            }
+        } else {
+            for (x = 0; x < size; x += 4)
+                vst1_u16(&POS(x, y), vld1_u16(r + x));
+        }
+    }
+}
+
+/* tmp is a size x size block without padding */
+static av_always_inline void transpose_16(uint16_t *src, ptrdiff_t stride,
+                                          const uint16_t *tmp, int size)
+{
+    int x, y;
+
+    for (y = 0; y < size; y += 4) {
+        for (x = 0; x < size; x += 4) {
+            const uint16_t *t = tmp + x * size + y;
+            uint16x4x2_t t01 = vtrn_u16(vld1_u16(t),            vld1_u16(t + size));
+            uint16x4x2_t t23 = vtrn_u16(vld1_u16(t + 2 * size), vld1_u16(t + 3 * size));
+            uint32x2x2_t a   = vtrn_u32(vreinterpret_u32_u16(t01.val[0]),
+                                        vreinterpret_u32_u16(t23.val[0]));
+            uint32x2x2_t b   = vtrn_u32(vreinterpret_u32_u16(t01.val[1]),
+                                        vreinterpret_u32_u16(t23.val[1]));
+
+            vst1_u16(&POS(x, y),     vreinterpret_u16_u32(a.val[0]));
+            vst1_u16(&POS(x, y + 1), vreinterpret_u16_u32(b.val[0]));
+            vst1_u16(&POS(x, y + 2), vreinterpret_u16_u32(a.val[1]));
+            vst1_u16(&POS(x, y + 3), vreinterpret_u16_u32(b.val[1]));
+        }
+    }
+}
+
+static av_always_inline void pred_angular_16(uint16_t *src, const uint16_t *top,
+                                             const uint16_t *left, ptrdiff_t stride,
+                                             int c_idx, int mode, int size, int depth)
+{
+    static const int intra_pred_angle[] = {
+         32,  26,  21,  17, 13,  9,  5, 2, 0, -2, -5, -9, -13, -17, -21, -26, -32,
+        -26, -21, -17, -13, -9, -5, -2, 0, 2,  5,  9, 13,  17,  21,  26,  32
+    };
+    static const int inv_angle[] = {
+        -4096, -1638, -910, -630, -482, -390, -315, -256, -315, -390, -482,
+        -630, -910, -1638, -4096
+    };
+    int angle = intra_pred_angle[mode - 2];
+    int last  = (size * angle) >> 5;
+    uint16_t ref_array[3 * 32 + 4];
+    uint16_t *ref_tmp = ref_array + size;
+    const uint16_t *ref;
+    int x, y;
+
+    if (mode >= 18) {
+        ref = top - 1;
+        if (angle < 0 && last < -1) {
+            memcpy(ref_tmp, top - 1, 2 * (size + 1));
+            for (x = last; x <= -1; x++)
+                ref_tmp[x] = left[-1 + ((x * inv_angle[mode - 11] + 128) >> 8)];
+            ref = ref_tmp;
+        }
+
+        angular_rows_16(src, stride, ref, angle, size);
+
+        if (mode == 26 && c_idx == 0 && size < 32) {
+            for (y = 0; y < size; y++)
+                POS(0, y) = av_clip_uintp2(top[0] + ((left[y] - left[-1]) >> 1), depth);
+        }
+    } else {
+        uint16_t tmp[32 * 32];
+
+        ref = left - 1;
+        if (angle < 0 && last < -1) {
+            memcpy(ref_tmp, left - 1, 2 * (size + 1));
+            for (x = last; x <= -1; x++)
+                ref_tmp[x] = top[-1 + ((x * inv_angle[mode - 11] + 128) >> 8)];
+            ref = ref_tmp;
+        }
+
+        angular_rows_16(tmp, size, ref, angle, size);
+        transpose_16(src, stride, tmp, size);
+
+        if (mode == 10 && c_idx == 0 && size < 32) {
+            for (x = 0; x < size; x++)
+                POS(x, 0) = av_clip_uintp2(left[0] + ((top[x] - top[-1]) >> 1), depth);
+        }
+    }
+}
+
+#define PRED_16(size, depth)                                                   \
+void ff_hevc_pred_planar_ ## size ## _neon_ ## depth(uint8_t *src, const uint8_t *top, \
+                                                     const uint8_t *left,    \
+                                                     ptrdiff_t stride)       \
+{                                                                            \
+    pred_planar_16((uint16_t *)src, (const uint16_t *)top,                   \
+                   (const uint16_t *)left, stride, size + 2);                \
+}                                                                            \
+                                                                             \
+void ff_hevc_pred_angular_ ## size ## _neon_ ## depth(uint8_t *src, const uint8_t *top, \
+                                                      const uint8_t *left,   \
+                                                      ptrdiff_t stride,      \
+                                                      int c_idx, int mode)   \
+{                                                                            \
+    pred_angular_16((uint16_t *)src, (const uint16_t *)top,                  \
+                    (const uint16_t *)left, stride, c_idx, mode,             \
+                    1 << (size + 2), depth);                                 \
+}
+
+#define PRED_FUNCS_16(depth)                                                   \
+PRED_16(0, depth)                                                            \
+PRED_16(1, depth)                                                            \
+PRED_16(2, depth)                                                            \
+PRED_16(3, depth)                                                            \
+                                                                             \
+void ff_hevc_pred_dc_neon_ ## depth(uint8_t *src, const uint8_t *top,        \
+                                    const uint8_t *left, ptrdiff_t stride,   \
+                                    int log2_size, int c_idx)                \
+{                                                                            \
+    pred_dc_16((uint16_t *)src, (const uint16_t *)top,                       \
+               (const uint16_t *)left, stride, log2_size, c_idx);            \
+}
+
+PRED_FUNCS_16(10)
+PRED_FUNCS_16(12)
+
+#undef PRED_16
+#undef PRED_FUNCS_16
+#undef POS
@@ -0,0 +1,559 @@
+/*
+ * HEVC motion compensation, NEON intrinsics
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <arm_neon.h>
+#include <string.h>
+
+#include "config.h"
+#include "libavutil/common.h"
+#include "libavutil/intreadwrite.h"
+#include "libavcodec/get_bits.h"
+#include "libavcodec/hevc.h"
+#include "libavcodec/arm/hevcdsp_neon.h"
+
+/*
+ * The functions take every block width: rows are done 8 pixels at a time,
+ * then 4, and the last 2 pixels of the 2, 6 and 12 wide chroma blocks in C.
+ * Nothing is written past the width.
+ */
+
+static av_always_inline uint8x8_t load_4(const uint8_t *src)
+{
+    return vreinterpret_u8_u32(vdup_n_u32(AV_RN32(src)));
+}
+
+static av_always_inline void store_4(uint8_t *dst, uint8x8_t v)
+{
+    AV_WN32(dst, vget_lane_u32(vreinterpret_u32_u8(v), 0));
+}
+
+static av_always_inline int16x8_t load_4_s16(const int16_t *src)
+{
+    int16x4_t v = vld1_s16(src);
+    return vcombine_s16(v, v);
+}
+
+void ff_hevc_put_hevc_pel_pixels_neon_8(int16_t *dst, ptrdiff_t dststride,
+                                        uint8_t *src, ptrdiff_t srcstride,
+                                        int height, intptr_t mx, intptr_t my,
+                                        int width)
+{
+    int x, y;
+
+    for (y = 0; y < height; y++) {
+        for (x = 0; x + 8 <= width; x += 8)
+            vst1q_s16(dst + x, vreinterpretq_s16_u16(vshll_n_u8(vld1_u8(src + x), 6)));
+        if (x + 4 <= width) {
+            vst1_s16(dst + x, vget_low_s16(vreinterpretq_s16_u16(vshll_n_u8(load_4(src + x), 6))));
+            x += 4;
+        }
+        for (; x < width; x++)
+            dst[x] = src[x] << 6;
+        src += srcstride;
+        dst += dststride;
+    }
+}
+
+void ff_hevc_put_hevc_pel_uni_pixels_neon_8(uint8_t *dst, ptrdiff_t dststride,
+                                            uint8_t *src, ptrdiff_t srcstride,
+                                            int height, intptr_t mx, intptr_t my,
+                                            int width)
+{
+    int x, y;
+
+    for (y = 0; y < height; y++) {
+        for (x = 0; x + 16 <= width; x += 16)
+            vst1q_u8(dst + x, vld1q_u8(src + x));
+        if (x < width)
+            memcpy(dst + x, src + x, width - x);
+        src += srcstride;
+        dst += dststride;
+    }
+}
+
+/* (src << 6) + src2 can leave the int16 range, saturating it does not
+ * change the clipped result */
+static av_always_inline uint8x8_t bi_8(uint8x8_t src, int16x8_t src2)
+{
+    int16x8_t sum = vqaddq_s16(vreinterpretq_s16_u16(vshll_n_u8(src, 6)), src2);
+    return vqrshrun_n_s16(sum, 7);
+}
+
+void ff_hevc_put_hevc_pel_bi_pixels_neon_8(uint8_t *dst, ptrdiff_t dststride,
+                                           uint8_t *src, ptrdiff_t srcstride,
+                                           int16_t *src2, ptrdiff_t src2stride,
+                                           int height, intptr_t mx, intptr_t my,
+                                           int width)
+{
+    int x, y;
+
+    for (y = 0; y < height; y++) {
+        for (x = 0; x + 8 <= width; x += 8)
+            vst1_u8(dst + x, bi_8(vld1_u8(src + x), vld1q_s16(src2 + x)));
+        if (x + 4 <= width) {
+            store_4(dst + x, bi_8(load_4(src + x), load_4_s16(src2 + x)));
+            x += 4;
+        }
+        for (; x < width; x++)
+            dst[x] = av_clip_uint8(((src[x] << 6) + src2[x] + 64) >> 7);
+        src  += srcstride;
+        dst  += dststride;
+        src2 += src2stride;
+    }
+}
+
+/* the rounding shift right is a shift left by -shift, 32 bit as the
+ * weighted samples need up to 22 bits */
+static av_always_inline uint8x8_t uni_w_8(uint8x8_t src, int16x4_t wx,
+                                          int32x4_t shift, int32x4_t ox)
+{
+    int16x8_t s  = vreinterpretq_s16_u16(vshll_n_u8(src, 6));
+    int32x4_t lo = vmull_s16(vget_low_s16(s),  wx);
+    int32x4_t hi = vmull_s16(vget_high_s16(s), wx);
+
+    lo = vaddq_s32(vrshlq_s32(lo, shift), ox);
+    hi = vaddq_s32(vrshlq_s32(hi, shift), ox);
+    return vqmovun_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+}
+
+void ff_hevc_put_hevc_pel_uni_w_pixels_neon_8(uint8_t *dst, ptrdiff_t dststride,
+                                              uint8_t *src, ptrdiff_t srcstride,
+                                              int height, int denom, int wx, int ox,
+                                              intptr_t mx, intptr_t my, int width)
+{
+    int shift  = denom + 6;
+    int offset = 1 << (shift - 1);
+    int16x4_t wx_v    = vdup_n_s16(wx);
+    int32x4_t shift_v = vdupq_n_s32(-shift);
+    int32x4_t ox_v    = vdupq_n_s32(ox);
+    int x, y;
+
+    for (y = 0; y < height; y++) {
+        for (x = 0; x + 8 <= width; x += 8)
+            vst1_u8(dst + x, uni_w_8(vld1_u8(src + x), wx_v, shift_v, ox_v));
+        if (x + 4 <= width) {
+            store_4(dst + x, uni_w_8(load_4(src + x), wx_v, shift_v, ox_v));
+            x += 4;
+        }
+        for (; x < width; x++)
+            dst[x] = av_clip_uint8((((src[x] << 6) * wx + offset) >> shift) + ox);
+        src += srcstride;
+        dst += dststride;
+    }
+}
+
+/* the C version shifts without rounding, the rounding is in the offset */
+static av_always_inline uint8x8_t bi_w_8(uint8x8_t src, int16x8_t src2,
+                                         int16x4_t wx0, int16x4_t wx1,
+                                         int32x4_t shift, int32x4_t offset)
+{
+    int16x8_t s  = vreinterpretq_s16_u16(vshll_n_u8(src, 6));
+    int32x4_t lo = vmlal_s16(offset, vget_low_s16(s),  wx1);
+    int32x4_t hi = vmlal_s16(offset, vget_high_s16(s), wx1);
+
+    lo = vmlal_s16(lo, vget_low_s16(src2),  wx0);
+    hi = vmlal_s16(hi, vget_high_s16(src2), wx0);
+    lo = vshlq_s32(lo, shift);
+    hi = vshlq_s32(hi, shift);
+    return vqmovun_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+}
+
+void ff_hevc_put_hevc_pel_bi_w_pixels_neon_8(uint8_t *dst, ptrdiff_t dststride,
+                                             uint8_t *src, ptrdiff_t srcstride,
+                                             int16_t *src2, ptrdiff_t src2stride,
+                                             int height, int denom, int wx0, int wx1,
+                                             int ox0, int ox1, intptr_t mx, intptr_t my,
+                                             int width)
+{
+    int log2Wd = denom + 6;
+    int offset = (ox0 + ox1 + 1) * (1 << log2Wd);
+    int16x4_t wx0_v    = vdup_n_s16(wx0);
+    int16x4_t wx1_v    = vdup_n_s16(wx1);
+    int32x4_t shift_v  = vdupq_n_s32(-(log2Wd + 1));
+    int32x4_t offset_v = vdupq_n_s32(offset);
+    int x, y;
+
+    for (y = 0; y < height; y++) {
+        for (x = 0; x + 8 <= width; x += 8)
+            vst1_u8(dst + x, bi_w_8(vld1_u8(src + x), vld1q_s16(src2 + x),
+                                    wx0_v, wx1_v, shift_v, offset_v));
+        if (x + 4 <= width) {
+            store_4(dst + x, bi_w_8(load_4(src + x), load_4_s16(src2 + x),
+                                    wx0_v, wx1_v, shift_v, offset_v));
+            x += 4;
+        }
+        for (; x < width; x++)
+            dst[x] = av_clip_uint8(((src[x] << 6) * wx1 + src2[x] * wx0 + offset) >> (log2Wd + 1));
+        src  += srcstride;
+        dst  += dststride;
+        src2 += src2stride;
+    }
+}
+
+/*
+ * Fractional sample positions. The horizontal and vertical filters of 8 bit
+ * samples fit int16, the ones of higher bit depths and the second pass of hv
+ * are 32 bit as their sums do not. The filtered samples are handed to the
+ * output stage as 32 bit so that uni, bi and weighted prediction round and
+ * clip them exactly like C. The last 2 pixels of the 2, 6 and 12 wide
+ * blocks are filtered from a copy of their neighbourhood, so nothing is read
+ * past what C reads. Above 8 bit the full sample positions go through the
+ * same code as FILTER_PEL, their samples shifted up to 14 bit.
+ */
+
+enum MCFilter { FILTER_H, FILTER_V, FILTER_HV, FILTER_PEL };
+enum MCOutput { OUT_PLAIN, OUT_UNI, OUT_BI, OUT_UNI_W, OUT_BI_W };
+
+typedef struct MCWeight {
+    int wx0, wx1;
+    int32x4_t shift;  ///< negated, the shifts are left shifts
+    int32x4_t offset; ///< ox for uni_w, the rounding and offsets for bi_w
+} MCWeight;
+
+/* src points at the sample being predicted, stride is in elements */
+static av_always_inline int32x4x2_t filter_8(const uint8_t *src, ptrdiff_t stride,
+                                             const int8_t *filter, int taps, int n)
+{
+    int16x8_t sum = vdupq_n_s16(0);
+    int32x4x2_t ret;
+    int k;
+
+    src -= (taps / 2 - 1) * stride;
+    for (k = 0; k < taps; k++) {
+        uint8x8_t s = n == 8 ? vld1_u8(src + k * stride) : load_4(src + k * stride);
+        sum = vmlaq_n_s16(sum, vreinterpretq_s16_u16(vmovl_u8(s)), filter[k]);
+    }
+    ret.val[0] = vmovl_s16(vget_low_s16(sum));
+    ret.val[1] = vmovl_s16(vget_high_s16(sum));
+    return ret;
+}
+
+/* the samples above 8 bit are below 1 << 15 and read as int16 as well */
+static av_always_inline int32x4x2_t filter_16(const int16_t *src, ptrdiff_t stride,
+                                              const int8_t *filter, int taps, int n,
+                                              int shift)
+{
+    int32x4_t shift_v = vdupq_n_s32(-shift);
+    int32x4x2_t sum;
+    int k;
+
+    sum.val[0] = sum.val[1] = vdupq_n_s32(0);
+    src -= (taps / 2 - 1) * stride;
+    for (k = 0; k < taps; k++) {
+        sum.val[0] = vmlal_n_s16(sum.val[0], vld1_s16(src + k * stride), filter[k]);
+        if (n == 8)
+            sum.val[1] = vmlal_n_s16(sum.val[1], vld1_s16(src + k * stride + 4), filter[k]);
+    }
+    sum.val[0] = vshlq_s32(sum.val[0], shift_v);
+    sum.val[1] = n == 8 ? vshlq_s32(sum.val[1], shift_v) : sum.val[0];
+    return sum;
+}
+
+static av_always_inline int32x4x2_t pel_16(const int16_t *src, int n, int depth)
+{
+    int32x4_t shift_v = vdupq_n_s32(14 - depth);
+    int16x4_t lo = vld1_s16(src);
+    int32x4x2_t ret;
+
+    ret.val[0] = vshlq_s32(vmovl_s16(lo), shift_v);
+    ret.val[1] = n == 8 ? vshlq_s32(vmovl_s16(vld1_s16(src + 4)), shift_v) : ret.val[0];
+    return ret;
+}
+
+/* src is an int16_t array for FILTER_HV and above 8 bit, srcstride is in bytes */
+static av_always_inline int32x4x2_t mc_filter(int type, const uint8_t *src, ptrdiff_t srcstride,
+                                              const int8_t *filter, int taps, int n,
+                                              int depth)
+{
+    if (type == FILTER_HV)
+        return filter_16((const int16_t *)src, srcstride / 2, filter, taps, n, 6);
+    if (type == FILTER_PEL)
+        return pel_16((const int16_t *)src, n, depth);
+    if (depth > 8)
+        return filter_16((const int16_t *)src, type == FILTER_H ? 1 : srcstride / 2,
+                         filter, taps, n, depth - 8);
+    return filter_8(src, type == FILTER_H ? 1 : srcstride, filter, taps, n);
+}
+
+static av_always_inline int32x4x2_t mc_filter_tail(int type, const uint8_t *src, ptrdiff_t srcstride,
+                                                   const int8_t *filter, int taps, int n,
+                                                   int depth)
+{
+    union { uint8_t u8[8 * 16]; int16_t s16[8 * 8]; } buf = { { 0 } };
+    int ps     = type == FILTER_HV || depth > 8;
+    int before = taps / 2 - 1;
+    int k;
+
+    if (type == FILTER_PEL) {
+        memcpy(buf.u8, src, n << ps);
+        return mc_filter(type, buf.u8, 16, filter, taps, 8, depth);
+    }
+    if (type == FILTER_H) {
+        memcpy(buf.u8, src - (before << ps), (n + taps - 1) << ps);
+        return mc_filter(type, buf.u8 + (before << ps), 16, filter, taps, 8, depth);
+    }
+    for (k = 0; k < taps; k++)
+        memcpy(buf.u8 + 16 * k, src + (k - before) * srcstride, n << ps);
+    return mc_filter(type, buf.u8 + 16 * before, 16, filter, taps, 8, depth);
+}
+
+/* the rounding shifts right are shifts left by minus the shift */
+static av_always_inline int32x4x2_t mc_output(int out, int32x4x2_t v, int16x8_t src2,
+                                              const MCWeight *w, int depth)
+{
+    int32x4_t lo = v.val[0], hi = v.val[1];
+
+    switch (out) {
+    case OUT_UNI:
+        lo = vrshlq_s32(lo, vdupq_n_s32(depth - 14));
+        hi = vrshlq_s32(hi, vdupq_n_s32(depth - 14));
+        break;
+    case OUT_BI:
+        lo = vrshlq_s32(vaddw_s16(lo, vget_low_s16(src2)),  vdupq_n_s32(depth - 15));
+        hi = vrshlq_s32(vaddw_s16(hi, vget_high_s16(src2)), vdupq_n_s32(depth - 15));
+        break;
+    case OUT_UNI_W:
+        lo = vaddq_s32(vrshlq_s32(vmulq_n_s32(lo, w->wx1), w->shift), w->offset);
+        hi = vaddq_s32(vrshlq_s32(vmulq_n_s32(hi, w->wx1), w->shift), w->offset);
+        break;
+    default:
+        lo = vmlaq_n_s32(vmlal_n_s16(w->offset, vget_low_s16(src2),  w->wx0), lo, w->wx1);
+        hi = vmlaq_n_s32(vmlal_n_s16(w->offset, vget_high_s16(src2), w->wx0), hi, w->wx1);
+        lo = vshlq_s32(lo, w->shift);
+        hi = vshlq_s32(hi, w->shift);
+        break;
+    }
+    v.val[0] = lo;
+    v.val[1] = hi;
+    return v;
+}
+
+static av_always_inline void mc_store(int out, uint8_t *dst, int32x4x2_t v,
+                                      const int16_t *src2, const MCWeight *w,
+                                      int n, int depth)
+{
+    int16x8_t s2 = vdupq_n_s16(0);
+
+    if (out == OUT_PLAIN) {
+        /* the C version truncates the hv sum to int16 as well */
+        int16x8_t r = vcombine_s16(vmovn_s32(v.val[0]), vmovn_s32(v.val[1]));
+        int16_t tmp[8];
+        if (n == 8) {
+            vst1q_s16((int16_t *)dst, r);
+        } else if (n == 4) {
+            vst1_s16((int16_t *)dst, vget_low_s16(r));
+        } else {
+            vst1q_s16(tmp, r);
+            memcpy(dst, tmp, 2 * n);
+        }
+        return;
+    }
+
+    if (out == OUT_BI || out == OUT_BI_W) {
+        int16_t tmp[8] = { 0 };
+        if (n == 8) {
+            s2 = vld1q_s16(src2);
+        } else if (n == 4) {
+            s2 = load_4_s16(src2);
+        } else {
+            memcpy(tmp, src2, 2 * n);
+            s2 = vld1q_s16(tmp);
+        }
+    }
+
+    v = mc_output(out, v, s2, w, depth);
+    if (depth > 8) {
+        uint16x8_t res = vcombine_u16(vqmovun_s32(v.val[0]), vqmovun_s32(v.val[1]));
+        uint16_t tmp[8];
+
+        res = vminq_u16(res, vdupq_n_u16((1 << depth) - 1));
+        if (n == 8) {
+            vst1q_u16((uint16_t *)dst, res);
+        } else if (n == 4) {
+            vst1_u16((uint16_t *)dst, vget_low_u16(res));
+        } else {
+            vst1q_u16(tmp, res);
+            memcpy(dst, tmp, 2 * n);
+        }
+    } else {
+        uint8x8_t res = vqmovun_s16(vcombine_s16(vqmovn_s32(v.val[0]), vqmovn_s32(v.val[1])));
+        uint8_t tmp[8];
+
+        if (n == 8) {
+            vst1_u8(dst, res);
+        } else if (n == 4) {
+            store_4(dst, res);
+        } else {
+            vst1_u8(tmp, res);
+            memcpy(dst, tmp, n);
+        }
+    }
+}
+
+/* dststride and srcstride are in bytes */
+static av_always_inline void put_mc(int out, int type, int taps,
+                                    uint8_t *dst, ptrdiff_t dststride,
+                                    const uint8_t *src, ptrdiff_t srcstride,
+                                    const int16_t *src2, ptrdiff_t src2stride,
+                                    int height, const int8_t *filter, int width,
+                                    const MCWeight *w, int depth)
+{
+    int dsize = out == OUT_PLAIN   || depth > 8 ? 2 : 1;
+    int ssize = type == FILTER_HV || depth > 8 ? 2 : 1;
+    int bi    = out == OUT_BI || out == OUT_BI_W;
+    int x, y;
+
+    for (y = 0; y < height; y++) {
+        for (x = 0; x + 8 <= width; x += 8)
+            mc_store(out, dst + x * dsize,
+                     mc_filter(type, src + x * ssize, srcstride, filter, taps, 8, depth),
+                     bi ? src2 + x : NULL, w, 8, depth);
+        if (x + 4 <= width) {
+            mc_store(out, dst + x * dsize,
+                     mc_filter(type, src + x * ssize, srcstride, filter, taps, 4, depth),
+                     bi ? src2 + x : NULL, w, 4, depth);
+            x += 4;
+        }
+        if (x < width)
+            mc_store(out, dst + x * dsize,
+                     mc_filter_tail(type, src + x * ssize, srcstride, filter, taps,
+                                    width - x, depth),
+                     bi ? src2 + x : NULL, w, width - x, depth);
+        src += srcstride;
+        dst += dststride;
+        if (bi)
+            src2 += src2stride;
+    }
+}
+
+static av_always_inline void put_mc_hv(int out, int taps,
+                                       uint8_t *dst, ptrdiff_t dststride,
+                                       const uint8_t *src, ptrdiff_t srcstride,
+                                       const int16_t *src2, ptrdiff_t src2stride,
+                                       int height, const int8_t *filter_h,
+                                       const int8_t *filter_v, int width,
+                                       const MCWeight *w, int depth)
+{
+    int16_t tmp_array[(MAX_PB_SIZE + QPEL_EXTRA) * MAX_PB_SIZE];
+    int before = taps / 2 - 1;
+
+    put_mc(OUT_PLAIN, FILTER_H, taps, (uint8_t *)tmp_array, 2 * MAX_PB_SIZE,
+           src - before * srcstride, srcstride, NULL, 0,
+           height + taps - 1, filter_h, width, NULL, depth);
+    put_mc(out, FILTER_HV, taps, dst, dststride,
+           (const uint8_t *)(tmp_array + before * MAX_PB_SIZE), 2 * MAX_PB_SIZE,
+           src2, src2stride, height, filter_v, width, w, depth);
+}
+
+#define MC_FILTER(taps, frac) \
+    ((taps) == 8 ? ff_hevc_qpel_filters[(frac) - 1] : ff_hevc_epel_filters[(frac) - 1])
+
+static av_always_inline void put_mc_dir(int out, int dir, int taps,
+                                        uint8_t *dst, ptrdiff_t dststride,
+                                        const uint8_t *src, ptrdiff_t srcstride,
+                                        const int16_t *src2, ptrdiff_t src2stride,
+                                        int height, intptr_t mx, intptr_t my, int width,
+                                        const MCWeight *w, int depth)
+{
+    if (dir == FILTER_PEL && out == OUT_UNI)
+        ff_hevc_put_hevc_pel_uni_pixels_neon_8(dst, dststride, (uint8_t *)src, srcstride,
+                                               height, mx, my, width << (depth > 8));
+    else if (dir == FILTER_PEL)
+        put_mc(out, dir, taps, dst, dststride, src, srcstride, src2, src2stride,
+               height, NULL, width, w, depth);
+    else if (dir == FILTER_HV)
+        put_mc_hv(out, taps, dst, dststride, src, srcstride, src2, src2stride,
+                  height, MC_FILTER(taps, mx), MC_FILTER(taps, my), width, w, depth);
+    else
+        put_mc(out, dir, taps, dst, dststride, src, srcstride, src2, src2stride,
+               height, dir == FILTER_H ? MC_FILTER(taps, mx) : MC_FILTER(taps, my), width,
+               w, depth);
+}
+
+#define PUT_HEVC_MC(pel, taps, dir, DIR, depth)                                            \
+void ff_hevc_put_hevc_ ## pel ## _ ## dir ## _neon_ ## depth(int16_t *dst, ptrdiff_t dststride, \
+                                                             uint8_t *src, ptrdiff_t srcstride, \
+                                                             int height, intptr_t mx,      \
+                                                             intptr_t my, int width)       \
+{                                                                                          \
+    put_mc_dir(OUT_PLAIN, DIR, taps, (uint8_t *)dst, 2 * dststride, src, srcstride,        \
+               NULL, 0, height, mx, my, width, NULL, depth);                               \
+}                                                                                          \
+                                                                                           \
+void ff_hevc_put_hevc_ ## pel ## _uni_ ## dir ## _neon_ ## depth(uint8_t *dst, ptrdiff_t dststride, \
+                                                                 uint8_t *src, ptrdiff_t srcstride, \
+                                                                 int height, intptr_t mx,  \
+                                                                 intptr_t my, int width)   \
+{                                                                                          \
+    put_mc_dir(OUT_UNI, DIR, taps, dst, dststride, src, srcstride,                         \
+               NULL, 0, height, mx, my, width, NULL, depth);                               \
+}                                                                                          \
+                                                                                           \
+void ff_hevc_put_hevc_ ## pel ## _bi_ ## dir ## _neon_ ## depth(uint8_t *dst, ptrdiff_t dststride, \
+                                                                uint8_t *src, ptrdiff_t srcstride, \
+                                                                int16_t *src2, ptrdiff_t src2stride, \
+                                                                int height, intptr_t mx,   \
+                                                                intptr_t my, int width)    \
+{                                                                                          \
+    put_mc_dir(OUT_BI, DIR, taps, dst, dststride, src, srcstride,                          \
+               src2, src2stride, height, mx, my, width, NULL, depth);                      \
+}                                                                                          \
+                                                                                           \
+void ff_hevc_put_hevc_ ## pel ## _uni_w_ ## dir ## _neon_ ## depth(uint8_t *dst, ptrdiff_t dststride, \
+                                                                   uint8_t *src, ptrdiff_t srcstride, \
+                                                                   int height, int denom,  \
+                                                                   int wx, int ox, intptr_t mx, \
+                                                                   intptr_t my, int width) \
+{                                                                                          \
+    MCWeight w = { 0, wx, vdupq_n_s32(-(denom + 14 - depth)),                              \
+                   vdupq_n_s32(ox * (1 << (depth - 8))) };                                 \
+    put_mc_dir(OUT_UNI_W, DIR, taps, dst, dststride, src, srcstride,                       \
+               NULL, 0, height, mx, my, width, &w, depth);                                 \
+}                                                                                          \
+                                                                                           \
+void ff_hevc_put_hevc_ ## pel ## _bi_w_ ## dir ## _neon_ ## depth(uint8_t *dst, ptrdiff_t dststride, \
+                                                                  uint8_t *src, ptrdiff_t srcstride, \
+                                                                  int16_t *src2, ptrdiff_t src2stride, \
+                                                                  int height, int denom,   \
+                                                                  int wx0, int wx1, int ox0, \
+                                                                  int ox1, intptr_t mx,    \
+                                                                  intptr_t my, int width)  \
+{                                                                                          \
+    int ox = (ox0 + ox1) * (1 << (depth - 8));                                             \
+    MCWeight w = { wx0, wx1, vdupq_n_s32(-(denom + 15 - depth)),                           \
+                   vdupq_n_s32((ox + 1) * (1 << (denom + 14 - depth))) };                  \
+    put_mc_dir(OUT_BI_W, DIR, taps, dst, dststride, src, srcstride,                        \
+               src2, src2stride, height, mx, my, width, &w, depth);                        \
+}
+
+#define PUT_HEVC_MC_FUNCS(depth)                                               \
+PUT_HEVC_MC(qpel, 8, h,  FILTER_H,  depth)                                     \
+PUT_HEVC_MC(qpel, 8, v,  FILTER_V,  depth)                                     \
+PUT_HEVC_MC(qpel, 8, hv, FILTER_HV, depth)                                     \
+PUT_HEVC_MC(epel, 4, h,  FILTER_H,  depth)                                     \
+PUT_HEVC_MC(epel, 4, v,  FILTER_V,  depth)                                     \
+PUT_HEVC_MC(epel, 4, hv, FILTER_HV, depth)
+
+PUT_HEVC_MC_FUNCS(8)
+PUT_HEVC_MC_FUNCS(10)
+PUT_HEVC_MC_FUNCS(12)
+
+PUT_HEVC_MC(pel, 0, pixels, FILTER_PEL, 10)
+PUT_HEVC_MC(pel, 0, pixels, FILTER_PEL, 12)
@@ -0,0 +1,388 @@
+/*
+ * HEVC SAO filters, NEON intrinsics
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <arm_neon.h>
+
+#include "config.h"
+#include "libavutil/common.h"
+#include "libavutil/intreadwrite.h"
+#include "libavcodec/get_bits.h"
+#include "libavcodec/hevc.h"
+#include "libavcodec/arm/hevcdsp_neon.h"
+
+/*
+ * The offsets of SAO fit in int8 up to 12 bit, 31 scaled by at most
+ * 1 << (bit depth - 10), so both filters look them up with vtbl: the 32
+ * bands of the band offset are a 4 register table indexed by the top 5 bits
+ * of the sample, the edge offset a 1 register table indexed by the sum of
+ * the two signs. Rows are done 8 pixels at a time, then 4 for chroma
+ * widths. Above 8 bit the samples are 16 bit and only the indices are
+ * narrowed to 8 bit. The strides of the loops are in pixels.
+ */
+
+static av_always_inline uint8x8_t load_4(const uint8_t *src)
+{
+    return vreinterpret_u8_u32(vdup_n_u32(AV_RN32(src)));
+}
+
+static av_always_inline void store_4(uint8_t *dst, uint8x8_t v)
+{
+    AV_WN32(dst, vget_lane_u32(vreinterpret_u32_u8(v), 0));
+}
+
+static av_always_inline uint16x8_t load_16(const uint8_t *src, int n)
+{
+    const uint16_t *src16 = (const uint16_t *)src;
+    return n == 8 ? vld1q_u16(src16) : vcombine_u16(vld1_u16(src16), vld1_u16(src16));
+}
+
+static av_always_inline void store_16(uint8_t *dst, uint16x8_t v, int n)
+{
+    uint16_t *dst16 = (uint16_t *)dst;
+    if (n == 8)
+        vst1q_u16(dst16, v);
+    else
+        vst1_u16(dst16, vget_low_u16(v));
+}
+
+static av_always_inline int get_pixel(const uint8_t *p, ptrdiff_t x, int depth)
+{
+    return depth > 8 ? ((const uint16_t *)p)[x] : p[x];
+}
+
+static av_always_inline void put_pixel(uint8_t *p, ptrdiff_t x, int v, int depth)
+{
+    if (depth > 8)
+        ((uint16_t *)p)[x] = av_clip_uintp2(v, depth);
+    else
+        p[x] = av_clip_uint8(v);
+}
+
+static av_always_inline uint8x8_t add_offset(uint8x8_t pix, int8x8_t offset)
+{
+    return vqmovun_s16(vaddw_s8(vreinterpretq_s16_u16(vmovl_u8(pix)), offset));
+}
+
+static av_always_inline uint16x8_t add_offset_16(uint16x8_t pix, int8x8_t offset,
+                                                 int depth)
+{
+    int16x8_t sum = vaddw_s8(vreinterpretq_s16_u16(pix), offset);
+
+    sum = vminq_s16(vmaxq_s16(sum, vdupq_n_s16(0)), vdupq_n_s16((1 << depth) - 1));
+    return vreinterpretq_u16_s16(sum);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+///////////////////////////////////////////////////////////////////////////////
+/* n pixels, 8 or 4 */
+static av_always_inline void band_offset(uint8_t *dst, const uint8_t *src,
+                                         int8x8x4_t table, int n, int depth)
+{
+    if (depth > 8) {
+        uint16x8_t pix = load_16(src, n);
+        int8x8_t   idx = vreinterpret_s8_u8(vmovn_u16(vshlq_u16(pix, vdupq_n_s16(5 - depth))));
+        store_16(dst, add_offset_16(pix, vtbl4_s8(table, idx), depth), n);
+    } else {
+        uint8x8_t pix = n == 8 ? vld1_u8(src) : load_4(src);
+        int8x8_t  idx = vreinterpret_s8_u8(vshr_n_u8(pix, 3));
+        uint8x8_t res = add_offset(pix, vtbl4_s8(table, idx));
+        if (n == 8)
+            vst1_u8(dst, res);
+        else
+            store_4(dst, res);
+    }
+}
+
+static av_always_inline void sao_band_filter(uint8_t *dst, uint8_t *src,
+                                             ptrdiff_t stride_dst,
+                                             ptrdiff_t stride_src,
+                                             SAOParams *sao, int width,
+                                             int height, int c_idx, int depth)
+{
+    int16_t *sao_offset_val = sao->offset_val[c_idx];
+    uint8_t sao_left_class  = sao->band_position[c_idx];
+    int ps = depth > 8;
+    int8_t offset_table[32] = { 0 };
+    int8x8x4_t table;
+    int k, x, y;
+
+    for (k = 0; k < 4; k++)
+        offset_table[(k + sao_left_class) & 31] = sao_offset_val[k + 1];
+    for (k = 0; k < 4; k++)
+        table.val[k] = vld1_s8(offset_table + 8 * k);
+
+    for (y = 0; y < height; y++) {
+        for (x = 0; x + 8 <= width; x += 8)
+            band_offset(dst + (x << ps), src + (x << ps), table, 8, depth);
+        if (x + 4 <= width) {
+            band_offset(dst + (x << ps), src + (x << ps), table, 4, depth);
+            x += 4;
+        }
+        for (; x < width; x++) {
+            int pix = get_pixel(src, x, depth);
+            put_pixel(dst, x, pix + offset_table[pix >> (depth - 5)], depth);
+        }
+        dst += stride_dst << ps;
+        src += stride_src << ps;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+///////////////////////////////////////////////////////////////////////////////
+#define CMP(a, b) ((a) > (b) ? 1 : ((a) == (b) ? 0 : -1))
+
+/* 1 where a > b, -1 where a < b, 0 elsewhere */
+static av_always_inline int8x8_t sign_8(uint8x8_t a, uint8x8_t b)
+{
+    return vsub_s8(vreinterpret_s8_u8(vclt_u8(a, b)),
+                   vreinterpret_s8_u8(vcgt_u8(a, b)));
+}
+
+static av_always_inline int8x8_t sign_16(uint16x8_t a, uint16x8_t b)
+{
+    return vsub_s8(vreinterpret_s8_u8(vmovn_u16(vcltq_u16(a, b))),
+                   vreinterpret_s8_u8(vmovn_u16(vcgtq_u16(a, b))));
+}
+
+/* n pixels, 8 or 4, a and b are the offsets of the neighbours in bytes */
+static av_always_inline void edge_offset(uint8_t *dst, const uint8_t *src,
+                                         ptrdiff_t a, ptrdiff_t b,
+                                         int8x8_t table, int n, int depth)
+{
+    int8x8_t two = vdup_n_s8(2);
+
+    if (depth > 8) {
+        uint16x8_t pix = load_16(src, n);
+        int8x8_t   idx = vadd_s8(vadd_s8(sign_16(pix, load_16(src + a, n)),
+                                         sign_16(pix, load_16(src + b, n))), two);
+        store_16(dst, add_offset_16(pix, vtbl1_s8(table, idx), depth), n);
+    } else {
+        uint8x8_t pix = n == 8 ? vld1_u8(src)     : load_4(src);
+        uint8x8_t pa  = n == 8 ? vld1_u8(src + a) : load_4(src + a);
+        uint8x8_t pb  = n == 8 ? vld1_u8(src + b) : load_4(src + b);
+        int8x8_t  idx = vadd_s8(vadd_s8(sign_8(pix, pa), sign_8(pix, pb)), two);
+        uint8x8_t res = add_offset(pix, vtbl1_s8(table, idx));
+        if (n == 8)
+            vst1_u8(dst, res);
+        else
+            store_4(dst, res);
+    }
+}
+
+static av_always_inline void sao_edge_filter(uint8_t *dst, uint8_t *src,
+                                             ptrdiff_t stride_dst,
+                                             ptrdiff_t stride_src,
+                                             SAOParams *sao, int width,
+                                             int height, int c_idx, int depth)
+{
+    static const uint8_t edge_idx[] = { 1, 2, 0, 3, 4 };
+    static const int8_t pos[4][2][2] = {
+        { { -1,  0 }, {  1, 0 } }, // horizontal
+        { {  0, -1 }, {  0, 1 } }, // vertical
+        { { -1, -1 }, {  1, 1 } }, // 45 degree
+        { {  1, -1 }, { -1, 1 } }, // 135 degree
+    };
+    int16_t *sao_offset_val = sao->offset_val[c_idx];
+    uint8_t sao_eo_class    = sao->eo_class[c_idx];
+    ptrdiff_t a_off = pos[sao_eo_class][0][0] + pos[sao_eo_class][0][1] * stride_src;
+    ptrdiff_t b_off = pos[sao_eo_class][1][0] + pos[sao_eo_class][1][1] * stride_src;
+    int ps = depth > 8;
+    ptrdiff_t a_bytes = a_off * (1 << ps);
+    ptrdiff_t b_bytes = b_off * (1 << ps);
+    int8_t offset_table[8] = { 0 };
+    int8x8_t table;
+    int k, x, y;
+
+    for (k = 0; k < 5; k++)
+        offset_table[k] = sao_offset_val[edge_idx[k]];
+    table = vld1_s8(offset_table);
+
+    for (y = 0; y < height; y++) {
+        for (x = 0; x + 8 <= width; x += 8)
+            edge_offset(dst + (x << ps), src + (x << ps), a_bytes, b_bytes,
+                        table, 8, depth);
+        if (x + 4 <= width) {
+            edge_offset(dst + (x << ps), src + (x << ps), a_bytes, b_bytes,
+                        table, 4, depth);
+            x += 4;
+        }
+        for (; x < width; x++) {
+            int pix   = get_pixel(src, x, depth);
+            int diff0 = CMP(pix, get_pixel(src, x + a_off, depth));
+            int diff1 = CMP(pix, get_pixel(src, x + b_off, depth));
+            put_pixel(dst, x, pix + offset_table[2 + diff0 + diff1], depth);
+        }
+        dst += stride_dst << ps;
+        src += stride_src << ps;
+    }
+}
+
+/* picture borders, same as the C version */
+static av_always_inline void sao_edge_borders(uint8_t *dst, uint8_t *src,
+                                              ptrdiff_t stride_dst,
+                                              ptrdiff_t stride_src,
+                                              int offset_val, int sao_eo_class,
+                                              int *borders, int *init_x,
+                                              int *width, int *height, int depth)
+{
+    int x, y;
+
+    if (sao_eo_class != SAO_EO_VERT) {
+        if (borders[0]) {
+            for (y = 0; y < *height; y++)
+                put_pixel(dst, y * stride_dst,
+                          get_pixel(src, y * stride_src, depth) + offset_val, depth);
+            *init_x = 1;
+        }
+        if (borders[2]) {
+            for (y = 0; y < *height; y++)
+                put_pixel(dst, y * stride_dst + *width - 1,
+                          get_pixel(src, y * stride_src + *width - 1, depth) + offset_val,
+                          depth);
+            (*width)--;
+        }
+    }
+    if (sao_eo_class != SAO_EO_HORIZ) {
+        if (borders[1]) {
+            for (x = *init_x; x < *width; x++)
+                put_pixel(dst, x, get_pixel(src, x, depth) + offset_val, depth);
+        }
+        if (borders[3]) {
+            ptrdiff_t y_stride_src = stride_src * (*height - 1);
+            ptrdiff_t y_stride_dst = stride_dst * (*height - 1);
+            for (x = *init_x; x < *width; x++)
+                put_pixel(dst, x + y_stride_dst,
+                          get_pixel(src, x + y_stride_src, depth) + offset_val, depth);
+            (*height)--;
+        }
+    }
+}
+
+#define COPY_PIXEL(dst_x, src_x) put_pixel(dst, dst_x, get_pixel(src, src_x, depth), depth)
+
+static av_always_inline void sao_edge_restore(uint8_t *dst, uint8_t *src,
+                                              ptrdiff_t stride_dst,
+                                              ptrdiff_t stride_src,
+                                              SAOParams *sao, int *borders,
+                                              int width, int height, int c_idx,
+                                              uint8_t *vert_edge, uint8_t *horiz_edge,
+                                              uint8_t *diag_edge, int depth)
+{
+    uint8_t sao_eo_class = sao->eo_class[c_idx];
+    int init_x = 0, init_y = 0;
+    int save_upper_left, save_upper_right, save_lower_right, save_lower_left;
+    int x, y;
+
+    sao_edge_borders(dst, src, stride_dst, stride_src, sao->offset_val[c_idx][0],
+                     sao_eo_class, borders, &init_x, &width, &height, depth);
+
+    save_upper_left  = !diag_edge[0] && sao_eo_class == SAO_EO_135D && !borders[0] && !borders[1];
+    save_upper_right = !diag_edge[1] && sao_eo_class == SAO_EO_45D  && !borders[1] && !borders[2];
+    save_lower_right = !diag_edge[2] && sao_eo_class == SAO_EO_135D && !borders[2] && !borders[3];
+    save_lower_left  = !diag_edge[3] && sao_eo_class == SAO_EO_45D  && !borders[0] && !borders[3];
+
+    // Restore pixels that can't be modified
+    if (vert_edge[0] && sao_eo_class != SAO_EO_VERT) {
+        for (y = init_y + save_upper_left; y < height - save_lower_left; y++)
+            COPY_PIXEL(y * stride_dst, y * stride_src);
+    }
+    if (vert_edge[1] && sao_eo_class != SAO_EO_VERT) {
+        for (y = init_y + save_upper_right; y < height - save_lower_right; y++)
+            COPY_PIXEL(y * stride_dst + width - 1, y * stride_src + width - 1);
+    }
+    if (horiz_edge[0] && sao_eo_class != SAO_EO_HORIZ) {
+        for (x = init_x + save_upper_left; x < width - save_upper_right; x++)
+            COPY_PIXEL(x, x);
+    }
+    if (horiz_edge[1] && sao_eo_class != SAO_EO_HORIZ) {
+        for (x = init_x + save_lower_left; x < width - save_lower_right; x++)
+            COPY_PIXEL((height - 1) * stride_dst + x, (height - 1) * stride_src + x);
+    }
+    if (diag_edge[0] && sao_eo_class == SAO_EO_135D)
+        COPY_PIXEL(0, 0);
+    if (diag_edge[1] && sao_eo_class == SAO_EO_45D)
+        COPY_PIXEL(width - 1, width - 1);
+    if (diag_edge[2] && sao_eo_class == SAO_EO_135D)
+        COPY_PIXEL(stride_dst * (height - 1) + width - 1, stride_src * (height - 1) + width - 1);
+    if (diag_edge[3] && sao_eo_class == SAO_EO_45D)
+        COPY_PIXEL(stride_dst * (height - 1), stride_src * (height - 1));
+}
+
+#define SAO_FILTERS(depth)                                                     \
+void ff_hevc_sao_band_filter_0_neon_ ## depth(uint8_t *dst, uint8_t *src,    \
+                                              ptrdiff_t stride_dst,          \
+                                              ptrdiff_t stride_src,          \
+                                              SAOParams *sao, int *borders,  \
+                                              int width, int height, int c_idx) \
+{                                                                            \
+    int ps = depth > 8;                                                      \
+                                                                             \
+    sao_band_filter(dst, src, stride_dst >> ps, stride_src >> ps, sao,       \
+                    width, height, c_idx, depth);                            \
+}                                                                            \
+                                                                             \
+void ff_hevc_sao_edge_filter_0_neon_ ## depth(uint8_t *dst, uint8_t *src,    \
+                                              ptrdiff_t stride_dst,          \
+                                              ptrdiff_t stride_src,          \
+                                              SAOParams *sao, int *borders,  \
+                                              int width, int height, int c_idx, \
+                                              uint8_t *vert_edge,            \
+                                              uint8_t *horiz_edge,           \
+                                              uint8_t *diag_edge)            \
+{                                                                            \
+    int ps = depth > 8, init_x = 0;                                          \
+                                                                             \
+    stride_dst >>= ps;                                                       \
+    stride_src >>= ps;                                                       \
+    sao_edge_filter(dst, src, stride_dst, stride_src, sao, width, height,    \
+                    c_idx, depth);                                           \
+    sao_edge_borders(dst, src, stride_dst, stride_src,                       \
+                     sao->offset_val[c_idx][0], sao->eo_class[c_idx],        \
+                     borders, &init_x, &width, &height, depth);              \
+}                                                                            \
+                                                                             \
+void ff_hevc_sao_edge_filter_1_neon_ ## depth(uint8_t *dst, uint8_t *src,    \
+                                              ptrdiff_t stride_dst,          \
+                                              ptrdiff_t stride_src,          \
+                                              SAOParams *sao, int *borders,  \
+                                              int width, int height, int c_idx, \
+                                              uint8_t *vert_edge,            \
+                                              uint8_t *horiz_edge,           \
+                                              uint8_t *diag_edge)            \
+{                                                                            \
+    int ps = depth > 8;                                                      \
+                                                                             \
+    stride_dst >>= ps;                                                       \
+    stride_src >>= ps;                                                       \
+    sao_edge_filter(dst, src, stride_dst, stride_src, sao, width, height,    \
+                    c_idx, depth);                                           \
+    sao_edge_restore(dst, src, stride_dst, stride_src, sao, borders,         \
+                     width, height, c_idx, vert_edge, horiz_edge,            \
+                     diag_edge, depth);                                      \
+}
+
+SAO_FILTERS(8)
+SAO_FILTERS(10)
+SAO_FILTERS(12)
+
+#undef COPY_PIXEL
+#undef CMP
@@ -24,6 +24,7 @@
 #include "libavutil/attributes.h"
 #include "libavutil/arm/cpu.h"
 #include "libavcodec/hevcdsp.h"
+#include "libavcodec/arm/hevcdsp_neon.h"
 
 static void (*put_hevc_qpel_neon[4][4])(int16_t *dst, ptrdiff_t dststride, uint8_t *src, ptrdiff_t srcstride,
                                    int height, int width);
@@ -108,12 +109,6 @@ void ff_hevc_put_epel_v_neon_8(int16_t *dst, ptrdiff_t dststride, uint8_t *src,
 void ff_hevc_put_epel_hv_neon_8(int16_t *dst, ptrdiff_t dststride, uint8_t *src,
                                 ptrdiff_t srcstride, int height,
                                 intptr_t mx, intptr_t my, int width);
-void ff_hevc_transform_4x4_add_neon_8(uint8_t *_dst, int16_t *coeffs,
-                                    ptrdiff_t stride);
-void ff_hevc_transform_8x8_add_neon_8(uint8_t *_dst, int16_t *coeffs,
-                                    ptrdiff_t stride);
-void ff_hevc_transform_16x16_add_neon_8(uint8_t *_dst, int16_t *coeffs,
-                                    ptrdiff_t stride);
 
 int ff_hevc_put_qpel_uw_pixels_neon_8(int16_t *dst, ptrdiff_t dststride, uint8_t *_src, ptrdiff_t _srcstride,
                                    int width, int height, int16_t* src2, ptrdiff_t src2stride);
@@ -123,6 +118,8 @@ int ff_hevc_put_qpel_uw_pixels_neon_8(int16_t *dst, ptrdiff_t dststride, uint8_t
 static av_cold void hevcdsp_init_neon(HEVCDSPContext *c, const int bit_depth)
 {
 #if HAVE_NEON
+    ff_hevcdsp_init_neon(c, bit_depth);
+
     if (bit_depth == 8) {
         int x;
         c->hevc_v_loop_filter_luma     = ff_hevc_v_loop_filter_luma_neon;
@@ -185,10 +182,6 @@ static av_cold void hevcdsp_init_neon(HEVCDSPContext *c, const int bit_depth)
        /* c->put_hevc_epel[1][0]         = ff_hevc_put_epel_v_neon_8;
         c->put_hevc_epel[0][1]         = ff_hevc_put_epel_h_neon_8;
         c->put_hevc_epel[1][1]         = ff_hevc_put_epel_hv_neon_8;*/
-	//Fixme compilation error in transform optimizations
-        /* c->transform_add[0]            = ff_hevc_transform_4x4_add_neon_8;
-        c->transform_add[1]            = ff_hevc_transform_8x8_add_neon_8; */
-        //c->transform_add[2]            = ff_hevc_transform_16x16_add_neon_8;
     }
 #endif // HAVE_NEON
 }
@@ -0,0 +1,102 @@
+/*
+ * HEVC NEON intrinsics init, shared by the ARM and AArch64 builds
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavcodec/get_bits.h" /* required for hevcdsp.h GetBitContext */
+#include "libavcodec/hevcdsp.h"
+#include "libavcodec/hevcpred.h"
+#include "libavcodec/arm/hevcdsp_neon.h"
+
+#define SET_MC(tab, pel, dir, v, h, depth)                                                                       \
+    do {                                                                                                         \
+        c->put_hevc_ ## tab[x][v][h]           = ff_hevc_put_hevc_ ## pel ## _ ## dir ## _neon_ ## depth;       \
+        c->put_hevc_ ## tab ## _uni[x][v][h]   = ff_hevc_put_hevc_ ## pel ## _uni_ ## dir ## _neon_ ## depth;   \
+        c->put_hevc_ ## tab ## _bi[x][v][h]    = ff_hevc_put_hevc_ ## pel ## _bi_ ## dir ## _neon_ ## depth;    \
+        c->put_hevc_ ## tab ## _uni_w[x][v][h] = ff_hevc_put_hevc_ ## pel ## _uni_w_ ## dir ## _neon_ ## depth; \
+        c->put_hevc_ ## tab ## _bi_w[x][v][h]  = ff_hevc_put_hevc_ ## pel ## _bi_w_ ## dir ## _neon_ ## depth;  \
+    } while (0)
+
+#define HEVC_DSP_NEON(depth)                                                   \
+    do {                                                                       \
+        c->idct_4x4_luma      = ff_hevc_transform_4x4_luma_neon_ ## depth;     \
+        c->idct[0]            = ff_hevc_transform_4x4_neon_ ## depth;          \
+        c->idct[1]            = ff_hevc_transform_8x8_neon_ ## depth;          \
+        c->idct[2]            = ff_hevc_transform_16x16_neon_ ## depth;        \
+        c->idct[3]            = ff_hevc_transform_32x32_neon_ ## depth;        \
+        c->idct_dc[0]         = ff_hevc_idct_4x4_dc_neon_ ## depth;            \
+        c->idct_dc[1]         = ff_hevc_idct_8x8_dc_neon_ ## depth;            \
+        c->idct_dc[2]         = ff_hevc_idct_16x16_dc_neon_ ## depth;          \
+        c->idct_dc[3]         = ff_hevc_idct_32x32_dc_neon_ ## depth;          \
+        c->transform_add[0]   = ff_hevc_transform_4x4_add_neon_ ## depth;      \
+        c->transform_add[1]   = ff_hevc_transform_8x8_add_neon_ ## depth;      \
+        c->transform_add[2]   = ff_hevc_transform_16x16_add_neon_ ## depth;    \
+        c->transform_add[3]   = ff_hevc_transform_32x32_add_neon_ ## depth;    \
+                                                                               \
+        c->sao_band_filter    = ff_hevc_sao_band_filter_0_neon_ ## depth;      \
+        c->sao_edge_filter[0] = ff_hevc_sao_edge_filter_0_neon_ ## depth;      \
+        c->sao_edge_filter[1] = ff_hevc_sao_edge_filter_1_neon_ ## depth;      \
+                                                                               \
+        for (x = 0; x < 10; x++) {                                             \
+            SET_MC(qpel, pel,  pixels, 0, 0, depth);                           \
+            SET_MC(qpel, qpel, h,      0, 1, depth);                           \
+            SET_MC(qpel, qpel, v,      1, 0, depth);                           \
+            SET_MC(qpel, qpel, hv,     1, 1, depth);                           \
+            SET_MC(epel, pel,  pixels, 0, 0, depth);                           \
+            SET_MC(epel, epel, h,      0, 1, depth);                           \
+            SET_MC(epel, epel, v,      1, 0, depth);                           \
+            SET_MC(epel, epel, hv,     1, 1, depth);                           \
+        }                                                                      \
+    } while (0)
+
+av_cold void ff_hevcdsp_init_neon(HEVCDSPContext *c, const int bit_depth)
+{
+    int x;
+
+    if (bit_depth == 8)
+        HEVC_DSP_NEON(8);
+    else if (bit_depth == 10)
+        HEVC_DSP_NEON(10);
+    else if (bit_depth == 12)
+        HEVC_DSP_NEON(12);
+}
+
+#define HEVC_PRED_NEON(depth)                                                  \
+    do {                                                                       \
+        c->pred_planar[0]  = ff_hevc_pred_planar_0_neon_ ## depth;             \
+        c->pred_planar[1]  = ff_hevc_pred_planar_1_neon_ ## depth;             \
+        c->pred_planar[2]  = ff_hevc_pred_planar_2_neon_ ## depth;             \
+        c->pred_planar[3]  = ff_hevc_pred_planar_3_neon_ ## depth;             \
+        c->pred_dc         = ff_hevc_pred_dc_neon_ ## depth;                   \
+        c->pred_angular[0] = ff_hevc_pred_angular_0_neon_ ## depth;            \
+        c->pred_angular[1] = ff_hevc_pred_angular_1_neon_ ## depth;            \
+        c->pred_angular[2] = ff_hevc_pred_angular_2_neon_ ## depth;            \
+        c->pred_angular[3] = ff_hevc_pred_angular_3_neon_ ## depth;            \
+    } while (0)
+
+av_cold void ff_hevcpred_init_neon(HEVCPredContext *c, const int bit_depth)
+{
+    if (bit_depth == 8)
+        HEVC_PRED_NEON(8);
+    else if (bit_depth == 10)
+        HEVC_PRED_NEON(10);
+    else if (bit_depth == 12)
+        HEVC_PRED_NEON(12);
+}
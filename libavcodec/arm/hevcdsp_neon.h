@@ -0,0 +1,189 @@
+/*
+ * HEVC NEON intrinsics, shared by the ARM and AArch64 builds
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVCODEC_ARM_HEVCDSP_NEON_H
+#define AVCODEC_ARM_HEVCDSP_NEON_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct HEVCDSPContext;
+struct HEVCPredContext;
+struct SAOParams;
+
+/* The kernels exist for 8, 10 and 12 bit, the init functions leave 9 bit
+ * to C. */
+void ff_hevcdsp_init_neon(struct HEVCDSPContext *c, const int bit_depth);
+void ff_hevcpred_init_neon(struct HEVCPredContext *c, const int bit_depth);
+
+///////////////////////////////////////////////////////////////////////////////
+// IDCT
+///////////////////////////////////////////////////////////////////////////////
+#define IDCT_PROTOTYPES(depth)                                                       \
+void ff_hevc_transform_4x4_luma_neon_ ## depth(int16_t *coeffs);                     \
+void ff_hevc_transform_4x4_neon_ ## depth(int16_t *coeffs, int col_limit);           \
+void ff_hevc_transform_8x8_neon_ ## depth(int16_t *coeffs, int col_limit);           \
+void ff_hevc_transform_16x16_neon_ ## depth(int16_t *coeffs, int col_limit);         \
+void ff_hevc_transform_32x32_neon_ ## depth(int16_t *coeffs, int col_limit);         \
+                                                                                     \
+void ff_hevc_idct_4x4_dc_neon_ ## depth(int16_t *coeffs);                            \
+void ff_hevc_idct_8x8_dc_neon_ ## depth(int16_t *coeffs);                            \
+void ff_hevc_idct_16x16_dc_neon_ ## depth(int16_t *coeffs);                          \
+void ff_hevc_idct_32x32_dc_neon_ ## depth(int16_t *coeffs);                          \
+                                                                                     \
+void ff_hevc_transform_4x4_add_neon_ ## depth(uint8_t *dst, int16_t *coeffs, ptrdiff_t stride); \
+void ff_hevc_transform_8x8_add_neon_ ## depth(uint8_t *dst, int16_t *coeffs, ptrdiff_t stride); \
+void ff_hevc_transform_16x16_add_neon_ ## depth(uint8_t *dst, int16_t *coeffs, ptrdiff_t stride); \
+void ff_hevc_transform_32x32_add_neon_ ## depth(uint8_t *dst, int16_t *coeffs, ptrdiff_t stride)
+
+IDCT_PROTOTYPES(8);
+IDCT_PROTOTYPES(10);
+IDCT_PROTOTYPES(12);
+
+///////////////////////////////////////////////////////////////////////////////
+// SAO
+///////////////////////////////////////////////////////////////////////////////
+#define SAO_PROTOTYPES(depth)                                                        \
+void ff_hevc_sao_band_filter_0_neon_ ## depth(uint8_t *dst, uint8_t *src,            \
+                                              ptrdiff_t stride_dst, ptrdiff_t stride_src, \
+                                              struct SAOParams *sao, int *borders,   \
+                                              int width, int height, int c_idx);     \
+void ff_hevc_sao_edge_filter_0_neon_ ## depth(uint8_t *dst, uint8_t *src,            \
+                                              ptrdiff_t stride_dst, ptrdiff_t stride_src, \
+                                              struct SAOParams *sao, int *borders,   \
+                                              int width, int height, int c_idx,      \
+                                              uint8_t *vert_edge, uint8_t *horiz_edge, \
+                                              uint8_t *diag_edge);                   \
+void ff_hevc_sao_edge_filter_1_neon_ ## depth(uint8_t *dst, uint8_t *src,            \
+                                              ptrdiff_t stride_dst, ptrdiff_t stride_src, \
+                                              struct SAOParams *sao, int *borders,   \
+                                              int width, int height, int c_idx,      \
+                                              uint8_t *vert_edge, uint8_t *horiz_edge, \
+                                              uint8_t *diag_edge)
+
+SAO_PROTOTYPES(8);
+SAO_PROTOTYPES(10);
+SAO_PROTOTYPES(12);
+
+///////////////////////////////////////////////////////////////////////////////
+// MC, full sample positions of both qpel and epel
+///////////////////////////////////////////////////////////////////////////////
+void ff_hevc_put_hevc_pel_pixels_neon_8(int16_t *dst, ptrdiff_t dststride,
+                                        uint8_t *src, ptrdiff_t srcstride,
+                                        int height, intptr_t mx, intptr_t my,
+                                        int width);
+void ff_hevc_put_hevc_pel_uni_pixels_neon_8(uint8_t *dst, ptrdiff_t dststride,
+                                            uint8_t *src, ptrdiff_t srcstride,
+                                            int height, intptr_t mx, intptr_t my,
+                                            int width);
+void ff_hevc_put_hevc_pel_bi_pixels_neon_8(uint8_t *dst, ptrdiff_t dststride,
+                                           uint8_t *src, ptrdiff_t srcstride,
+                                           int16_t *src2, ptrdiff_t src2stride,
+                                           int height, intptr_t mx, intptr_t my,
+                                           int width);
+void ff_hevc_put_hevc_pel_uni_w_pixels_neon_8(uint8_t *dst, ptrdiff_t dststride,
+                                              uint8_t *src, ptrdiff_t srcstride,
+                                              int height, int denom, int wx, int ox,
+                                              intptr_t mx, intptr_t my, int width);
+void ff_hevc_put_hevc_pel_bi_w_pixels_neon_8(uint8_t *dst, ptrdiff_t dststride,
+                                             uint8_t *src, ptrdiff_t srcstride,
+                                             int16_t *src2, ptrdiff_t src2stride,
+                                             int height, int denom, int wx0, int wx1,
+                                             int ox0, int ox1, intptr_t mx, intptr_t my,
+                                             int width);
+
+///////////////////////////////////////////////////////////////////////////////
+// MC, fractional sample positions and the full ones above 8 bit
+///////////////////////////////////////////////////////////////////////////////
+#define PUT_HEVC_MC_PROTOTYPES(pel, dir, depth)                                          \
+void ff_hevc_put_hevc_ ## pel ## _ ## dir ## _neon_ ## depth(int16_t *dst, ptrdiff_t dststride, \
+                                                             uint8_t *src, ptrdiff_t srcstride, \
+                                                             int height, intptr_t mx,    \
+                                                             intptr_t my, int width);    \
+void ff_hevc_put_hevc_ ## pel ## _uni_ ## dir ## _neon_ ## depth(uint8_t *dst, ptrdiff_t dststride, \
+                                                                 uint8_t *src, ptrdiff_t srcstride, \
+                                                                 int height, intptr_t mx, \
+                                                                 intptr_t my, int width); \
+void ff_hevc_put_hevc_ ## pel ## _bi_ ## dir ## _neon_ ## depth(uint8_t *dst, ptrdiff_t dststride, \
+                                                                uint8_t *src, ptrdiff_t srcstride, \
+                                                                int16_t *src2, ptrdiff_t src2stride, \
+                                                                int height, intptr_t mx, \
+                                                                intptr_t my, int width); \
+void ff_hevc_put_hevc_ ## pel ## _uni_w_ ## dir ## _neon_ ## depth(uint8_t *dst, ptrdiff_t dststride, \
+                                                                   uint8_t *src, ptrdiff_t srcstride, \
+                                                                   int height, int denom, \
+                                                                   int wx, int ox, intptr_t mx, \
+                                                                   intptr_t my, int width); \
+void ff_hevc_put_hevc_ ## pel ## _bi_w_ ## dir ## _neon_ ## depth(uint8_t *dst, ptrdiff_t dststride, \
+                                                                  uint8_t *src, ptrdiff_t srcstride, \
+                                                                  int16_t *src2, ptrdiff_t src2stride, \
+                                                                  int height, int denom, \
+                                                                  int wx0, int wx1, int ox0, \
+                                                                  int ox1, intptr_t mx,  \
+                                                                  intptr_t my, int width)
+
+#define PUT_HEVC_MC_DEPTH_PROTOTYPES(depth)                                     \
+PUT_HEVC_MC_PROTOTYPES(qpel, h,  depth);                                        \
+PUT_HEVC_MC_PROTOTYPES(qpel, v,  depth);                                        \
+PUT_HEVC_MC_PROTOTYPES(qpel, hv, depth);                                        \
+PUT_HEVC_MC_PROTOTYPES(epel, h,  depth);                                        \
+PUT_HEVC_MC_PROTOTYPES(epel, v,  depth);                                        \
+PUT_HEVC_MC_PROTOTYPES(epel, hv, depth)
+
+PUT_HEVC_MC_DEPTH_PROTOTYPES(8);
+PUT_HEVC_MC_DEPTH_PROTOTYPES(10);
+PUT_HEVC_MC_DEPTH_PROTOTYPES(12);
+
+PUT_HEVC_MC_PROTOTYPES(pel, pixels, 10);
+PUT_HEVC_MC_PROTOTYPES(pel, pixels, 12);
+
+///////////////////////////////////////////////////////////////////////////////
+// Intra prediction
+///////////////////////////////////////////////////////////////////////////////
+#define PRED_PROTOTYPES(depth)                                                       \
+void ff_hevc_pred_planar_0_neon_ ## depth(uint8_t *src, const uint8_t *top,           \
+                                          const uint8_t *left, ptrdiff_t stride);     \
+void ff_hevc_pred_planar_1_neon_ ## depth(uint8_t *src, const uint8_t *top,           \
+                                          const uint8_t *left, ptrdiff_t stride);     \
+void ff_hevc_pred_planar_2_neon_ ## depth(uint8_t *src, const uint8_t *top,           \
+                                          const uint8_t *left, ptrdiff_t stride);     \
+void ff_hevc_pred_planar_3_neon_ ## depth(uint8_t *src, const uint8_t *top,           \
+                                          const uint8_t *left, ptrdiff_t stride);     \
+void ff_hevc_pred_angular_0_neon_ ## depth(uint8_t *src, const uint8_t *top,          \
+                                           const uint8_t *left, ptrdiff_t stride,     \
+                                           int c_idx, int mode);                      \
+void ff_hevc_pred_angular_1_neon_ ## depth(uint8_t *src, const uint8_t *top,          \
+                                           const uint8_t *left, ptrdiff_t stride,     \
+                                           int c_idx, int mode);                      \
+void ff_hevc_pred_angular_2_neon_ ## depth(uint8_t *src, const uint8_t *top,          \
+                                           const uint8_t *left, ptrdiff_t stride,     \
+                                           int c_idx, int mode);                      \
+void ff_hevc_pred_angular_3_neon_ ## depth(uint8_t *src, const uint8_t *top,          \
+                                           const uint8_t *left, ptrdiff_t stride,     \
+                                           int c_idx, int mode);                      \
+void ff_hevc_pred_dc_neon_ ## depth(uint8_t *src, const uint8_t *top,                 \
+                                    const uint8_t *left, ptrdiff_t stride,            \
+                                    int log2_size, int c_idx)
+
+PRED_PROTOTYPES(8);
+PRED_PROTOTYPES(10);
+PRED_PROTOTYPES(12);
+
+#endif // AVCODEC_ARM_HEVCDSP_NEON_H
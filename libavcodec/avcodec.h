@@ -3137,6 +3137,15 @@ typedef struct AVCodecContext {
     void *BL_frame;
     void *BL_avcontext;
     int quality_id;
+
+    /**
+     * Seek target: pictures of packets with a lower pts are not output, and
+     * are not decoded at all when no other picture can reference them.
+     * AV_NOPTS_VALUE when not seeking.
+     * - encoding: unused
+     * - decoding: Set by user.
+     */
+    int64_t seek_pts;
 } AVCodecContext;
 
 AVRational av_codec_get_pkt_timebase         (const AVCodecContext *avctx);
@@ -4364,6 +4373,19 @@ typedef struct AVCodecParserContext {
      * For example, this corresponds to H.264 PicOrderCnt.
      */
     int output_picture_number;
+
+    /**
+     * Parts of a picture that can be decoded in parallel with the active
+     * parameter sets, e.g. CTB rows with HEVC wavefront parallel processing
+     * or tiles. 0 until a picture has been parsed.
+     */
+    int entry_points;
+
+    /**
+     * Number of pictures that may precede a picture in decoding order and
+     * follow it in output order with the active parameter sets.
+     */
+    int reorder_depth;
 } AVCodecParserContext;
 
 typedef struct AVCodecParser {
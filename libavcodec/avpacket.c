@@ -119,15 +119,22 @@ int av_grow_packet(AVPacket *pkt, int grow_by)
         return -1;
 
     new_size = pkt->size + grow_by + FF_INPUT_BUFFER_PADDING_SIZE;
-    if (pkt->buf) {
+    if (pkt->buf && pkt->data == pkt->buf->data &&
+        pkt->buf->size >= new_size && av_buffer_is_writable(pkt->buf)) {
+        /* pooled payloads are rounded up to their size class, see
+         * ff_packet_pool_get() in libavformat */
+    } else if (pkt->buf && pkt->data == pkt->buf->data) {
         int ret = av_buffer_realloc(&pkt->buf, new_size);
         if (ret < 0)
             return ret;
     } else {
-        pkt->buf = av_buffer_alloc(new_size);
-        if (!pkt->buf)
+        /* no buffer, or the payload is a view into a larger one */
+        AVBufferRef *buf = av_buffer_alloc(new_size);
+        if (!buf)
             return AVERROR(ENOMEM);
-        memcpy(pkt->buf->data, pkt->data, FFMIN(pkt->size, pkt->size + grow_by));
+        memcpy(buf->data, pkt->data, FFMIN(pkt->size, pkt->size + grow_by));
+        av_buffer_unref(&pkt->buf);
+        pkt->buf = buf;
 #if FF_API_DESTRUCT_PACKET
 FF_DISABLE_DEPRECATION_WARNINGS
         pkt->destruct = dummy_destruct_packet;
@@ -199,7 +206,7 @@ static int copy_packet_data(AVPacket *pkt, const AVPacket *src, int dup)
         if (!ref)
             return AVERROR(ENOMEM);
         pkt->buf  = ref;
-        pkt->data = ref->data;
+        pkt->data = src->data;
     } else {
         DUP_DATA(pkt->data, src->data, pkt->size, 1, ALLOC_BUF);
     }
@@ -546,11 +553,17 @@ int av_packet_ref(AVPacket *dst, const AVPacket *src)
         if (ret < 0)
             goto fail;
         memcpy(dst->buf->data, src->data, src->size);
-    } else
+        dst->data = dst->buf->data;
+    } else {
         dst->buf = av_buffer_ref(src->buf);
+        if (!dst->buf) {
+            ret = AVERROR(ENOMEM);
+            goto fail;
+        }
+        dst->data = src->data;
+    }
 
     dst->size = src->size;
-    dst->data = dst->buf->data;
     return 0;
 fail:
     av_packet_free_side_data(dst);
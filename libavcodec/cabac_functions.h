@@ -29,6 +29,7 @@
 
 #include <stdint.h>
 
+#include "libavutil/intmath.h"
 #include "cabac.h"
 #include "config.h"
 
@@ -161,6 +162,52 @@ static av_always_inline int get_cabac_bypass_sign(CABACContext *c, int val){
 }
 #endif
 
+#ifndef get_cabac_bypass_run
+/**
+ * Shift k (k >= 1) bypass bins out of low without refilling and append
+ * them to val.
+ */
+static av_always_inline unsigned get_cabac_bypass_run(int *low, int range,
+                                                      int k, unsigned val)
+{
+    int l = *low;
+
+    do {
+        int mask;
+        l   += l;
+        mask = (range - 1 - l) >> 31;
+        l   -= range & mask;
+        val  = (val << 1) - mask;
+    } while (--k);
+    *low = l;
+    return val;
+}
+#endif
+
+/**
+ * Decode n bypass bins, first bin in the most significant position.
+ * The bins are pulled out of low in runs that end on a refill boundary,
+ * so the bytestream is checked at most once per CABAC_BITS bins.
+ * Refilling only touches the low CABAC_BITS + 1 bits of low, which never
+ * take part in the comparison against range, so it can be deferred to
+ * the end of each run.
+ */
+static av_always_inline unsigned get_cabac_bypass_bins(CABACContext *c, int n)
+{
+    const int range = c->range << (CABAC_BITS + 1);
+    unsigned val = 0;
+
+    while (n > 0) {
+        int k = FFMIN(n, CABAC_BITS - ff_ctz(c->low));
+
+        n  -= k;
+        val = get_cabac_bypass_run(&c->low, range, k, val);
+        if (!(c->low & CABAC_MASK))
+            refill(c);
+    }
+    return val;
+}
+
 /**
  *
  * @return the number of bytes read or 0 if no end
@@ -47,6 +47,7 @@ static void calc_md5(uint8_t *md5, uint8_t* src, int stride, int width, int heig
 static int compare_md5(uint8_t *md5_in1, uint8_t *md5_in2);
 static void display_md5(int poc, uint8_t md5[3][16]);
 static void printf_ref_pic_list(HEVCContext *s);
+static int hevc_decode_extradata(HEVCContext *s, const uint8_t *buf, int length);
 
 
 
@@ -120,9 +121,6 @@ static int pic_arrays_init(HEVCContext *s, const HEVCSPS *sps)
     int ctb_count        = sps->ctb_width * sps->ctb_height;
     int min_pu_size      = sps->min_pu_width * sps->min_pu_height;
 
-    s->bs_width  = (width  >> 2);
-    s->bs_height = (height >> 2);
-
     s->sao           = av_mallocz_array(ctb_count, sizeof(*s->sao));
     s->deblock       = av_mallocz_array(ctb_count, sizeof(*s->deblock));
     s->dynamic_alloc += sizeof(*s->sao);
@@ -213,6 +211,119 @@ fail:
     return AVERROR(ENOMEM);
 }
 
+/* exchange the arrays in use with those parked in a */
+static void pic_arrays_swap(HEVCContext *s, HEVCPicArrays *a)
+{
+    FFSWAP(AVFrame *,      s->tmp_frame,          a->tmp_frame);
+    FFSWAP(AVBufferPool *, s->tab_mvf_pool,       a->tab_mvf_pool);
+    FFSWAP(AVBufferPool *, s->rpl_tab_pool,       a->rpl_tab_pool);
+    FFSWAP(SAOParams *,    s->sao,                a->sao);
+    FFSWAP(DBParams *,     s->deblock,            a->deblock);
+    FFSWAP(int8_t *,       s->qp_y_tab,           a->qp_y_tab);
+    FFSWAP(uint8_t *,      s->horizontal_bs,      a->horizontal_bs);
+    FFSWAP(uint8_t *,      s->vertical_bs,        a->vertical_bs);
+    FFSWAP(int32_t *,      s->tab_slice_address,  a->tab_slice_address);
+    FFSWAP(uint8_t *,      s->skip_flag,          a->skip_flag);
+    FFSWAP(uint8_t *,      s->tab_ct_depth,       a->tab_ct_depth);
+    FFSWAP(uint8_t *,      s->tab_ipm,            a->tab_ipm);
+    FFSWAP(uint8_t *,      s->cbf_luma,           a->cbf_luma);
+    FFSWAP(uint8_t *,      s->is_pcm,             a->is_pcm);
+    FFSWAP(uint8_t *,      s->filter_slice_edges, a->filter_slice_edges);
+#ifdef SVC_EXTENSION
+    FFSWAP(short *,        s->buffer_frame[0],    a->buffer_frame[0]);
+    FFSWAP(short *,        s->buffer_frame[1],    a->buffer_frame[1]);
+    FFSWAP(short *,        s->buffer_frame[2],    a->buffer_frame[2]);
+    FFSWAP(uint8_t *,      s->is_upsampled,       a->is_upsampled);
+#endif
+#if PARALLEL_SLICE
+    FFSWAP(uint8_t *,      s->decoded_rows,       a->decoded_rows);
+#endif
+}
+
+static int pic_arrays_match(const HEVCPicArrays *a, const HEVCSPS *sps)
+{
+    return a->width            == sps->width            &&
+           a->height           == sps->height           &&
+           a->output_width     == sps->output_width     &&
+           a->output_height    == sps->output_height    &&
+           a->log2_ctb_size    == sps->log2_ctb_size    &&
+           a->log2_min_cb_size == sps->log2_min_cb_size &&
+           a->log2_min_tb_size == sps->log2_min_tb_size &&
+           a->pix_fmt          == sps->pix_fmt;
+}
+
+/* free a parked set, leaving the arrays in use untouched */
+static void pic_arrays_evict(HEVCContext *s, HEVCPicArrays *a)
+{
+    if (!a->last_used)
+        return;
+    pic_arrays_swap(s, a);
+    pic_arrays_free(s);
+    av_frame_free(&s->tmp_frame);
+    pic_arrays_swap(s, a);
+    a->last_used = 0;
+}
+
+/**
+ * Make the arrays for the geometry of sps the ones in use. The previous set
+ * is parked, and a set seen before is taken back from the least recently
+ * used cache instead of being allocated again.
+ */
+static int pic_arrays_select(HEVCContext *s, const HEVCSPS *sps)
+{
+    HEVCPicArrays *a = NULL;
+    int i, ret;
+
+    s->bs_width  = sps->width  >> 2;
+    s->bs_height = sps->height >> 2;
+
+    if (s->cur_pic_arrays) {
+        if (pic_arrays_match(s->cur_pic_arrays, sps)) {
+            s->cur_pic_arrays->last_used = ++s->pic_arrays_clock;
+            return 0;
+        }
+        pic_arrays_swap(s, s->cur_pic_arrays);
+        s->cur_pic_arrays = NULL;
+    }
+
+    for (i = 0; i < MAX_PIC_ARRAYS; i++)
+        if (s->pic_arrays[i].last_used && pic_arrays_match(&s->pic_arrays[i], sps))
+            a = &s->pic_arrays[i];
+
+    if (a) {
+        pic_arrays_swap(s, a);
+    } else {
+        a = &s->pic_arrays[0];
+        for (i = 1; i < MAX_PIC_ARRAYS; i++)
+            if (s->pic_arrays[i].last_used < a->last_used)
+                a = &s->pic_arrays[i];
+        pic_arrays_evict(s, a);
+
+        ret = pic_arrays_init(s, sps);
+        if (ret < 0)
+            return ret;
+        a->width            = sps->width;
+        a->height           = sps->height;
+        a->output_width     = sps->output_width;
+        a->output_height    = sps->output_height;
+        a->log2_ctb_size    = sps->log2_ctb_size;
+        a->log2_min_cb_size = sps->log2_min_cb_size;
+        a->log2_min_tb_size = sps->log2_min_tb_size;
+        a->pix_fmt          = sps->pix_fmt;
+    }
+
+    if (!s->tmp_frame) {
+        s->tmp_frame = av_frame_alloc();
+        if (!s->tmp_frame) {
+            pic_arrays_free(s);
+            return AVERROR(ENOMEM);
+        }
+    }
+    a->last_used      = ++s->pic_arrays_clock;
+    s->cur_pic_arrays = a;
+    return 0;
+}
+
 static void pred_weight_table(HEVCContext *s, GetBitContext *gb)
 {
     int i = 0;
@@ -387,8 +498,7 @@ static int set_sps(HEVCContext *s, const HEVCSPS *sps)
     int ret;
     unsigned int num = 0, den = 0;
 
-    pic_arrays_free(s);
-    ret = pic_arrays_init(s, sps);
+    ret = pic_arrays_select(s, sps);
     if (ret < 0)
         goto fail;
 
@@ -416,13 +526,20 @@ static int set_sps(HEVCContext *s, const HEVCSPS *sps)
         s->avctx->colorspace      = AVCOL_SPC_UNSPECIFIED;
     }
 
-    ff_hevc_pred_init(&s->hpc,     sps->bit_depth);
-    ff_hevc_dsp_init (&s->hevcdsp, sps->bit_depth);
-    ff_videodsp_init (&s->vdsp,    sps->bit_depth);
+    if (s->dsp_bit_depth != sps->bit_depth) {
+        ff_hevc_pred_init(&s->hpc,     sps->bit_depth);
+        ff_hevc_dsp_init (&s->hevcdsp, sps->bit_depth);
+        ff_videodsp_init (&s->vdsp,    sps->bit_depth);
+        s->dsp_bit_depth = sps->bit_depth;
+    }
 
+    /* the SAO frame is kept with the arrays of its geometry */
     if (sps->sao_enabled) {
-        av_frame_unref(s->tmp_frame);
-        ret = get_buffer_sao(s, s->tmp_frame, sps);
+        if (!s->tmp_frame->buf[0]) {
+            ret = get_buffer_sao(s, s->tmp_frame, sps);
+            if (ret < 0)
+                goto fail;
+        }
         s->sao_frame = s->tmp_frame;
     }
 
@@ -500,6 +617,14 @@ static int set_sps(HEVCContext *s, const HEVCSPS *sps)
     return 0;
 fail:
     pic_arrays_free(s);
+    /* the SAO buffer has the geometry of the freed arrays, a later
+     * pic_arrays_select() must not keep it or park it with another set */
+    if (s->tmp_frame)
+        av_frame_unref(s->tmp_frame);
+    if (s->cur_pic_arrays) {
+        s->cur_pic_arrays->last_used = 0;
+        s->cur_pic_arrays = NULL;
+    }
     s->sps = NULL;
     return ret;
 }
@@ -515,6 +640,47 @@ static int is_sps_exist(HEVCContext *s, const HEVCSPS* last_sps)
     return 0;
 }
 
+/* the current picture comes before the seek target in output order */
+static int before_seek_target(HEVCContext *s)
+{
+    const AVPacket *pkt = s->avctx->internal->pkt;
+
+    return s->avctx->seek_pts != AV_NOPTS_VALUE && pkt &&
+           pkt->pts != AV_NOPTS_VALUE && pkt->pts < s->avctx->seek_pts;
+}
+
+/*
+ * A sub-layer non-reference picture of the highest decoded sub-layer is
+ * referenced by no other picture. Base layer pictures of layered streams
+ * are still needed for inter-layer prediction.
+ */
+static int is_droppable(HEVCContext *s, int nal_unit_type, int temporal_id)
+{
+    if (nal_unit_type > NAL_RASL_R || (nal_unit_type & 1) || !s->sps)
+        return 0;
+    if (temporal_id != FFMIN(s->sps->max_sub_layers - 1, s->temporal_layer_id))
+        return 0;
+    return s->decoder_id || s->vps->vps_max_layers == 1;
+}
+
+static int skip_for_seek(HEVCContext *s)
+{
+    return is_droppable(s, s->nal_unit_type, s->temporal_id) &&
+           before_seek_target(s);
+}
+
+static int skip_loop_filter(HEVCContext *s)
+{
+    enum AVDiscard skip = s->avctx->skip_loop_filter;
+
+    return  skip >= AVDISCARD_ALL                                      ||
+           (skip >= AVDISCARD_NONKEY   && !IS_IRAP(s))                 ||
+           (skip >= AVDISCARD_NONINTRA && s->sh.slice_type != I_SLICE) ||
+           (skip >= AVDISCARD_BIDIR    && s->sh.slice_type == B_SLICE) ||
+           (skip >= AVDISCARD_NONREF   &&
+            is_droppable(s, s->nal_unit_type, s->temporal_id));
+}
+
 static int hls_slice_header(HEVCContext *s)
 {
     GetBitContext *gb   = &s->HEVClc->gb;
@@ -551,7 +717,9 @@ static int hls_slice_header(HEVCContext *s)
     sh->first_slice_in_pic_flag   = first_slice_in_pic_flag;
 
     print_cabac("first_slice_segment_in_pic_flag", sh->first_slice_in_pic_flag);
-    if ((IS_IDR(s) || IS_BLA(s)) && sh->first_slice_in_pic_flag) {
+    /* without the pictures in between, each IRAP starts a new sequence */
+    if ((IS_IDR(s) || IS_BLA(s) || (IS_IRAP(s) && IS_IRAP_ONLY(s))) &&
+        sh->first_slice_in_pic_flag) {
         s->seq_decode = (s->seq_decode + 1) & 0xff;
         s->max_ra     = INT_MAX;
         if (IS_IDR(s))
@@ -712,6 +880,8 @@ else
             sh->pic_output_flag = get_bits1(gb);
             print_cabac("pic_output_flag", sh->pic_output_flag);
         }
+        if (before_seek_target(s))
+            sh->pic_output_flag = 0;
 
         if (s->sps->separate_colour_plane_flag) {
             sh->colour_plane_id = get_bits(gb, 2);
@@ -778,6 +948,12 @@ else
                 print_cabac("slice_temporal_mvp_enable_flag", sh->slice_temporal_mvp_enabled_flag);
             } else
                 sh->slice_temporal_mvp_enabled_flag = 0;
+
+            /* the references kept for the leading pictures were dropped */
+            if (IS_IRAP(s) && IS_IRAP_ONLY(s)) {
+                sh->short_term_rps        = NULL;
+                sh->long_term_rps.nb_refs = 0;
+            }
         } else {
             s->sh.short_term_rps = NULL;
             s->poc               = 0;
@@ -989,6 +1165,10 @@ else
         } else {
             sh->slice_loop_filter_across_slices_enabled_flag = s->pps->seq_loop_filter_across_slices_enabled_flag;
         } 
+
+        sh->skip_loop_filter = skip_loop_filter(s);
+        if (sh->skip_loop_filter)
+            sh->disable_deblocking_filter_flag = 1;
     } else if (!s->slice_initialized) {
         av_log(s->avctx, AV_LOG_ERROR, "Independent slice segment missing.\n");
         return AVERROR_INVALIDDATA;
@@ -1171,6 +1351,11 @@ static void hls_sao_param(HEVCContext *s, int rx, int ry)
             sao->offset_val[c_idx][i + 1] <<= log2_sao_offset_scale;
         }
     }
+
+    /* the offsets are parsed all the same to keep CABAC in sync */
+    if (s->sh.skip_loop_filter)
+        for (c_idx = 0; c_idx < 3; c_idx++)
+            sao->type_idx[c_idx] = SAO_NOT_APPLIED;
 }
 
 #undef SET_SAO
@@ -1301,15 +1486,14 @@ static int hls_transform_unit(HEVCContext *s, int x0, int y0,
                         ptrdiff_t stride = s->frame->linesize[1];
                         int hshift = s->sps->hshift[1];
                         int vshift = s->sps->vshift[1];
-                        int16_t *coeffs_y = lc->tu.coeffs[0];
                         int16_t *coeffs =   lc->tu.coeffs[1];
                         int size = 1 << log2_trafo_size_c;
 
                         uint8_t *dst = &s->frame->data[1][(y0 >> vshift) * stride +
                                                               ((x0 >> hshift) << s->sps->pixel_shift)];
-                        for (i = 0; i < (size * size); i++) {
-                            coeffs[i] = ((lc->tu.res_scale_val * coeffs_y[i]) >> 3);
-                        }
+                        memset(coeffs, 0, size * size * sizeof(int16_t));
+                        s->hevcdsp.cross_component_pred(coeffs, lc->tu.coeffs[0],
+                                                        lc->tu.res_scale_val, log2_trafo_size_c);
                         s->hevcdsp.transform_add[log2_trafo_size-2](dst, coeffs, stride);
                     }
             }
@@ -1330,15 +1514,14 @@ static int hls_transform_unit(HEVCContext *s, int x0, int y0,
                         ptrdiff_t stride = s->frame->linesize[2];
                         int hshift = s->sps->hshift[2];
                         int vshift = s->sps->vshift[2];
-                        int16_t *coeffs_y = lc->tu.coeffs[0];
                         int16_t *coeffs =   lc->tu.coeffs[1];
                         int size = 1 << log2_trafo_size_c;
 
                         uint8_t *dst = &s->frame->data[2][(y0 >> vshift) * stride +
                                                           ((x0 >> hshift) << s->sps->pixel_shift)];
-                        for (i = 0; i < (size * size); i++) {
-                            coeffs[i] = ((lc->tu.res_scale_val * coeffs_y[i]) >> 3);
-                        }
+                        memset(coeffs, 0, size * size * sizeof(int16_t));
+                        s->hevcdsp.cross_component_pred(coeffs, lc->tu.coeffs[0],
+                                                        lc->tu.res_scale_val, log2_trafo_size_c);
                         s->hevcdsp.transform_add[log2_trafo_size-2](dst, coeffs, stride);
                     }
             }
@@ -3066,24 +3249,11 @@ static int hevc_frame_start(HEVCContext *s)
     AVFrame *cur_frame;
     av_log(s->avctx, AV_LOG_DEBUG, "frame start %d\n", s->decoder_id);
 
-
-    memset(s->horizontal_bs, 0, s->bs_width * s->bs_height);
-    memset(s->vertical_bs,   0, s->bs_width * s->bs_height);
-    memset(s->cbf_luma,      0, s->sps->min_tb_width * s->sps->min_tb_height);
-    memset(s->tab_slice_address, -1, pic_size_in_ctb * sizeof(*s->tab_slice_address));
-#if PARALLEL_SLICE
-    memset(s->decoded_rows, 0,s->sps->ctb_height);
-#endif
     s->is_decoded        = 0;
     s->first_nal_type    = s->nal_unit_type;
 
-    if (s->pps->tiles_enabled_flag)
-        lc->end_of_tiles_x = s->pps->column_width[0] << s->sps->log2_ctb_size;
 #ifdef SVC_EXTENSION
     if (s->nuh_layer_id) {
-#if ACTIVE_PU_UPSAMPLING
-        memset (s->is_upsampled, 0, s->sps->ctb_width * s->sps->ctb_height);
-#endif
         if (s->el_decoder_el_exist ){
             ff_thread_await_il_progress(s->avctx, s->poc_id, &s->avctx->BL_frame);
         } else
@@ -3100,9 +3270,6 @@ static int hevc_frame_start(HEVCContext *s)
         ret = ff_hevc_set_new_iter_layer_ref(s, &s->EL_frame, s->poc);
         if (ret < 0)
             goto fail;
-#if !ACTIVE_PU_UPSAMPLING || ACTIVE_BOTH_FRAME_AND_PU
-        s->hevcdsp.upsample_base_layer_frame(s->EL_frame, s->BL_frame->frame, s->buffer_frame, &s->sps->scaled_ref_layer_window[s->vps->m_refLayerId[s->nuh_layer_id][0]], &s->up_filter_inf, 1);
-#endif
     }
 #endif
     ret = ff_hevc_set_new_ref(s, &s->frame, s->poc);
@@ -3131,8 +3298,33 @@ static int hevc_frame_start(HEVCContext *s)
     if (ret < 0)
         goto fail;
 
+    /* Everything the next frame thread copies is known now: the DPB state
+     * after RPS marking, bumping and output. What follows only touches this
+     * thread's own tables, so do it outside the serial section. */
     ff_thread_finish_setup(s->avctx);
 
+    memset(s->horizontal_bs, 0, s->bs_width * s->bs_height);
+    memset(s->vertical_bs,   0, s->bs_width * s->bs_height);
+    memset(s->cbf_luma,      0, s->sps->min_tb_width * s->sps->min_tb_height);
+    memset(s->tab_slice_address, -1, pic_size_in_ctb * sizeof(*s->tab_slice_address));
+#if PARALLEL_SLICE
+    memset(s->decoded_rows, 0,s->sps->ctb_height);
+#endif
+
+    if (s->pps->tiles_enabled_flag)
+        lc->end_of_tiles_x = s->pps->column_width[0] << s->sps->log2_ctb_size;
+#ifdef SVC_EXTENSION
+    if (s->nuh_layer_id) {
+#if ACTIVE_PU_UPSAMPLING
+        memset (s->is_upsampled, 0, s->sps->ctb_width * s->sps->ctb_height);
+#endif
+#if !ACTIVE_PU_UPSAMPLING || ACTIVE_BOTH_FRAME_AND_PU
+        if (!s->il_ref_aliased)
+            s->hevcdsp.upsample_base_layer_frame(s->EL_frame, s->BL_frame->frame, s->buffer_frame, &s->sps->scaled_ref_layer_window[s->vps->m_refLayerId[s->nuh_layer_id][0]], &s->up_filter_inf, 1);
+#endif
+    }
+#endif
+
     return 0;
 
 fail:
@@ -3246,8 +3438,8 @@ static int decode_nal_unit(HEVCContext *s, const uint8_t *nal, int length)
             }
         }
 
-        if ((s->nal_unit_type == NAL_RASL_R || s->nal_unit_type == NAL_RASL_N) &&
-            s->poc <= s->max_ra) {
+        if (((s->nal_unit_type == NAL_RASL_R || s->nal_unit_type == NAL_RASL_N) &&
+             s->poc <= s->max_ra) || skip_for_seek(s)) {
             s->is_decoded = 0;
                 return 0;
         } else {
@@ -3454,8 +3646,8 @@ static int decode_nal_unit_slice(AVCodecContext *avctxt, void *input_ctb_row, in
                 }
             }
 
-            if ((s->nal_unit_type == NAL_RASL_R || s->nal_unit_type == NAL_RASL_N) &&
-                s->poc <= s->max_ra) {
+            if (((s->nal_unit_type == NAL_RASL_R || s->nal_unit_type == NAL_RASL_N) &&
+                 s->poc <= s->max_ra) || skip_for_seek(s)) {
                 s->is_decoded = 0;
                 return 0;
             } else {
@@ -3579,6 +3771,32 @@ fail:
 #endif
 /* FIXME: This is adapted from ff_h264_decode_nal, avoiding duplication
  * between these functions would be nice. */
+/*
+ * Decide from the NAL unit header alone whether a VCL NAL unit is dropped by
+ * avctx->skip_frame or the temporal layer limit, so it is neither unescaped
+ * nor parsed. BIDIR and NONINTRA need the slice type and act as NONREF.
+ * Only single layer streams are handled: the layer decoders of a layered
+ * stream count each other's pictures.
+ */
+static int skip_nal_unit(HEVCContext *s, const uint8_t *buf)
+{
+    int nal_unit_type = (buf[0] >> 1) & 0x3f;
+    int nuh_layer_id  = ((buf[0] & 1) << 5) | (buf[1] >> 3);
+    int temporal_id   = (buf[1] & 7) - 1;
+
+    if (nal_unit_type >= NAL_VPS || nuh_layer_id || s->decoder_id ||
+        !s->vps || s->vps->vps_max_layers > 1)
+        return 0;
+    if (temporal_id > s->temporal_layer_id ||
+        s->avctx->skip_frame >= AVDISCARD_ALL)
+        return 1;
+    if (s->avctx->skip_frame >= AVDISCARD_NONKEY)
+        return nal_unit_type < NAL_BLA_W_LP;
+    if (s->avctx->skip_frame >= AVDISCARD_NONREF)
+        return is_droppable(s, nal_unit_type, temporal_id);
+    return 0;
+}
+
 int ff_hevc_extract_rbsp(HEVCContext *s, const uint8_t *src, int length,
                          HEVCNAL *nal)
 {
@@ -3745,6 +3963,19 @@ static int decode_nal_units(HEVCContext *s, const uint8_t *buf, int length)
         if (!s->is_nalff)
             extract_length = length;
 
+        if (extract_length >= 2 && skip_nal_unit(s, buf)) {
+            if (!s->is_nalff) {
+                uint32_t state = -1;
+                const uint8_t *next = avpriv_find_start_code(buf + 2, buf + length, &state);
+
+                if ((state & 0xFFFFFF00) == 0x100)
+                    extract_length = next - 4 - buf;
+            }
+            buf    += extract_length;
+            length -= extract_length;
+            continue;
+        }
+
         if (s->nals_allocated < s->nb_nals + 1) {
             int new_size = s->nals_allocated + 1;
             HEVCNAL *tmp = av_realloc_array(s->nals, new_size, sizeof(*tmp));
@@ -3968,7 +4199,8 @@ static int verify_md5(HEVCContext *s, AVFrame *frame)
 static int hevc_decode_frame(AVCodecContext *avctx, void *data, int *got_output,
                              AVPacket *avpkt)
 {
-    int ret;
+    int ret, new_extradata_size;
+    uint8_t *new_extradata;
     HEVCContext *s = avctx->priv_data;
 
     if (!avpkt->size) {
@@ -3982,6 +4214,16 @@ static int hevc_decode_frame(AVCodecContext *avctx, void *data, int *got_output,
         *got_output = ret;
         return 0;
     }
+
+    /* a new stream configuration, e.g. after the decoder was re-armed */
+    new_extradata = av_packet_get_side_data(avpkt, AV_PKT_DATA_NEW_EXTRADATA,
+                                            &new_extradata_size);
+    if (new_extradata && new_extradata_size > 0) {
+        ret = hevc_decode_extradata(s, new_extradata, new_extradata_size);
+        if (ret < 0)
+            return ret;
+    }
+
     s->ref = NULL;
 #if PARALLEL_SLICE
     ff_thread_set_slice_flag(avctx, 0);
@@ -4039,6 +4281,14 @@ static av_cold int hevc_decode_free(AVCodecContext *avctx)
     HEVCLocalContext *lc = s->HEVClc;
     int i;
 
+    if (s->ps_cache_lookups)
+        av_log(avctx, AV_LOG_VERBOSE,
+               "%d of %d parameter sets were repeats and not parsed again\n",
+               s->ps_cache_hits, s->ps_cache_lookups);
+
+    for (i = 0; i < MAX_PIC_ARRAYS; i++)
+        if (&s->pic_arrays[i] != s->cur_pic_arrays)
+            pic_arrays_evict(s, &s->pic_arrays[i]);
     pic_arrays_free(s);
 
     av_freep(&s->md5_ctx);
@@ -4182,6 +4432,28 @@ fail:
     return AVERROR(ENOMEM);
 }
 
+/**
+ * Make dst reference the same parameter sets as src. Parameter set buffers
+ * are never modified once they are in a list, so entries that already share
+ * their buffer are left alone.
+ */
+static int hevc_update_ps_list(AVBufferRef **dst, AVBufferRef **src, int nb)
+{
+    int i;
+
+    for (i = 0; i < nb; i++) {
+        if (dst[i] && src[i] && dst[i]->buffer == src[i]->buffer)
+            continue;
+        av_buffer_unref(&dst[i]);
+        if (src[i]) {
+            dst[i] = av_buffer_ref(src[i]);
+            if (!dst[i])
+                return AVERROR(ENOMEM);
+        }
+    }
+    return 0;
+}
+
 static int hevc_update_thread_context(AVCodecContext *dst,
                                       const AVCodecContext *src)
 {
@@ -4196,40 +4468,37 @@ static int hevc_update_thread_context(AVCodecContext *dst,
     }
 
     for (i = 0; i < FF_ARRAY_ELEMS(s->DPB); i++) {
-        ff_hevc_unref_frame(s, &s->DPB[i], ~0);
-        if (s0->DPB[i].frame->buf[0] && &s0->DPB[i] != s0->inter_layer_ref ) {
-            ret = hevc_ref_frame(s, &s->DPB[i], &s0->DPB[i]);
-            if (ret < 0)
-                return ret;
-        }
-    }
+        HEVCFrame *dst = &s->DPB[i];
+        HEVCFrame *src = &s0->DPB[i];
 
-    for (i = 0; i < FF_ARRAY_ELEMS(s->vps_list); i++) {
-        av_buffer_unref(&s->vps_list[i]);
-        if (s0->vps_list[i]) {
-            s->vps_list[i] = av_buffer_ref(s0->vps_list[i]);
-            if (!s->vps_list[i])
-                return AVERROR(ENOMEM);
+        if (!src->frame->buf[0] || src == s0->inter_layer_ref) {
+            ff_hevc_unref_frame(s, dst, ~0);
+            continue;
         }
-    }
-
-    for (i = 0; i < FF_ARRAY_ELEMS(s->sps_list); i++) {
-        av_buffer_unref(&s->sps_list[i]);
-        if (s0->sps_list[i]) {
-            s->sps_list[i] = av_buffer_ref(s0->sps_list[i]);
-            if (!s->sps_list[i])
-                return AVERROR(ENOMEM);
+        /* this thread already holds the picture, only its marking and
+         * POC may have changed since */
+        if (dst->frame->buf[0] &&
+            dst->frame->buf[0]->buffer == src->frame->buf[0]->buffer) {
+            dst->poc      = src->poc;
+            dst->flags    = src->flags;
+            dst->sequence = src->sequence;
+            continue;
         }
+        ff_hevc_unref_frame(s, dst, ~0);
+        ret = hevc_ref_frame(s, dst, src);
+        if (ret < 0)
+            return ret;
     }
 
-    for (i = 0; i < FF_ARRAY_ELEMS(s->pps_list); i++) {
-        av_buffer_unref(&s->pps_list[i]);
-        if (s0->pps_list[i]) {
-            s->pps_list[i] = av_buffer_ref(s0->pps_list[i]);
-            if (!s->pps_list[i])
-                return AVERROR(ENOMEM);
-        }
-    }
+    ret = hevc_update_ps_list(s->vps_list, s0->vps_list, FF_ARRAY_ELEMS(s->vps_list));
+    if (ret < 0)
+        return ret;
+    ret = hevc_update_ps_list(s->sps_list, s0->sps_list, FF_ARRAY_ELEMS(s->sps_list));
+    if (ret < 0)
+        return ret;
+    ret = hevc_update_ps_list(s->pps_list, s0->pps_list, FF_ARRAY_ELEMS(s->pps_list));
+    if (ret < 0)
+        return ret;
 
     s->seq_decode           = s0->seq_decode;
     s->seq_output           = s0->seq_output;
@@ -4258,17 +4527,15 @@ static int hevc_update_thread_context(AVCodecContext *dst,
     return 0;
 }
 
-static int hevc_decode_extradata(HEVCContext *s)
+static int hevc_decode_extradata(HEVCContext *s, const uint8_t *buf, int length)
 {
     AVCodecContext *avctx = s->avctx;
     GetByteContext gb;
     int ret;
 
-    bytestream2_init(&gb, avctx->extradata, avctx->extradata_size);
+    bytestream2_init(&gb, buf, length);
 
-    if (avctx->extradata_size > 3 &&
-        (avctx->extradata[0] || avctx->extradata[1] ||
-         avctx->extradata[2] > 1)) {
+    if (length > 3 && (buf[0] || buf[1] || buf[2] > 1)) {
         /* It seems the extradata is encoded as hvcC format.
          * Temporarily, we support configurationVersion==0 until 14496-15 3rd
          * is finalized. When finalized, configurationVersion will be 1 and we
@@ -4314,7 +4581,7 @@ static int hevc_decode_extradata(HEVCContext *s)
         s->nal_length_size = nal_len_size;
     } else {
         s->is_nalff = 0;
-        ret = decode_nal_units(s, avctx->extradata, avctx->extradata_size);
+        ret = decode_nal_units(s, buf, length);
         if (ret < 0)
             return ret;
     }
@@ -4337,7 +4604,7 @@ static av_cold int hevc_decode_init(AVCodecContext *avctx)
     s->picture_struct = 0;
 
     if (avctx->extradata_size > 0 && avctx->extradata) {
-        ret = hevc_decode_extradata(s);
+        ret = hevc_decode_extradata(s, avctx->extradata, avctx->extradata_size);
         if (ret < 0) {
             hevc_decode_free(avctx);
             return ret;
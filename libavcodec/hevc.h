@@ -56,6 +56,7 @@
 #define MAX_VPS_COUNT 16
 #define MAX_SPS_COUNT 32
 #define MAX_PPS_COUNT 256
+#define MAX_PS_RAW_SIZE 4096
 #define MAX_SHORT_TERM_RPS_COUNT 64
 #define MAX_CU_SIZE 128
 
@@ -101,6 +102,9 @@
 #define IS_BLA(s) ((s)->nal_unit_type == NAL_BLA_W_RADL || (s)->nal_unit_type == NAL_BLA_W_LP || \
                    (s)->nal_unit_type == NAL_BLA_N_LP)
 #define IS_IRAP(s) ((s)->nal_unit_type >= 16 && (s)->nal_unit_type <= 23)
+/* skip_frame drops all pictures but the IRAP ones, see skip_nal_unit() */
+#define IS_IRAP_ONLY(s) ((s)->avctx->skip_frame >= AVDISCARD_NONKEY && !(s)->decoder_id && \
+                         (s)->vps && (s)->vps->vps_max_layers == 1)
 
 enum ScalabilityType
 {
@@ -455,6 +459,16 @@ typedef struct RepFormat
 } RepFormat;
 #endif
 
+/**
+ * Raw bytes of a parameter set NAL unit, kept with the parsed set so that
+ * a repeat of the same NAL unit is recognised without parsing it again.
+ */
+typedef struct HEVCPSRaw {
+    uint32_t hash;
+    int      size;          ///< 0 if the NAL unit was too large to keep
+    uint8_t  data[MAX_PS_RAW_SIZE];
+} HEVCPSRaw;
+
 typedef struct HEVCVPS {
     uint8_t vps_temporal_id_nesting_flag;
     int vps_max_layers;
@@ -650,6 +664,7 @@ typedef struct HEVCVPS {
     unsigned int         m_vpsMatCoeff[16];
 #endif
 
+    HEVCPSRaw raw;
 } HEVCVPS;
 
 typedef struct ScalingList {
@@ -765,6 +780,9 @@ typedef struct HEVCSPS {
 #ifdef REF_IDX_MFM
     int set_mfm_enabled_flag;
 #endif
+
+    HEVCPSRaw raw;
+    AVBufferRef *vps_buf;   ///< VPS this SPS was parsed against
 } HEVCSPS;
 
 typedef struct HEVCPPS {
@@ -841,6 +859,8 @@ typedef struct HEVCPPS {
     int *min_tb_addr_zs;    ///< MinTbAddrZS
     int *min_tb_addr_zs_tab;///< MinTbAddrZS
 
+    HEVCPSRaw raw;
+    AVBufferRef *sps_buf;   ///< SPS this PPS was parsed against
 } HEVCPPS;
 
 typedef struct SliceHeader {
@@ -877,6 +897,7 @@ typedef struct SliceHeader {
 
     uint8_t cabac_init_flag;
     uint8_t disable_deblocking_filter_flag; ///< slice_header_disable_deblocking_filter_flag
+    uint8_t skip_loop_filter;               ///< deblocking and SAO dropped by avctx->skip_loop_filter
     uint8_t slice_loop_filter_across_slices_enabled_flag;
     uint8_t collocated_list;
 
@@ -1096,6 +1117,48 @@ typedef struct HEVCLocalContext {
     
 } HEVCLocalContext;
 
+#define MAX_PIC_ARRAYS 4
+
+/**
+ * Picture-size dependent arrays and pools for one SPS geometry. The set in
+ * use lives in the HEVCContext fields, the others are parked here so that
+ * switching back to a known geometry allocates nothing.
+ */
+typedef struct HEVCPicArrays {
+    unsigned last_used;     ///< 0 if the entry is empty
+    int width;
+    int height;
+    int output_width;
+    int output_height;
+    int log2_ctb_size;
+    int log2_min_cb_size;
+    int log2_min_tb_size;
+    enum AVPixelFormat pix_fmt;
+
+    AVFrame *tmp_frame;
+    AVBufferPool *tab_mvf_pool;
+    AVBufferPool *rpl_tab_pool;
+    SAOParams *sao;
+    DBParams *deblock;
+    int8_t  *qp_y_tab;
+    uint8_t *horizontal_bs;
+    uint8_t *vertical_bs;
+    int32_t *tab_slice_address;
+    uint8_t *skip_flag;
+    uint8_t *tab_ct_depth;
+    uint8_t *tab_ipm;
+    uint8_t *cbf_luma;
+    uint8_t *is_pcm;
+    uint8_t *filter_slice_edges;
+#ifdef SVC_EXTENSION
+    short   *buffer_frame[3];
+    uint8_t *is_upsampled;
+#endif
+#if PARALLEL_SLICE
+    uint8_t *decoded_rows;
+#endif
+} HEVCPicArrays;
+
 typedef struct HEVCContext {
     const AVClass *c;  // needed by private avoptions
     AVCodecContext *avctx;
@@ -1117,6 +1180,8 @@ typedef struct HEVCContext {
     AVBufferRef *vps_list[MAX_VPS_COUNT];
     AVBufferRef *sps_list[MAX_SPS_COUNT];
     AVBufferRef *pps_list[MAX_PPS_COUNT];
+    int ps_cache_lookups;   ///< parameter set NAL units received
+    int ps_cache_hits;      ///< of which were repeats of a stored set
 
     AVBufferPool *tab_mvf_pool;
     AVBufferPool *rpl_tab_pool;
@@ -1124,6 +1189,10 @@ typedef struct HEVCContext {
     SAOParams *sao;
     DBParams *deblock;
 
+    HEVCPicArrays pic_arrays[MAX_PIC_ARRAYS];
+    HEVCPicArrays *cur_pic_arrays; ///< entry whose arrays are in use
+    unsigned pic_arrays_clock;
+
     ///< candidate references for the current frame
     RefPicList rps[5+2]; // 2 for inter layer reference pictures
 
@@ -1149,6 +1218,7 @@ typedef struct HEVCContext {
     HEVCDSPContext hevcdsp;
     VideoDSPContext vdsp;
     BswapDSPContext bdsp;
+    int dsp_bit_depth;      ///< bit depth hpc, hevcdsp and vdsp are set up for
     int8_t  *qp_y_tab;
     uint8_t *horizontal_bs;
     uint8_t *vertical_bs;
@@ -1215,6 +1285,7 @@ typedef struct HEVCContext {
     uint8_t         el_decoder_el_exist; // wheither the el exist or not at the el decoder
     uint8_t         el_decoder_bl_exist;
     uint8_t     *is_upsampled;
+    uint8_t     il_ref_aliased; ///< inter_layer_ref shares the BL_frame buffers
 #endif
     int temporal_layer_id;
     int decoder_id;
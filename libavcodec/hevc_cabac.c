@@ -614,12 +614,7 @@ int ff_hevc_sao_type_idx_decode(HEVCContext *s)
 
 uint8_t ff_hevc_sao_band_position_decode(HEVCContext *s)
 {
-    int i;
-    int value = get_cabac_bypass(&s->HEVClc->cc);
-
-    for (i = 0; i < 4; i++)
-        value = (value << 1) | get_cabac_bypass(&s->HEVClc->cc);
-    return value;
+    return get_cabac_bypass_bins(&s->HEVClc->cc, 5);
 }
 
 uint8_t ff_hevc_sao_offset_abs_decode(HEVCContext *s)
@@ -639,9 +634,7 @@ uint8_t ff_hevc_sao_offset_sign_decode(HEVCContext *s)
 
 uint8_t ff_hevc_sao_eo_class_decode(HEVCContext *s)
 {
-    int ret = get_cabac_bypass(&s->HEVClc->cc) << 1;
-    ret    |= get_cabac_bypass(&s->HEVClc->cc);
-    return ret;
+    return get_cabac_bypass_bins(&s->HEVClc->cc, 2);
 }
 
 int ff_hevc_end_of_slice_flag_decode(HEVCContext *s)
@@ -688,8 +681,7 @@ int ff_hevc_cu_qp_delta_abs(HEVCContext *s)
         if (k == CABAC_MAX_BIN)
             av_log(s->avctx, AV_LOG_ERROR, "CABAC_MAX_BIN : %d\n", k);
 
-        while (k--)
-            suffix_val += get_cabac_bypass(&s->HEVClc->cc) << k;
+        suffix_val += get_cabac_bypass_bins(&s->HEVClc->cc, k);
     }
     return prefix_val + suffix_val;
 }
@@ -796,23 +788,15 @@ int ff_hevc_mpm_idx_decode(HEVCContext *s)
 
 int ff_hevc_rem_intra_luma_pred_mode_decode(HEVCContext *s)
 {
-    int i;
-    int value = get_cabac_bypass(&s->HEVClc->cc);
-
-    for (i = 0; i < 4; i++)
-        value = (value << 1) | get_cabac_bypass(&s->HEVClc->cc);
-    return value;
+    return get_cabac_bypass_bins(&s->HEVClc->cc, 5);
 }
 
 int ff_hevc_intra_chroma_pred_mode_decode(HEVCContext *s)
 {
-    int ret;
     if (!GET_CABAC(elem_offset[INTRA_CHROMA_PRED_MODE]))
         return 4;
 
-    ret  = get_cabac_bypass(&s->HEVClc->cc) << 1;
-    ret |= get_cabac_bypass(&s->HEVClc->cc);
-    return ret;
+    return get_cabac_bypass_bins(&s->HEVClc->cc, 2);
 }
 
 int ff_hevc_merge_idx_decode(HEVCContext *s)
@@ -888,8 +872,7 @@ static av_always_inline int mvd_decode(HEVCContext *s)
     }
     if (k == CABAC_MAX_BIN)
         av_log(s->avctx, AV_LOG_ERROR, "CABAC_MAX_BIN : %d\n", k);
-    while (k--)
-        ret += get_cabac_bypass(&s->HEVClc->cc) << k;
+    ret += get_cabac_bypass_bins(&s->HEVClc->cc, k);
     return get_cabac_bypass_sign(&s->HEVClc->cc, -ret);
 }
 
@@ -970,13 +953,9 @@ static av_always_inline void last_significant_coeff_xy_prefix_decode(HEVCContext
 static av_always_inline int last_significant_coeff_suffix_decode(HEVCContext *s,
                                                  int last_significant_coeff_prefix)
 {
-    int i;
     int length = (last_significant_coeff_prefix >> 1) - 1;
-    int value = get_cabac_bypass(&s->HEVClc->cc);
 
-    for (i = 1; i < length; i++)
-        value = (value << 1) | get_cabac_bypass(&s->HEVClc->cc);
-    return value;
+    return get_cabac_bypass_bins(&s->HEVClc->cc, FFMAX(length, 1));
 }
 
 static av_always_inline int significant_coeff_group_flag_decode(HEVCContext *s, int c_idx, int ctx_cg)
@@ -1021,20 +1000,17 @@ static av_always_inline int coeff_abs_level_remaining_decode(HEVCContext *s, int
     int prefix = 0;
     int suffix = 0;
     int last_coeff_abs_level_remaining;
-    int i;
 
     while (prefix < CABAC_MAX_BIN && get_cabac_bypass(&s->HEVClc->cc))
         prefix++;
     if (prefix == CABAC_MAX_BIN)
         av_log(s->avctx, AV_LOG_ERROR, "CABAC_MAX_BIN : %d\n", prefix);
     if (prefix < 3) {
-        for (i = 0; i < rc_rice_param; i++)
-            suffix = (suffix << 1) | get_cabac_bypass(&s->HEVClc->cc);
+        suffix = get_cabac_bypass_bins(&s->HEVClc->cc, rc_rice_param);
         last_coeff_abs_level_remaining = (prefix << rc_rice_param) + suffix;
     } else {
         int prefix_minus3 = prefix - 3;
-        for (i = 0; i < prefix_minus3 + rc_rice_param; i++)
-            suffix = (suffix << 1) | get_cabac_bypass(&s->HEVClc->cc);
+        suffix = get_cabac_bypass_bins(&s->HEVClc->cc, prefix_minus3 + rc_rice_param);
         last_coeff_abs_level_remaining = (((1 << prefix_minus3) + 3 - 1)
                                               << rc_rice_param) + suffix;
     }
@@ -1043,12 +1019,7 @@ static av_always_inline int coeff_abs_level_remaining_decode(HEVCContext *s, int
 
 static av_always_inline int coeff_sign_flag_decode(HEVCContext *s, uint8_t nb)
 {
-    int i;
-    int ret = 0;
-
-    for (i = 0; i < nb; i++)
-        ret = (ret << 1) | get_cabac_bypass(&s->HEVClc->cc);
-    return ret;
+    return get_cabac_bypass_bins(&s->HEVClc->cc, nb);
 }
 
 void ff_hevc_hls_residual_coding(HEVCContext *s, int x0, int y0,
@@ -1552,13 +1523,9 @@ void ff_hevc_hls_residual_coding(HEVCContext *s, int x0, int y0,
             }
         }
     }
-    if (lc->tu.cross_pf) {
-        int16_t *coeffs_y = lc->tu.coeffs[0];
-
-        for (i = 0; i < (trafo_size * trafo_size); i++) {
-            coeffs[i] = coeffs[i] + ((lc->tu.res_scale_val * coeffs_y[i]) >> 3);
-        }
-    }
+    if (lc->tu.cross_pf)
+        s->hevcdsp.cross_component_pred(coeffs, lc->tu.coeffs[0],
+                                        lc->tu.res_scale_val, log2_trafo_size);
     s->hevcdsp.transform_add[log2_trafo_size-2](dst, coeffs, stride);
 }
 
@@ -342,14 +342,56 @@ static int get_pcm(HEVCContext *s, int x, int y)
                     (tc_offset >> 1 << 1),                              \
                     0, MAX_QP + DEFAULT_INTRA_TC_OFFSET)]
 
+/* blocks of 8 samples along a CTB edge, the horizontal ones start 8 samples
+ * left of the CTB */
+#define MAX_EDGE_BLOCKS (MAX_PB_SIZE / 8 + 1)
+
+/* Filter one luma edge whose parameters were all derived beforehand, in a
+ * single call when the DSP has a whole edge function. Otherwise the 8 line
+ * one is used per block, or the C one for blocks with PCM or transquant
+ * bypass samples, which the optimized 8 line functions do not handle. */
+static void loop_filter_luma_edge(HEVCContext *s, uint8_t *src, int vertical,
+                                  int *beta, int *tc, uint8_t *no_p, uint8_t *no_q,
+                                  int nb_blocks)
+{
+    ptrdiff_t stride = s->frame->linesize[LUMA];
+    int i;
+
+    if (vertical && s->hevcdsp.hevc_v_loop_filter_luma_edge) {
+        s->hevcdsp.hevc_v_loop_filter_luma_edge(src, stride, beta, tc, no_p, no_q, nb_blocks);
+        return;
+    }
+    if (!vertical && s->hevcdsp.hevc_h_loop_filter_luma_edge) {
+        s->hevcdsp.hevc_h_loop_filter_luma_edge(src, stride, beta, tc, no_p, no_q, nb_blocks);
+        return;
+    }
+
+    for (i = 0; i < nb_blocks; i++) {
+        uint8_t *pix = vertical ? src + 8 * i * stride : src + (8 * i << s->sps->pixel_shift);
+        int pcm      = no_p[2 * i] | no_p[2 * i + 1] | no_q[2 * i] | no_q[2 * i + 1];
+
+        if (!tc[2 * i] && !tc[2 * i + 1])
+            continue;
+        if (vertical && pcm)
+            s->hevcdsp.hevc_v_loop_filter_luma_c(pix, stride, beta[i], tc + 2 * i, no_p + 2 * i, no_q + 2 * i);
+        else if (vertical)
+            s->hevcdsp.hevc_v_loop_filter_luma(pix, stride, beta[i], tc + 2 * i, no_p + 2 * i, no_q + 2 * i);
+        else if (pcm)
+            s->hevcdsp.hevc_h_loop_filter_luma_c(pix, stride, beta[i], tc + 2 * i, no_p + 2 * i, no_q + 2 * i);
+        else
+            s->hevcdsp.hevc_h_loop_filter_luma(pix, stride, beta[i], tc + 2 * i, no_p + 2 * i, no_q + 2 * i);
+    }
+}
+
 static void deblocking_filter_CTB(HEVCContext *s, int x0, int y0)
 {
     uint8_t *src;
-    int x, y;
+    int x, y, i;
     int chroma;
-    int c_tc[2], tc[2], beta;
-    uint8_t no_p[2] = { 0 };
-    uint8_t no_q[2] = { 0 };
+    int c_tc[2];
+    int tc[2 * MAX_EDGE_BLOCKS], beta[MAX_EDGE_BLOCKS];
+    uint8_t no_p[2 * MAX_EDGE_BLOCKS] = { 0 };
+    uint8_t no_q[2 * MAX_EDGE_BLOCKS] = { 0 };
 
     int log2_ctb_size = s->sps->log2_ctb_size;
     int x_end, x_end2, y_end;
@@ -383,41 +425,31 @@ static void deblocking_filter_CTB(HEVCContext *s, int x0, int y0)
     beta_offset = cur_beta_offset;
 
     // vertical filtering luma
-    for (y = y0; y < y_end; y += 8) {
-        for (x = x0 ? x0 : 8; x < x_end; x += 8) {
+    for (x = x0 ? x0 : 8; x < x_end; x += 8) {
+        int filter = 0;
+        for (y = y0, i = 0; y < y_end; y += 8, i++) {
             const int bs0 = s->vertical_bs[(x +  y      * s->bs_width) >> 2];
             const int bs1 = s->vertical_bs[(x + (y + 4) * s->bs_width) >> 2];
+            tc[2 * i]     = 0;
+            tc[2 * i + 1] = 0;
             if (bs0 || bs1) {
                 const int qp = (get_qPy(s, x - 1, y)     + get_qPy(s, x, y)     + 1) >> 1;
 
-                beta    = betatable[av_clip(qp + beta_offset, 0, MAX_QP)];
-                tc[0]   = bs0 ? TC_CALC(qp, bs0) : 0;
-                tc[1]   = bs1 ? TC_CALC(qp, bs1) : 0;
-                src     = &s->frame->data[LUMA][y * s->frame->linesize[LUMA] + (x << s->sps->pixel_shift)];
+                beta[i]       = betatable[av_clip(qp + beta_offset, 0, MAX_QP)];
+                tc[2 * i]     = bs0 ? TC_CALC(qp, bs0) : 0;
+                tc[2 * i + 1] = bs1 ? TC_CALC(qp, bs1) : 0;
+                filter       |= tc[2 * i] | tc[2 * i + 1];
                 if (pcmf) {
-                    no_p[0] = get_pcm(s, x - 1, y);
-                    no_p[1] = get_pcm(s, x - 1, y + 4);
-                    no_q[0] = get_pcm(s, x, y);
-                    no_q[1] = get_pcm(s, x, y + 4);
-
-                    if (!no_p[0] &&
-                        !no_p[1] &&
-                        !no_q[0] &&
-                        !no_q[1]) {
-                        s->hevcdsp.hevc_v_loop_filter_luma(src,
-                                                           s->frame->linesize[LUMA],
-                                                           beta, tc, no_p, no_q);
-                    } else {
-                        s->hevcdsp.hevc_v_loop_filter_luma_c(src,
-                                                             s->frame->linesize[LUMA],
-                                                             beta, tc, no_p, no_q);
-                    }
-                } else
-                    s->hevcdsp.hevc_v_loop_filter_luma(src,
-                                                       s->frame->linesize[LUMA],
-                                                       beta, tc, no_p, no_q);
+                    no_p[2 * i]     = get_pcm(s, x - 1, y);
+                    no_p[2 * i + 1] = get_pcm(s, x - 1, y + 4);
+                    no_q[2 * i]     = get_pcm(s, x, y);
+                    no_q[2 * i + 1] = get_pcm(s, x, y + 4);
+                }
             }
         }
+        if (filter)
+            loop_filter_luma_edge(s, &s->frame->data[LUMA][y0 * s->frame->linesize[LUMA] + (x << s->sps->pixel_shift)],
+                                  1, beta, tc, no_p, no_q, i);
     }
 
     // vertical filtering chroma
@@ -482,41 +514,33 @@ static void deblocking_filter_CTB(HEVCContext *s, int x0, int y0)
     if (x_end != s->sps->width)
         x_end -= 8;
     for (y = y0 ? y0 : 8; y < y_end; y += 8) {
+        int filter = 0;
         beta_offset = x0 ? left_beta_offset : cur_beta_offset;
-        for (x = x0 ? x0 - 8 : 0; x < x_end; x += 8) {
+        for (x = x0 ? x0 - 8 : 0, i = 0; x < x_end; x += 8, i++) {
             const int bs0 = s->horizontal_bs[( x      + y * s->bs_width) >> 2];
             const int bs1 = s->horizontal_bs[((x + 4) + y * s->bs_width) >> 2];
+            tc[2 * i]     = 0;
+            tc[2 * i + 1] = 0;
             if (bs0 || bs1) {
                 const int qp = (get_qPy(s, x, y - 1)     + get_qPy(s, x, y)     + 1) >> 1;
 
-                beta    = betatable[av_clip(qp + beta_offset, 0, MAX_QP)];
-                tc[0]   = bs0 ? TC_CALC(qp, bs0) : 0;
-                tc[1]   = bs1 ? TC_CALC(qp, bs1) : 0;
-                src     = &s->frame->data[LUMA][y * s->frame->linesize[LUMA] + (x << s->sps->pixel_shift)];
+                beta[i]       = betatable[av_clip(qp + beta_offset, 0, MAX_QP)];
+                tc[2 * i]     = bs0 ? TC_CALC(qp, bs0) : 0;
+                tc[2 * i + 1] = bs1 ? TC_CALC(qp, bs1) : 0;
+                filter       |= tc[2 * i] | tc[2 * i + 1];
                 if (pcmf) {
-                    no_p[0] = get_pcm(s, x, y - 1);
-                    no_p[1] = get_pcm(s, x + 4, y - 1);
-                    no_q[0] = get_pcm(s, x, y);
-                    no_q[1] = get_pcm(s, x + 4, y);
-                    if (!no_p[0] &&
-                        !no_p[1] &&
-                        !no_q[0] &&
-                        !no_q[1]) {
-                        s->hevcdsp.hevc_h_loop_filter_luma(src,
-                                                             s->frame->linesize[LUMA],
-                                                             beta, tc, no_p, no_q);
-                    } else {
-                        s->hevcdsp.hevc_h_loop_filter_luma_c(src,
-                                                           s->frame->linesize[LUMA],
-                                                           beta, tc, no_p, no_q);
-                    }
-                } else
-                    s->hevcdsp.hevc_h_loop_filter_luma(src,
-                                                       s->frame->linesize[LUMA],
-                                                       beta, tc, no_p, no_q);
+                    no_p[2 * i]     = get_pcm(s, x, y - 1);
+                    no_p[2 * i + 1] = get_pcm(s, x + 4, y - 1);
+                    no_q[2 * i]     = get_pcm(s, x, y);
+                    no_q[2 * i + 1] = get_pcm(s, x + 4, y);
+                }
             }
             beta_offset = cur_beta_offset;
         }
+        x = x0 ? x0 - 8 : 0;
+        if (filter)
+            loop_filter_luma_edge(s, &s->frame->data[LUMA][y * s->frame->linesize[LUMA] + (x << s->sps->pixel_shift)],
+                                  0, beta, tc, no_p, no_q, i);
     }
 
     // horizontal filtering chroma
@@ -1181,9 +1205,10 @@ static void upsample_block_luma(HEVCContext *s, HEVCFrame *ref0, int x0, int y0)
     int ePbH = y0 + ctb_size > el_height ? el_height - y0 : ctb_size;
 
     if (s->up_filter_inf.idx == SNR) { /* x1 quality (SNR) scalability */
-        copy_block (s->BL_frame->frame->data[0] + y0 * bl_stride + x0,
-                    ref0->frame->data[0] + y0 * el_stride + x0,
-                    bl_stride, el_stride, ePbH, ePbW );
+        if (!s->il_ref_aliased) /* aliased references already hold the BL samples */
+            copy_block (s->BL_frame->frame->data[0] + y0 * bl_stride + x0,
+                        ref0->frame->data[0] + y0 * el_stride + x0,
+                        bl_stride, el_stride, ePbH, ePbW );
     } else { /* spatial scalability */
         int bl_edge_bottom, bl_edge_right, ret;
         int bPbW = ((( ePbW + 1 )*s->up_filter_inf.scaleXLum + s->up_filter_inf.addXLum) >> 12) >> 4; /*    FIXME: check if this method is correct  */
@@ -1251,10 +1276,11 @@ static void upsample_block_mc(HEVCContext *s, HEVCFrame *ref0, int x0, int y0) {
     int el_stride = ref0->frame->linesize[1];
 
     if (s->up_filter_inf.idx == SNR) {
-        for (cr = 1; cr <= 2; cr++)
-            copy_block(s->BL_frame->frame->data[cr] + y0 * bl_stride + x0,
-                       ref0->frame->data[cr] + y0 * el_stride + x0,
-                       bl_stride, el_stride, ePbH, ePbW );
+        if (!s->il_ref_aliased)
+            for (cr = 1; cr <= 2; cr++)
+                copy_block(s->BL_frame->frame->data[cr] + y0 * bl_stride + x0,
+                           ref0->frame->data[cr] + y0 * el_stride + x0,
+                           bl_stride, el_stride, ePbH, ePbW );
     } else {
         int bl_edge_right, bl_edge_bottom;
         int bPbW = ((( ePbW + 1 ) * s->up_filter_inf.scaleXLum + s->up_filter_inf.addXLum) >> 12)  >> 4;    /*    FIXME: check if this method is correct  */
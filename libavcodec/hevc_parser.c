@@ -194,6 +194,16 @@ static inline int parse_nal_units(AVCodecParserContext *s, AVCodecContext *avctx
                 h->vps = (HEVCVPS*)h->vps_list[h->sps->vps_id]->data;
             }
 
+            if (!h->nuh_layer_id) {
+                if (h->pps->entropy_coding_sync_enabled_flag)
+                    s->entry_points = h->sps->ctb_height;
+                else if (h->pps->tiles_enabled_flag)
+                    s->entry_points = h->pps->num_tile_columns * h->pps->num_tile_rows;
+                else
+                    s->entry_points = 1;
+                s->reorder_depth = h->sps->temporal_layer[h->sps->max_sub_layers - 1].num_reorder_pics;
+            }
+
             if (!sh->first_slice_in_pic_flag) {
                 int slice_address_length;
 
@@ -23,6 +23,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include "libavutil/crc.h"
 #include "libavutil/imgutils.h"
 #include "golomb.h"
 #include "hevc.h"
@@ -1094,14 +1095,56 @@ static void parse_vps_extension (HEVCContext *s, HEVCVPS *vps)  {
 #endif
 }
 
+static uint32_t ps_raw_hash(const GetBitContext *gb)
+{
+    return av_crc(av_crc_get_table(AV_CRC_32_IEEE), 0, gb->buffer,
+                  gb->buffer_end - gb->buffer);
+}
+
+/* the whole NAL unit is compared, header included, since the parsing
+ * depends on nuh_layer_id */
+static int ps_raw_equal(const HEVCPSRaw *raw, const GetBitContext *gb,
+                        uint32_t hash)
+{
+    int size = gb->buffer_end - gb->buffer;
+
+    return raw->size == size && raw->hash == hash &&
+           !memcmp(raw->data, gb->buffer, size);
+}
+
+static void ps_raw_set(HEVCPSRaw *raw, const GetBitContext *gb, uint32_t hash)
+{
+    int size = gb->buffer_end - gb->buffer;
+
+    if (size > sizeof(raw->data))
+        return;
+    raw->hash = hash;
+    raw->size = size;
+    memcpy(raw->data, gb->buffer, size);
+}
+
 int ff_hevc_decode_nal_vps(HEVCContext *s)
 {
     int i,j;
     GetBitContext *gb = &s->HEVClc->gb;
     int vps_id = 0;
     HEVCVPS *vps;
-    AVBufferRef *vps_buf = av_buffer_allocz(sizeof(*vps));
+    AVBufferRef *vps_buf;
+    uint32_t hash = ps_raw_hash(gb);
     print_cabac(" \n --- parse vps --- \n ", s->nuh_layer_id);
+
+    /* the id is part of the compared bytes, so a match is the set stored
+     * under that id */
+    s->ps_cache_lookups++;
+    for (i = 0; i < MAX_VPS_COUNT; i++) {
+        if (s->vps_list[i] &&
+            ps_raw_equal(&((HEVCVPS*)s->vps_list[i]->data)->raw, gb, hash)) {
+            s->ps_cache_hits++;
+            return 0;
+        }
+    }
+
+    vps_buf = av_buffer_allocz(sizeof(*vps));
     if (!vps_buf)
         return AVERROR(ENOMEM);
     vps = (HEVCVPS*)vps_buf->data;
@@ -1217,8 +1260,13 @@ int ff_hevc_decode_nal_vps(HEVCContext *s)
     }
 #endif
 
+    ps_raw_set(&vps->raw, gb, hash);
+
+    /* the raw bytes are not part of the comparison, a VPS with the same
+     * content keeps the current one and the SPSes parsed against it */
     if (s->vps_list[vps_id] &&
-        !memcmp(s->vps_list[vps_id]->data, vps_buf->data, vps_buf->size)) {
+        !memcmp(s->vps_list[vps_id]->data, vps_buf->data,
+                offsetof(HEVCVPS, raw))) {
         av_buffer_unref(&vps_buf);
         av_log(s->avctx, AV_LOG_DEBUG, "ignore VPS duplicated\n");
     } else {
@@ -1517,6 +1565,14 @@ static void parseSPSExtension( HEVCContext *s, HEVCSPS *sps )
 }
 #endif
 
+static void hevc_sps_free(void *opaque, uint8_t *data)
+{
+    HEVCSPS *sps = (HEVCSPS*)data;
+
+    av_buffer_unref(&sps->vps_buf);
+    av_freep(&sps);
+}
+
 int ff_hevc_decode_nal_sps(HEVCContext *s)
 {
     const AVPixFmtDescriptor *desc;
@@ -1529,11 +1585,33 @@ int ff_hevc_decode_nal_sps(HEVCContext *s)
     print_cabac(" \n --- parse sps --- \n ", s->nuh_layer_id);
     HEVCSPS *sps;
     HEVCVPS *vps;
-    AVBufferRef *sps_buf = av_buffer_allocz(sizeof(*sps));
+    AVBufferRef *sps_buf;
+    uint32_t hash = ps_raw_hash(gb);
+
+    /* a repeat only matches if the VPS it was parsed against is still the
+     * current one for its id */
+    s->ps_cache_lookups++;
+    for (i = 0; i < MAX_SPS_COUNT; i++) {
+        if (s->sps_list[i]) {
+            const HEVCSPS *old = (HEVCSPS*)s->sps_list[i]->data;
+            if (ps_raw_equal(&old->raw, gb, hash) &&
+                s->vps_list[old->vps_id] &&
+                s->vps_list[old->vps_id]->data == old->vps_buf->data) {
+                s->ps_cache_hits++;
+                return 0;
+            }
+        }
+    }
 
-    if ( !sps_buf )
+    sps = av_mallocz(sizeof(*sps));
+    if (!sps)
+        return AVERROR(ENOMEM);
+    sps_buf = av_buffer_create((uint8_t *)sps, sizeof(*sps),
+                               hevc_sps_free, NULL, 0);
+    if (!sps_buf) {
+        av_freep(&sps);
         return AVERROR(ENOMEM);
-    sps = (HEVCSPS*)sps_buf->data;
+    }
     sps->chroma_array_type = sps->chroma_format_idc = 1; //FIXME shouldn't it be passing from BL
     av_log(s->avctx, AV_LOG_DEBUG, "Decoding SPS\n");
 
@@ -1553,6 +1631,11 @@ int ff_hevc_decode_nal_sps(HEVCContext *s)
         goto err;
     }
     vps = ((HEVCVPS*)s->vps_list[sps->vps_id]->data);
+    sps->vps_buf = av_buffer_ref(s->vps_list[sps->vps_id]);
+    if (!sps->vps_buf) {
+        ret = AVERROR(ENOMEM);
+        goto err;
+    }
     if (s->nuh_layer_id ==0) {
         sps->max_sub_layers = get_bits(gb, 3) + 1;
         print_cabac("sps_max_sub_layers_minus1", sps->max_sub_layers-1);
@@ -2041,11 +2124,17 @@ int ff_hevc_decode_nal_sps(HEVCContext *s)
                av_get_pix_fmt_name(sps->pix_fmt));
     }
 
+    ps_raw_set(&sps->raw, gb, hash);
+
     /* check if this is a repeat of an already parsed SPS, then keep the
      * original one.
-     * otherwise drop all PPSes that depend on it */
+     * otherwise drop all PPSes that depend on it.
+     * The raw bytes and the VPS reference are not part of the comparison,
+     * but the original is only kept if it refers to the current VPS. */
     if (s->sps_list[sps_id] &&
-        !memcmp(s->sps_list[sps_id]->data, sps_buf->data, sps_buf->size)) {
+        !memcmp(s->sps_list[sps_id]->data, sps_buf->data,
+                offsetof(HEVCSPS, raw)) &&
+        ((HEVCSPS*)s->sps_list[sps_id]->data)->vps_buf->data == sps->vps_buf->data) {
         av_buffer_unref(&sps_buf);
     } else {
         av_buffer_unref(&s->sps_list[sps_id]);
@@ -2070,6 +2159,7 @@ static void hevc_pps_free(void *opaque, uint8_t *data)
     av_freep(&pps->tile_pos_rs);
     av_freep(&pps->tile_id);
     av_freep(&pps->min_tb_addr_zs_tab);
+    av_buffer_unref(&pps->sps_buf);
 
     av_freep(&pps);
 }
@@ -2152,8 +2242,26 @@ int ff_hevc_decode_nal_pps(HEVCContext *s)
     int pps_id = 0;
 
     AVBufferRef *pps_buf;
-    HEVCPPS *pps = av_mallocz(sizeof(*pps));
+    HEVCPPS *pps;
+    uint32_t hash = ps_raw_hash(gb);
     print_cabac(" --- parse pps --- ", s->nuh_layer_id);
+
+    /* a repeat only matches if the SPS it was parsed against is still the
+     * current one for its id; the stored set keeps its derived tables */
+    s->ps_cache_lookups++;
+    for (i = 0; i < MAX_PPS_COUNT; i++) {
+        if (s->pps_list[i]) {
+            const HEVCPPS *old = (HEVCPPS*)s->pps_list[i]->data;
+            if (ps_raw_equal(&old->raw, gb, hash) &&
+                s->sps_list[old->sps_id] &&
+                s->sps_list[old->sps_id]->data == old->sps_buf->data) {
+                s->ps_cache_hits++;
+                return 0;
+            }
+        }
+    }
+
+    pps = av_mallocz(sizeof(*pps));
     if (!pps)
         return AVERROR(ENOMEM);
 
@@ -2197,6 +2305,11 @@ int ff_hevc_decode_nal_pps(HEVCContext *s)
         goto err;
     }
     sps = (HEVCSPS *)s->sps_list[pps->sps_id]->data;
+    pps->sps_buf = av_buffer_ref(s->sps_list[pps->sps_id]);
+    if (!pps->sps_buf) {
+        ret = AVERROR(ENOMEM);
+        goto err;
+    }
 
     pps->dependent_slice_segments_enabled_flag = get_bits1(gb);
     pps->output_flag_present_flag              = get_bits1(gb);
@@ -2550,6 +2663,7 @@ int ff_hevc_decode_nal_pps(HEVCContext *s)
 
     av_freep(&col_bd);
     av_freep(&row_bd);
+    ps_raw_set(&pps->raw, gb, hash);
     av_buffer_unref(&s->pps_list[pps_id]);
     s->pps_list[pps_id] = pps_buf;
 
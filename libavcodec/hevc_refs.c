@@ -72,7 +72,7 @@ void ff_hevc_flush_dpb(HEVCContext *s)
         ff_hevc_unref_frame(s, &s->DPB[i], ~0);
 }
 
-static HEVCFrame *alloc_frame(HEVCContext *s)
+static HEVCFrame *alloc_frame(HEVCContext *s, ThreadFrame *alias)
 {
     int i, j, ret;
     for (i = 0; i < FF_ARRAY_ELEMS(s->DPB); i++) {
@@ -80,8 +80,11 @@ static HEVCFrame *alloc_frame(HEVCContext *s)
         if (frame->frame->buf[0])
             continue;
 
-        ret = ff_thread_get_buffer(s->avctx, &frame->tf,
-                                   AV_GET_BUFFER_FLAG_REF);
+        if (alias)
+            ret = ff_thread_ref_frame(&frame->tf, alias);
+        else
+            ret = ff_thread_get_buffer(s->avctx, &frame->tf,
+                                       AV_GET_BUFFER_FLAG_REF);
         if (ret < 0)
             return NULL;
 
@@ -130,7 +133,7 @@ int ff_hevc_set_new_ref(HEVCContext *s, AVFrame **frame, int poc)
         }
     }
 
-    ref = alloc_frame(s);
+    ref = alloc_frame(s, NULL);
     if (!ref)
         return AVERROR(ENOMEM);
 
@@ -146,6 +149,24 @@ int ff_hevc_set_new_ref(HEVCContext *s, AVFrame **frame, int poc)
     return 0;
 }
 #ifdef REF_IDX_FRAMEWORK
+/*
+ * With x1 (SNR) scalability and no scaled reference layer offsets the
+ * upsampled picture is a plain copy of the base layer one, so the
+ * inter-layer reference can share the BL buffers instead.
+ */
+static int il_ref_can_alias(HEVCContext *s)
+{
+    const HEVCWindow *win = &s->sps->scaled_ref_layer_window[s->vps->m_refLayerId[s->nuh_layer_id][0]];
+    const AVFrame    *bl  = s->BL_frame->frame;
+
+    return s->up_filter_inf.idx == SNR &&
+           !win->left_offset && !win->right_offset &&
+           !win->top_offset  && !win->bottom_offset &&
+           bl->coded_width  == s->sps->width  &&
+           bl->coded_height == s->sps->height &&
+           bl->format       == s->sps->pix_fmt;
+}
+
 int ff_hevc_set_new_iter_layer_ref(HEVCContext *s, AVFrame **frame, int poc)
 {
     HEVCFrame *ref;
@@ -162,7 +183,8 @@ int ff_hevc_set_new_iter_layer_ref(HEVCContext *s, AVFrame **frame, int poc)
         }
     }
     
-    ref = alloc_frame(s);
+    s->il_ref_aliased = il_ref_can_alias(s);
+    ref = alloc_frame(s, s->il_ref_aliased ? &s->BL_frame->tf : NULL);
     if (!ref)
         return AVERROR(ENOMEM);
     
@@ -173,7 +195,9 @@ int ff_hevc_set_new_iter_layer_ref(HEVCContext *s, AVFrame **frame, int poc)
     ref->flags          = HEVC_FRAME_FLAG_LONG_REF;
     ref->sequence       = s->seq_decode;
     ref->window         = s->sps->output_window;
-    if (s->threads_type & FF_THREAD_FRAME)
+    /* an aliased reference shares the BL progress, which must not be
+     * reported as complete from here */
+    if ((s->threads_type & FF_THREAD_FRAME) && !s->il_ref_aliased)
         ff_thread_report_progress(&s->inter_layer_ref->tf, INT_MAX, 0);
 
     return 0;
@@ -211,8 +235,9 @@ int ff_hevc_output_frame(HEVCContext *s, AVFrame *out, int flush)
         nb_output += s->no_display_pic;
 #endif
 
-        /* wait for more frames before output */
-        if (!flush && s->seq_output == s->seq_decode && s->sps &&
+        /* wait for more frames before output, an IRAP picture decoded
+         * alone is a sequence of its own */
+        if (!flush && s->seq_output == s->seq_decode && s->sps && !IS_IRAP_ONLY(s) &&
             nb_output <= s->sps->temporal_layer[s->sps->max_sub_layers - 1].num_reorder_pics)
             return 0;
 
@@ -546,7 +571,7 @@ static HEVCFrame *generate_missing_ref(HEVCContext *s, int poc)
     int x, y; 
 #endif
 
-    frame = alloc_frame(s);
+    frame = alloc_frame(s, NULL);
     if (!frame)
         return NULL;
 
@@ -779,6 +804,9 @@ int ff_hevc_compute_poc(HEVCContext *s, int poc_lsb)
         s->nal_unit_type == NAL_BLA_W_RADL ||
         s->nal_unit_type == NAL_BLA_N_LP)
         poc_msb = 0;
+    /* so are CRA pictures when only the IRAP pictures are decoded */
+    if (s->nal_unit_type == NAL_CRA_NUT && IS_IRAP_ONLY(s))
+        poc_msb = 0;
 
     return poc_msb + poc_lsb;
 }
@@ -287,6 +287,7 @@ void ff_hevc_dsp_init(HEVCDSPContext *hevcdsp, int bit_depth)
     hevcdsp->transform_add[3]       = FUNC(transform_add32x32, depth);             \
     hevcdsp->transform_skip         = FUNC(transform_skip, depth);                 \
     hevcdsp->transform_rdpcm        = FUNC(transform_rdpcm, depth);                \
+    hevcdsp->cross_component_pred   = FUNC(cross_component_pred, depth);           \
     hevcdsp->idct_4x4_luma          = FUNC(transform_4x4_luma, depth);             \
                                                                                    \
     hevcdsp->idct[0]                = FUNC(idct_4x4, depth);                       \
@@ -315,7 +316,9 @@ void ff_hevc_dsp_init(HEVCDSPContext *hevcdsp, int bit_depth)
     hevcdsp->hevc_h_loop_filter_luma_c   = FUNC(hevc_h_loop_filter_luma, depth);   \
     hevcdsp->hevc_v_loop_filter_luma_c   = FUNC(hevc_v_loop_filter_luma, depth);   \
     hevcdsp->hevc_h_loop_filter_chroma_c = FUNC(hevc_h_loop_filter_chroma, depth); \
-    hevcdsp->hevc_v_loop_filter_chroma_c = FUNC(hevc_v_loop_filter_chroma, depth)
+    hevcdsp->hevc_v_loop_filter_chroma_c = FUNC(hevc_v_loop_filter_chroma, depth); \
+    hevcdsp->hevc_h_loop_filter_luma_edge = NULL;                                  \
+    hevcdsp->hevc_v_loop_filter_luma_edge = NULL
 int i = 0;
 
     switch (bit_depth) {
@@ -372,4 +375,5 @@ int i = 0;
 #endif
     if (ARCH_X86) ff_hevcdsp_init_x86(hevcdsp, bit_depth);
     if (ARCH_ARM) ff_hevcdsp_init_arm(hevcdsp, bit_depth);
+    if (ARCH_AARCH64) ff_hevcdsp_init_aarch64(hevcdsp, bit_depth);
 }
@@ -59,6 +59,9 @@ typedef struct HEVCDSPContext {
 
     void (*transform_rdpcm)(int16_t *coeffs, int16_t log2_size, int mode);
 
+    void (*cross_component_pred)(int16_t *coeffs, const int16_t *coeffs_y,
+                                 int res_scale_val, int16_t log2_size);
+
     void (*idct_4x4_luma)(int16_t *coeffs);
 
     void (*idct[4])(int16_t *coeffs, int col_limit);
@@ -107,6 +110,11 @@ typedef struct HEVCDSPContext {
     void (*hevc_v_loop_filter_luma_c)(uint8_t *_pix, ptrdiff_t _stride, int _beta, int *_tc, uint8_t *_no_p, uint8_t *_no_q);
     void (*hevc_h_loop_filter_chroma_c)(uint8_t *_pix, ptrdiff_t _stride, int *_tc, uint8_t *_no_p, uint8_t *_no_q);
     void (*hevc_v_loop_filter_chroma_c)(uint8_t *_pix, ptrdiff_t _stride, int *_tc, uint8_t *_no_p, uint8_t *_no_q);
+    /* Whole CTB edge of nb_blocks blocks of 8 lines, one beta per block, tc
+     * and no_p/no_q per 4 lines. Optional, the 8 line functions are used
+     * when NULL. */
+    void (*hevc_h_loop_filter_luma_edge)(uint8_t *_pix, ptrdiff_t _stride, int *_beta, int *_tc, uint8_t *_no_p, uint8_t *_no_q, int nb_blocks);
+    void (*hevc_v_loop_filter_luma_edge)(uint8_t *_pix, ptrdiff_t _stride, int *_beta, int *_tc, uint8_t *_no_p, uint8_t *_no_q, int nb_blocks);
 
     void (*upsample_base_layer_frame)  (struct AVFrame *FrameEL, struct AVFrame *FrameBL, short *Buffer[3], const struct HEVCWindow *Enhscal, struct UpsamplInf *up_info, int channel);
     void (*upsample_filter_block_luma_h[3])(
@@ -134,4 +142,5 @@ extern const int8_t ff_hevc_qpel_filters[3][16];
 
 void ff_hevcdsp_init_x86(HEVCDSPContext *c, const int bit_depth);
 void ff_hevcdsp_init_arm(HEVCDSPContext *c, const int bit_depth);
+void ff_hevcdsp_init_aarch64(HEVCDSPContext *c, const int bit_depth);
 #endif /* AVCODEC_HEVCDSP_H */
@@ -136,6 +136,14 @@ static void FUNC(transform_rdpcm)(int16_t *_coeffs, int16_t log2_size, int mode)
     }
 }
 
+static void FUNC(cross_component_pred)(int16_t *coeffs, const int16_t *coeffs_y,
+                                       int res_scale_val, int16_t log2_size)
+{
+    int i;
+
+    for (i = 0; i < 1 << (2 * log2_size); i++)
+        coeffs[i] += (res_scale_val * coeffs_y[i]) >> 3;
+}
 
 static void FUNC(transform_skip)(int16_t *_coeffs, int16_t log2_size)
 {
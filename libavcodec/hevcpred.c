@@ -82,5 +82,7 @@ void ff_hevc_pred_init(HEVCPredContext *hpc, int bit_depth)
         break;
     }
     if (ARCH_X86) ff_hevcpred_init_x86(hpc, bit_depth);
+    if (ARCH_ARM) ff_hevcpred_init_arm(hpc, bit_depth);
+    if (ARCH_AARCH64) ff_hevcpred_init_aarch64(hpc, bit_depth);
 
 }
@@ -42,5 +42,7 @@ typedef struct HEVCPredContext {
 
 void ff_hevc_pred_init(HEVCPredContext *hpc, int bit_depth);
 void ff_hevcpred_init_x86(HEVCPredContext *c, const int bit_depth);
+void ff_hevcpred_init_arm(HEVCPredContext *c, const int bit_depth);
+void ff_hevcpred_init_aarch64(HEVCPredContext *c, const int bit_depth);
 
 #endif /* AVCODEC_HEVCPRED_H */
@@ -64,7 +64,8 @@ static void validate_thread_parameters(AVCodecContext *avctx)
         avctx->thread_count_frame = 1;
     } else if(frameslice_threading_supported && (avctx->thread_type & FF_THREAD_FRAME_SLICE)) {
         avctx->thread_count        = avctx->thread_count ? avctx->thread_count : av_cpu_count()>>1;
-        avctx->thread_count_frame  = FFMIN((av_cpu_count() / avctx->thread_count) + 1, MAX_AUTO_THREADS);
+        if (avctx->thread_count_frame <= 1)
+            avctx->thread_count_frame = FFMIN((av_cpu_count() / avctx->thread_count) + 1, MAX_AUTO_THREADS);
         if (avctx->thread_count_frame > 1)
             avctx->active_thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
         else
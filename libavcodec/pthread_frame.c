@@ -47,6 +47,7 @@
 #include "libavutil/internal.h"
 #include "libavutil/log.h"
 #include "libavutil/mem.h"
+#include "libavutil/time.h"
 #include "libavcodec/hevc.h"
 
 #define MAX_POC      1024
@@ -100,6 +101,14 @@ typedef struct PerThreadContext {
 
     const enum AVPixelFormat *available_formats; ///< Format array for get_format()
     enum AVPixelFormat result_format;            ///< get_format() result
+
+    /**
+     * Timings of the serial part of decoding the current packet, only
+     * measured with FF_DEBUG_THREADS.
+     */
+    int64_t update_time;            ///< time spent in update_thread_context()
+    int64_t decode_start;           ///< time the worker started decoding
+    int64_t setup_time;             ///< time from decode_start to ff_thread_finish_setup()
 } PerThreadContext;
 
 /**
@@ -157,6 +166,11 @@ static attribute_align_arg void *frame_worker_thread(void *arg)
 
         if (fctx->die) break;
 
+        if (avctx->debug & FF_DEBUG_THREADS) {
+            p->decode_start = av_gettime();
+            p->setup_time   = 0;
+        }
+
         if (!codec->update_thread_context && THREAD_SAFE_CALLBACKS(avctx))
             ff_thread_finish_setup(avctx);
 
@@ -173,6 +187,17 @@ static attribute_align_arg void *frame_worker_thread(void *arg)
 
         if (p->state == STATE_SETTING_UP) ff_thread_finish_setup(avctx);
 
+        if (avctx->debug & FF_DEBUG_THREADS) {
+            int64_t total = p->update_time + av_gettime() - p->decode_start;
+            int64_t serial = p->update_time + p->setup_time;
+
+            av_log(avctx, AV_LOG_DEBUG,
+                   "serial %"PRId64" us (update %"PRId64", setup %"PRId64") "
+                   "of %"PRId64" us, %.1f%%\n", serial,
+                   p->update_time, p->setup_time, total,
+                   total ? 100.0 * serial / total : 0.0);
+        }
+
         pthread_mutex_lock(&p->progress_mutex);
 #if 0 //BUFREF-FIXME
         for (i = 0; i < MAX_BUFFERS; i++)
@@ -264,6 +289,7 @@ static int update_context_from_user(AVCodecContext *dst, AVCodecContext *src)
 #define copy_fields(s, e) memcpy(&dst->s, &src->s, (char*)&dst->e - (char*)&dst->s);
     dst->flags          = src->flags;
     dst->quality_id     = src->quality_id;
+    dst->seek_pts       = src->seek_pts;
     dst->draw_horiz_band= src->draw_horiz_band;
     dst->get_buffer2    = src->get_buffer2;
 #if FF_API_GET_BUFFER
@@ -334,6 +360,7 @@ static int submit_packet(PerThreadContext *p, AVPacket *avpkt)
 
     release_delayed_buffers(p);
 
+    p->update_time = 0;
     if (prev_thread) {
         int err;
         if (prev_thread->state == STATE_SETTING_UP) {
@@ -343,7 +370,11 @@ static int submit_packet(PerThreadContext *p, AVPacket *avpkt)
             pthread_mutex_unlock(&prev_thread->progress_mutex);
         }
 
+        if (p->avctx->debug & FF_DEBUG_THREADS)
+            p->update_time = av_gettime();
         err = update_context_from_thread(p->avctx, prev_thread->avctx, 0);
+        if (p->avctx->debug & FF_DEBUG_THREADS)
+            p->update_time = av_gettime() - p->update_time;
         if (err) {
             pthread_mutex_unlock(&p->mutex);
             return err;
@@ -632,6 +663,9 @@ void ff_thread_finish_setup(AVCodecContext *avctx) {
         av_log(avctx, AV_LOG_WARNING, "Multiple ff_thread_finish_setup() calls\n");
     }
 
+    if (avctx->debug & FF_DEBUG_THREADS)
+        p->setup_time = av_gettime() - p->decode_start;
+
     pthread_mutex_lock(&p->progress_mutex);
     p->state = STATE_SETUP_FINISHED;
     pthread_cond_broadcast(&p->progress_cond);
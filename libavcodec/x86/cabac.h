@@ -295,6 +295,31 @@ static av_always_inline int get_cabac_bypass_x86(CABACContext *c)
     );
     return res;
 }
+
+#if HAVE_FAST_CMOV
+#define get_cabac_bypass_run get_cabac_bypass_run_x86
+static av_always_inline unsigned get_cabac_bypass_run_x86(int *low, int range,
+                                                          int k, unsigned val)
+{
+    x86_reg l = *low, tmp;
+    __asm__(
+        "1:                             \n\t"
+        "add             %0, %0         \n\t"
+        "lea       (%0, %4), %2         \n\t"
+        "cmp             %0, %5         \n\t"
+        "cmovc           %2, %0         \n\t"
+        "adc             %1, %1         \n\t"
+        "dec             %3             \n\t"
+        "jnz              1b            \n\t"
+        : "+&r"(l), "+&r"(val), "=&r"(tmp), "+&r"(k)
+        : "r"((x86_reg)-range), "r"((x86_reg)range - 1)
+        : "cc"
+    );
+    *low = l;
+    return val;
+}
+#endif /* HAVE_FAST_CMOV */
+
 #endif /* !BROKEN_COMPILER */
 
 #endif /* HAVE_INLINE_ASM */
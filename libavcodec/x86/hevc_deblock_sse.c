@@ -0,0 +1,310 @@
+/*
+ * Provide SSE luma deblocking functions for HEVC decoding
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/common.h"
+#include "libavcodec/x86/hevcdsp.h"
+
+#if HAVE_SSE2
+#include <emmintrin.h>
+
+/* The kernels work on blocks of 8 lines across the edge, one line per
+ * 16-bit lane: lanes 0-3 and 4-7 are the two 4-line segments, each with its
+ * own tc and no_p/no_q flags, the decisions being made on lines 0 and 3 of
+ * each segment as in the C version. */
+
+#define P3 r[0]
+#define P2 r[1]
+#define P1 r[2]
+#define P0 r[3]
+#define Q0 r[4]
+#define Q1 r[5]
+#define Q2 r[6]
+#define Q3 r[7]
+
+static av_always_inline __m128i abs_epi16(__m128i a)
+{
+    return _mm_max_epi16(a, _mm_sub_epi16(_mm_setzero_si128(), a));
+}
+
+static av_always_inline __m128i clip_epi16(__m128i a, __m128i lo, __m128i hi)
+{
+    return _mm_min_epi16(_mm_max_epi16(a, lo), hi);
+}
+
+static av_always_inline __m128i select_epi16(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/* value of lane 0 of each segment, in all its lanes */
+static av_always_inline __m128i line0(__m128i a)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, 0x00), 0x00);
+}
+
+/* value of lane 3 of each segment, in all its lanes */
+static av_always_inline __m128i line3(__m128i a)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, 0xff), 0xff);
+}
+
+static av_always_inline __m128i segment_flags(const uint8_t *flag)
+{
+    __m128i f = _mm_set_epi16(flag[1], flag[1], flag[1], flag[1],
+                              flag[0], flag[0], flag[0], flag[0]);
+    return _mm_cmpeq_epi16(f, _mm_setzero_si128());
+}
+
+static av_always_inline void transpose8x8_epi16(__m128i *r)
+{
+    __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+    __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+    __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+    __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+    __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+    __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+    __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+    __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+    __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+    __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+    __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+    __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+    __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+    __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+    __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+    __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+    r[0] = _mm_unpacklo_epi64(b0, b4);
+    r[1] = _mm_unpackhi_epi64(b0, b4);
+    r[2] = _mm_unpacklo_epi64(b1, b5);
+    r[3] = _mm_unpackhi_epi64(b1, b5);
+    r[4] = _mm_unpacklo_epi64(b2, b6);
+    r[5] = _mm_unpackhi_epi64(b2, b6);
+    r[6] = _mm_unpacklo_epi64(b3, b7);
+    r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+/* Filter p2..q2 in place, returns 0 when no sample was changed */
+static av_always_inline int loop_filter_luma(__m128i *r, int beta, const int *_tc,
+                                             const uint8_t *no_p, const uint8_t *no_q,
+                                             int bit_depth)
+{
+    const __m128i zero    = _mm_setzero_si128();
+    const __m128i max_pix = _mm_set1_epi16((1 << bit_depth) - 1);
+    const __m128i tc      = _mm_slli_epi16(_mm_set_epi16(_tc[1], _tc[1], _tc[1], _tc[1],
+                                                         _tc[0], _tc[0], _tc[0], _tc[0]),
+                                           bit_depth - 8);
+    __m128i dp, dq, d, on, strong, normal, nd_p, nd_q, keep_p, keep_q, t;
+    __m128i tc2, delta0, deltap1, deltaq1, tc_2;
+    __m128i p2s, p1s, p0s, q0s, q1s, q2s;
+
+    beta <<= bit_depth - 8;
+
+    dp = abs_epi16(_mm_sub_epi16(_mm_add_epi16(P2, P0), _mm_add_epi16(P1, P1)));
+    dq = abs_epi16(_mm_sub_epi16(_mm_add_epi16(Q2, Q0), _mm_add_epi16(Q1, Q1)));
+    d  = _mm_add_epi16(dp, dq);
+    on = _mm_cmplt_epi16(_mm_add_epi16(line0(d), line3(d)), _mm_set1_epi16(beta));
+    if (!_mm_movemask_epi8(on))
+        return 0;
+
+    // strong filter decision, made on lines 0 and 3
+    t      = _mm_add_epi16(abs_epi16(_mm_sub_epi16(P3, P0)), abs_epi16(_mm_sub_epi16(Q3, Q0)));
+    strong = _mm_cmplt_epi16(t, _mm_set1_epi16(beta >> 3));
+    t      = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(tc, 2), tc), _mm_set1_epi16(1)), 1);
+    strong = _mm_and_si128(strong, _mm_cmplt_epi16(abs_epi16(_mm_sub_epi16(P0, Q0)), t));
+    strong = _mm_and_si128(strong, _mm_cmplt_epi16(_mm_slli_epi16(d, 1), _mm_set1_epi16(beta >> 2)));
+    strong = _mm_and_si128(line0(strong), line3(strong));
+
+    keep_p = segment_flags(no_p);
+    keep_q = segment_flags(no_q);
+
+    // strong filter
+    tc2 = _mm_slli_epi16(tc, 1);
+    t   = _mm_add_epi16(_mm_add_epi16(P1, P0), Q0);
+    p0s = _mm_add_epi16(_mm_add_epi16(_mm_add_epi16(P2, _mm_slli_epi16(t, 1)), Q1), _mm_set1_epi16(4));
+    p0s = clip_epi16(_mm_srai_epi16(p0s, 3), _mm_sub_epi16(P0, tc2), _mm_add_epi16(P0, tc2));
+    p1s = _mm_add_epi16(_mm_add_epi16(P2, t), _mm_set1_epi16(2));
+    p1s = clip_epi16(_mm_srai_epi16(p1s, 2), _mm_sub_epi16(P1, tc2), _mm_add_epi16(P1, tc2));
+    p2s = _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(_mm_add_epi16(P3, P2), 1), P2), t);
+    p2s = clip_epi16(_mm_srai_epi16(_mm_add_epi16(p2s, _mm_set1_epi16(4)), 3),
+                     _mm_sub_epi16(P2, tc2), _mm_add_epi16(P2, tc2));
+    t   = _mm_add_epi16(_mm_add_epi16(Q1, Q0), P0);
+    q0s = _mm_add_epi16(_mm_add_epi16(_mm_add_epi16(Q2, _mm_slli_epi16(t, 1)), P1), _mm_set1_epi16(4));
+    q0s = clip_epi16(_mm_srai_epi16(q0s, 3), _mm_sub_epi16(Q0, tc2), _mm_add_epi16(Q0, tc2));
+    q1s = _mm_add_epi16(_mm_add_epi16(Q2, t), _mm_set1_epi16(2));
+    q1s = clip_epi16(_mm_srai_epi16(q1s, 2), _mm_sub_epi16(Q1, tc2), _mm_add_epi16(Q1, tc2));
+    q2s = _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(_mm_add_epi16(Q3, Q2), 1), Q2), t);
+    q2s = clip_epi16(_mm_srai_epi16(_mm_add_epi16(q2s, _mm_set1_epi16(4)), 3),
+                     _mm_sub_epi16(Q2, tc2), _mm_add_epi16(Q2, tc2));
+
+    // normal filter
+    if (bit_depth > 10) {
+        // 9 * (q0 - p0) - 3 * (q1 - p1) does not fit in 16 bits at 12 bits
+        const __m128i w = _mm_set_epi16(-3, 9, -3, 9, -3, 9, -3, 9);
+        __m128i dq0 = _mm_sub_epi16(Q0, P0), dq1 = _mm_sub_epi16(Q1, P1), lo, hi;
+        lo = _mm_madd_epi16(_mm_unpacklo_epi16(dq0, dq1), w);
+        hi = _mm_madd_epi16(_mm_unpackhi_epi16(dq0, dq1), w);
+        lo = _mm_srai_epi32(_mm_add_epi32(lo, _mm_set1_epi32(8)), 4);
+        hi = _mm_srai_epi32(_mm_add_epi32(hi, _mm_set1_epi32(8)), 4);
+        delta0 = _mm_packs_epi32(lo, hi);
+    } else {
+        t      = _mm_sub_epi16(Q0, P0);
+        delta0 = _mm_add_epi16(_mm_slli_epi16(t, 3), t);
+        t      = _mm_sub_epi16(Q1, P1);
+        delta0 = _mm_sub_epi16(delta0, _mm_add_epi16(_mm_slli_epi16(t, 1), t));
+        delta0 = _mm_srai_epi16(_mm_add_epi16(delta0, _mm_set1_epi16(8)), 4);
+    }
+    t      = _mm_slli_epi16(tc, 1);
+    normal = _mm_cmplt_epi16(abs_epi16(delta0), _mm_add_epi16(_mm_slli_epi16(t, 2), t));
+    delta0 = clip_epi16(delta0, _mm_sub_epi16(zero, tc), tc);
+
+    t    = _mm_set1_epi16((beta + (beta >> 1)) >> 3);
+    nd_p = _mm_cmplt_epi16(_mm_add_epi16(line0(dp), line3(dp)), t);
+    nd_q = _mm_cmplt_epi16(_mm_add_epi16(line0(dq), line3(dq)), t);
+    tc_2 = _mm_srai_epi16(tc, 1);
+    deltap1 = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(P2, P0), _mm_set1_epi16(1)), 1);
+    deltap1 = _mm_srai_epi16(_mm_add_epi16(_mm_sub_epi16(deltap1, P1), delta0), 1);
+    deltap1 = clip_epi16(deltap1, _mm_sub_epi16(zero, tc_2), tc_2);
+    deltaq1 = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(Q2, Q0), _mm_set1_epi16(1)), 1);
+    deltaq1 = _mm_srai_epi16(_mm_sub_epi16(_mm_sub_epi16(deltaq1, Q1), delta0), 1);
+    deltaq1 = clip_epi16(deltaq1, _mm_sub_epi16(zero, tc_2), tc_2);
+
+    normal = _mm_andnot_si128(strong, _mm_and_si128(on, normal));
+    strong = _mm_and_si128(strong, on);
+
+    t  = _mm_and_si128(strong, keep_p);
+    P2 = select_epi16(t, p2s, P2);
+    p1s = select_epi16(t, p1s, P1);
+    p0s = select_epi16(t, p0s, P0);
+    t  = _mm_and_si128(normal, keep_p);
+    P1 = select_epi16(_mm_and_si128(t, nd_p),
+                      clip_epi16(_mm_add_epi16(P1, deltap1), zero, max_pix), p1s);
+    P0 = select_epi16(t, clip_epi16(_mm_add_epi16(P0, delta0), zero, max_pix), p0s);
+
+    t  = _mm_and_si128(strong, keep_q);
+    Q2 = select_epi16(t, q2s, Q2);
+    q1s = select_epi16(t, q1s, Q1);
+    q0s = select_epi16(t, q0s, Q0);
+    t  = _mm_and_si128(normal, keep_q);
+    Q1 = select_epi16(_mm_and_si128(t, nd_q),
+                      clip_epi16(_mm_add_epi16(Q1, deltaq1), zero, max_pix), q1s);
+    Q0 = select_epi16(t, clip_epi16(_mm_sub_epi16(Q0, delta0), zero, max_pix), q0s);
+
+    return 1;
+}
+
+static av_always_inline void v_loop_filter_luma_edge(uint8_t *pix, ptrdiff_t stride,
+                                                     int *beta, int *tc,
+                                                     uint8_t *no_p, uint8_t *no_q,
+                                                     int nb_blocks, int bit_depth)
+{
+    __m128i r[8];
+    int i, j;
+
+    for (i = 0; i < nb_blocks; i++, pix += 8 * stride) {
+        if (!tc[2 * i] && !tc[2 * i + 1])
+            continue;
+        for (j = 0; j < 8; j++) {
+            if (bit_depth == 8)
+                r[j] = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i *)&pix[j * stride - 4]),
+                                         _mm_setzero_si128());
+            else
+                r[j] = _mm_loadu_si128((__m128i *)&pix[j * stride - 8]);
+        }
+        transpose8x8_epi16(r);
+        if (!loop_filter_luma(r, beta[i], tc + 2 * i, no_p + 2 * i, no_q + 2 * i, bit_depth))
+            continue;
+        transpose8x8_epi16(r);
+        for (j = 0; j < 8; j++) {
+            if (bit_depth == 8)
+                _mm_storel_epi64((__m128i *)&pix[j * stride - 4], _mm_packus_epi16(r[j], r[j]));
+            else
+                _mm_storeu_si128((__m128i *)&pix[j * stride - 8], r[j]);
+        }
+    }
+}
+
+static av_always_inline void h_loop_filter_luma_edge(uint8_t *pix, ptrdiff_t stride,
+                                                     int *beta, int *tc,
+                                                     uint8_t *no_p, uint8_t *no_q,
+                                                     int nb_blocks, int bit_depth)
+{
+    __m128i r[8];
+    int i, j;
+
+    for (i = 0; i < nb_blocks; i++, pix += bit_depth > 8 ? 16 : 8) {
+        if (!tc[2 * i] && !tc[2 * i + 1])
+            continue;
+        for (j = 0; j < 8; j++) {
+            if (bit_depth == 8)
+                r[j] = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i *)&pix[(j - 4) * stride]),
+                                         _mm_setzero_si128());
+            else
+                r[j] = _mm_loadu_si128((__m128i *)&pix[(j - 4) * stride]);
+        }
+        if (!loop_filter_luma(r, beta[i], tc + 2 * i, no_p + 2 * i, no_q + 2 * i, bit_depth))
+            continue;
+        for (j = 1; j < 7; j++) {
+            if (bit_depth == 8)
+                _mm_storel_epi64((__m128i *)&pix[(j - 4) * stride], _mm_packus_epi16(r[j], r[j]));
+            else
+                _mm_storeu_si128((__m128i *)&pix[(j - 4) * stride], r[j]);
+        }
+    }
+}
+
+void ff_hevc_v_loop_filter_luma_edge_8_sse2(uint8_t *pix, ptrdiff_t stride, int *beta, int *tc,
+                                            uint8_t *no_p, uint8_t *no_q, int nb_blocks)
+{
+    v_loop_filter_luma_edge(pix, stride, beta, tc, no_p, no_q, nb_blocks, 8);
+}
+
+void ff_hevc_h_loop_filter_luma_edge_8_sse2(uint8_t *pix, ptrdiff_t stride, int *beta, int *tc,
+                                            uint8_t *no_p, uint8_t *no_q, int nb_blocks)
+{
+    h_loop_filter_luma_edge(pix, stride, beta, tc, no_p, no_q, nb_blocks, 8);
+}
+
+void ff_hevc_v_loop_filter_luma_edge_10_sse2(uint8_t *pix, ptrdiff_t stride, int *beta, int *tc,
+                                             uint8_t *no_p, uint8_t *no_q, int nb_blocks)
+{
+    v_loop_filter_luma_edge(pix, stride, beta, tc, no_p, no_q, nb_blocks, 10);
+}
+
+void ff_hevc_h_loop_filter_luma_edge_10_sse2(uint8_t *pix, ptrdiff_t stride, int *beta, int *tc,
+                                             uint8_t *no_p, uint8_t *no_q, int nb_blocks)
+{
+    h_loop_filter_luma_edge(pix, stride, beta, tc, no_p, no_q, nb_blocks, 10);
+}
+
+void ff_hevc_v_loop_filter_luma_edge_12_sse2(uint8_t *pix, ptrdiff_t stride, int *beta, int *tc,
+                                             uint8_t *no_p, uint8_t *no_q, int nb_blocks)
+{
+    v_loop_filter_luma_edge(pix, stride, beta, tc, no_p, no_q, nb_blocks, 12);
+}
+
+void ff_hevc_h_loop_filter_luma_edge_12_sse2(uint8_t *pix, ptrdiff_t stride, int *beta, int *tc,
+                                             uint8_t *no_p, uint8_t *no_q, int nb_blocks)
+{
+    h_loop_filter_luma_edge(pix, stride, beta, tc, no_p, no_q, nb_blocks, 12);
+}
+
+#endif // HAVE_SSE2
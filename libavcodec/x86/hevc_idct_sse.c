@@ -7,6 +7,9 @@
 #if HAVE_SSE2
 #include <emmintrin.h>
 #endif
+#if HAVE_SSSE3
+#include <tmmintrin.h>
+#endif
 
 DECLARE_ALIGNED(16, static const int16_t, transform4x4_luma[8][8] )=
 {
@@ -914,4 +917,147 @@ TRANSFORM_ADD( 4,12)
 TRANSFORM_ADD( 8,12)
 TRANSFORM_ADD(16,12)
 TRANSFORM_ADD(32,12)
+
+////////////////////////////////////////////////////////////////////////////////
+// ff_hevc_idct_XxX_dc_X_sse2
+////////////////////////////////////////////////////////////////////////////////
+#define IDCT_DC(H, D)                                                          \
+void ff_hevc_idct_ ## H ## x ## H ## _dc_ ## D ## _sse2(int16_t *coeffs) {     \
+    const int shift  = 14 - D;                                                 \
+    const __m128i dc = _mm_set1_epi16((((coeffs[0] + 1) >> 1) +                \
+                                       (1 << (shift - 1))) >> shift);          \
+    int i;                                                                     \
+    for (i = 0; i < H * H; i += 8)                                             \
+        _mm_store_si128((__m128i *) &coeffs[i], dc);                           \
+}
+
+IDCT_DC( 4, 8)
+IDCT_DC( 8, 8)
+IDCT_DC(16, 8)
+IDCT_DC(32, 8)
+
+IDCT_DC( 4,10)
+IDCT_DC( 8,10)
+IDCT_DC(16,10)
+IDCT_DC(32,10)
+
+IDCT_DC( 4,12)
+IDCT_DC( 8,12)
+IDCT_DC(16,12)
+IDCT_DC(32,12)
+
+////////////////////////////////////////////////////////////////////////////////
+// ff_hevc_transform_rdpcm_sse2
+////////////////////////////////////////////////////////////////////////////////
+/* Prefix sum of the 8 lanes of a */
+static av_always_inline __m128i prefix_sum_epi16(__m128i a)
+{
+    a = _mm_add_epi16(a, _mm_slli_si128(a, 2));
+    a = _mm_add_epi16(a, _mm_slli_si128(a, 4));
+    return _mm_add_epi16(a, _mm_slli_si128(a, 8));
+}
+
+void ff_hevc_transform_rdpcm_sse2(int16_t *coeffs, int16_t log2_size, int mode)
+{
+    const int size = 1 << log2_size;
+    __m128i r0, r1, prev;
+    int x, y;
+
+    if (size == 4) {
+        r0 = _mm_load_si128((__m128i *) &coeffs[0]);
+        r1 = _mm_load_si128((__m128i *) &coeffs[8]);
+        if (mode) {
+            r0 = _mm_add_epi16(r0, _mm_slli_si128(r0, 8));
+            r1 = _mm_add_epi16(r1, _mm_slli_si128(r1, 8));
+            r1 = _mm_add_epi16(r1, _mm_unpackhi_epi64(r0, r0));
+        } else {
+            // the lane shifts must not carry from the first row into the second
+            const __m128i m1 = _mm_set_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+            const __m128i m2 = _mm_set_epi16(-1, -1, 0, 0, -1, -1, 0, 0);
+            r0 = _mm_add_epi16(r0, _mm_and_si128(_mm_slli_si128(r0, 2), m1));
+            r1 = _mm_add_epi16(r1, _mm_and_si128(_mm_slli_si128(r1, 2), m1));
+            r0 = _mm_add_epi16(r0, _mm_and_si128(_mm_slli_si128(r0, 4), m2));
+            r1 = _mm_add_epi16(r1, _mm_and_si128(_mm_slli_si128(r1, 4), m2));
+        }
+        _mm_store_si128((__m128i *) &coeffs[0], r0);
+        _mm_store_si128((__m128i *) &coeffs[8], r1);
+        return;
+    }
+
+    if (mode) {
+        for (x = 0; x < size; x += 8) {
+            prev = _mm_load_si128((__m128i *) &coeffs[x]);
+            for (y = 1; y < size; y++) {
+                prev = _mm_add_epi16(prev, _mm_load_si128((__m128i *) &coeffs[y * size + x]));
+                _mm_store_si128((__m128i *) &coeffs[y * size + x], prev);
+            }
+        }
+    } else {
+        for (y = 0; y < size; y++, coeffs += size) {
+            prev = _mm_setzero_si128();
+            for (x = 0; x < size; x += 8) {
+                r0 = prefix_sum_epi16(_mm_load_si128((__m128i *) &coeffs[x]));
+                r0 = _mm_add_epi16(r0, prev);
+                _mm_store_si128((__m128i *) &coeffs[x], r0);
+                prev = _mm_shufflehi_epi16(r0, 0xff);
+                prev = _mm_unpackhi_epi64(prev, prev);
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ff_hevc_cross_component_pred_sse2
+////////////////////////////////////////////////////////////////////////////////
+void ff_hevc_cross_component_pred_sse2(int16_t *coeffs, const int16_t *coeffs_y,
+                                       int res_scale_val, int16_t log2_size)
+{
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i scale = _mm_set1_epi32(res_scale_val & 0xffff);
+    const int n = 1 << (2 * log2_size);
+    __m128i y, lo, hi;
+    int i;
+
+    for (i = 0; i < n; i += 8) {
+        y  = _mm_load_si128((__m128i *) &coeffs_y[i]);
+        lo = _mm_srai_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(y, zero), scale), 3);
+        hi = _mm_srai_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(y, zero), scale), 3);
+        // keep the low 16 bits like the conversion of the C version
+        lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+        hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+        _mm_store_si128((__m128i *) &coeffs[i],
+                        _mm_add_epi16(_mm_load_si128((__m128i *) &coeffs[i]),
+                                      _mm_packs_epi32(lo, hi)));
+    }
+}
+#endif
+
+#if HAVE_SSSE3
+////////////////////////////////////////////////////////////////////////////////
+// ff_hevc_transform_skip_X_ssse3
+////////////////////////////////////////////////////////////////////////////////
+/* (c + (1 << (shift - 1))) >> shift is the rounded high half of
+ * c * (1 << (15 - shift)), without the 16 bit overflow of the addition */
+#define TRANSFORM_SKIP(D)                                                      \
+void ff_hevc_transform_skip_ ## D ## _ssse3(int16_t *coeffs, int16_t log2_size) \
+{                                                                              \
+    const int shift = 15 - D - log2_size;                                      \
+    const int n     = 1 << (2 * log2_size);                                    \
+    int i;                                                                     \
+    if (shift > 0) {                                                           \
+        const __m128i m = _mm_set1_epi16(1 << (15 - shift));                   \
+        for (i = 0; i < n; i += 8)                                             \
+            _mm_store_si128((__m128i *) &coeffs[i],                            \
+                _mm_mulhrs_epi16(_mm_load_si128((__m128i *) &coeffs[i]), m));  \
+    } else {                                                                   \
+        const __m128i s = _mm_cvtsi32_si128(-shift);                           \
+        for (i = 0; i < n; i += 8)                                             \
+            _mm_store_si128((__m128i *) &coeffs[i],                            \
+                _mm_sll_epi16(_mm_load_si128((__m128i *) &coeffs[i]), s));     \
+    }                                                                          \
+}
+
+TRANSFORM_SKIP( 8)
+TRANSFORM_SKIP(10)
+TRANSFORM_SKIP(12)
 #endif
@@ -44,14 +44,11 @@
 #define _MM_PACKUS_EPI32 _mm_packus_epi32
 #else
 #if HAVE_SSE2
+/* The packed values are clipped to the pixel range afterwards, signed
+ * saturation gives the same result as the SSE4 unsigned one. */
 static av_always_inline __m128i _MM_PACKUS_EPI32( __m128i a, __m128i b )
 {
-     a = _mm_slli_epi32 (a, 16);
-     a = _mm_srai_epi32 (a, 16);
-     b = _mm_slli_epi32 (b, 16);
-     b = _mm_srai_epi32 (b, 16);
-     a = _mm_packs_epi32 (a, b);
-    return a;
+    return _mm_packs_epi32(a, b);
 }
 #endif
 #endif
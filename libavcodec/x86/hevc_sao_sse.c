@@ -491,26 +491,26 @@ void ff_hevc_sao_edge_filter_1_ ## D ##_sse(uint8_t *_dst, uint8_t *_src,      \
     /* Restore pixels that can't be modified */                                \
     if(vert_edge[0] && sao_eo_class != SAO_EO_VERT)                            \
         for(y = init_y + save_upper_left; y < height - save_lower_left; y++)   \
-            dst[y * _stride_dst] = src[y * _stride_src];                       \
+            dst[y * stride_dst] = src[y * stride_src];                         \
     if(vert_edge[1] && sao_eo_class != SAO_EO_VERT)                            \
         for(y = init_y + save_upper_right; y < height - save_lower_right; y++) \
-            dst[y*_stride_dst + width - 1] = src[y * _stride_src + width - 1]; \
+            dst[y*stride_dst + width - 1] = src[y * stride_src + width - 1];   \
     if(horiz_edge[0] && sao_eo_class != SAO_EO_HORIZ)                          \
         for(x = init_x + save_upper_left; x < width - save_upper_right; x++)   \
             dst[x] = src[x];                                                   \
     if(horiz_edge[1] && sao_eo_class != SAO_EO_HORIZ)                          \
         for(x = init_x + save_lower_left; x < width - save_lower_right; x++)   \
-            dst[(height - 1) * _stride_dst + x] =                              \
-                src[(height - 1) * _stride_src + x];                           \
+            dst[(height - 1) * stride_dst + x] =                               \
+                src[(height - 1) * stride_src + x];                            \
     if(diag_edge[0] && sao_eo_class == SAO_EO_135D)                            \
         dst[0] = src[0];                                                       \
     if(diag_edge[1] && sao_eo_class == SAO_EO_45D)                             \
         dst[width - 1] = src[width - 1];                                       \
     if(diag_edge[2] && sao_eo_class == SAO_EO_135D)                            \
-        dst[_stride_dst*(height-1) + width-1] =                                \
-            src[_stride_src * (height-1) + width-1];                           \
+        dst[stride_dst*(height-1) + width-1] =                                 \
+            src[stride_src * (height-1) + width-1];                            \
     if(diag_edge[3] && sao_eo_class == SAO_EO_45D)                             \
-        dst[_stride_dst * (height - 1)] = src[_stride_src * (height - 1)];     \
+        dst[stride_dst * (height - 1)] = src[stride_src * (height - 1)];       \
 }
 
 SAO_EDGE_FILTER_0( 8)
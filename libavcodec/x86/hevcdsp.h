@@ -118,6 +118,29 @@ void ff_hevc_transform_8x8_add_12_sse4(uint8_t *dst, int16_t *coeffs, ptrdiff_t
 void ff_hevc_transform_16x16_add_12_sse4(uint8_t *dst, int16_t *coeffs, ptrdiff_t stride);
 void ff_hevc_transform_32x32_add_12_sse4(uint8_t *dst, int16_t *coeffs, ptrdiff_t stride);
 
+#define IDCT_DC_FUNC(s, b) void ff_hevc_idct_ ## s ## x ## s ## _dc_ ## b ## _sse2\
+            (int16_t *coeffs);
+
+IDCT_DC_FUNC(4, 8)
+IDCT_DC_FUNC(4, 10)
+IDCT_DC_FUNC(4, 12)
+IDCT_DC_FUNC(8, 8)
+IDCT_DC_FUNC(8, 10)
+IDCT_DC_FUNC(8, 12)
+IDCT_DC_FUNC(16, 8)
+IDCT_DC_FUNC(16, 10)
+IDCT_DC_FUNC(16, 12)
+IDCT_DC_FUNC(32, 8)
+IDCT_DC_FUNC(32, 10)
+IDCT_DC_FUNC(32, 12)
+
+void ff_hevc_transform_skip_8_ssse3(int16_t *coeffs, int16_t log2_size);
+void ff_hevc_transform_skip_10_ssse3(int16_t *coeffs, int16_t log2_size);
+void ff_hevc_transform_skip_12_ssse3(int16_t *coeffs, int16_t log2_size);
+void ff_hevc_transform_rdpcm_sse2(int16_t *coeffs, int16_t log2_size, int mode);
+void ff_hevc_cross_component_pred_sse2(int16_t *coeffs, const int16_t *coeffs_y,
+                                       int res_scale_val, int16_t log2_size);
+
 ///////////////////////////////////////////////////////////////////////////////
 // MC functions
 ///////////////////////////////////////////////////////////////////////////////
@@ -217,6 +240,19 @@ idct_dc_proto(32,10,   avx);
 idct_dc_proto(16,10,  avx2);
 idct_dc_proto(32,10,  avx2);
 
+///////////////////////////////////////////////////////////////////////////////
+// Deblocking functions
+///////////////////////////////////////////////////////////////////////////////
+#define LFL_EDGE_PROTO(dir, bitd, opt) \
+void ff_hevc_ ## dir ## _loop_filter_luma_edge_ ## bitd ## _ ## opt(uint8_t *pix, ptrdiff_t stride, int *beta, int *tc, \
+                                                                  uint8_t *no_p, uint8_t *no_q, int nb_blocks)
+LFL_EDGE_PROTO(h,  8, sse2);
+LFL_EDGE_PROTO(v,  8, sse2);
+LFL_EDGE_PROTO(h, 10, sse2);
+LFL_EDGE_PROTO(v, 10, sse2);
+LFL_EDGE_PROTO(h, 12, sse2);
+LFL_EDGE_PROTO(v, 12, sse2);
+
 ///////////////////////////////////////////////////////////////////////////////
 // SAO functions
 ///////////////////////////////////////////////////////////////////////////////
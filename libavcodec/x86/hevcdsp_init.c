@@ -35,7 +35,7 @@
 void ff_hevc_ ## DIR ## _loop_filter_chroma_ ## DEPTH ## _ ## OPT(uint8_t *_pix, ptrdiff_t _stride, int *_tc, uint8_t *_no_p, uint8_t *_no_q);
 
 #define LFL_FUNC(DIR, DEPTH, OPT)                                        \
-void ff_hevc_ ## DIR ## _loop_filter_luma_ ## DEPTH ## _ ## OPT(uint8_t *_pix, ptrdiff_t stride, int *_beta, int *_tc, \
+void ff_hevc_ ## DIR ## _loop_filter_luma_ ## DEPTH ## _ ## OPT(uint8_t *_pix, ptrdiff_t stride, int beta, int *_tc, \
 uint8_t *_no_p, uint8_t *_no_q);
 
 #define LFC_FUNCS(type, depth) \
@@ -48,8 +48,10 @@ LFL_FUNC(v, depth, ssse3)
 
 LFC_FUNCS(uint8_t,   8)
 LFC_FUNCS(uint8_t,  10)
+LFC_FUNCS(uint8_t,  12)
 LFL_FUNCS(uint8_t,   8)
 LFL_FUNCS(uint8_t,  10)
+LFL_FUNCS(uint8_t,  12)
 
 
 #if !ARCH_X86_32 && defined(OPTI_ASM)
@@ -440,8 +442,16 @@ void ff_hevcdsp_init_x86(HEVCDSPContext *c, const int bit_depth)
                 if (EXTERNAL_SSE2(mm_flags)) {
                     c->hevc_v_loop_filter_chroma = ff_hevc_v_loop_filter_chroma_8_sse2;
                     c->hevc_h_loop_filter_chroma = ff_hevc_h_loop_filter_chroma_8_sse2;
+                    c->hevc_v_loop_filter_luma_edge = ff_hevc_v_loop_filter_luma_edge_8_sse2;
+                    c->hevc_h_loop_filter_luma_edge = ff_hevc_h_loop_filter_luma_edge_8_sse2;
+
+                    c->idct_dc[0]       = ff_hevc_idct_4x4_dc_8_sse2;
+                    c->idct_dc[1]       = ff_hevc_idct_8x8_dc_8_sse2;
+                    c->idct_dc[2]       = ff_hevc_idct_16x16_dc_8_sse2;
+                    c->idct_dc[3]       = ff_hevc_idct_32x32_dc_8_sse2;
+                    c->transform_rdpcm  = ff_hevc_transform_rdpcm_sse2;
+                    c->cross_component_pred = ff_hevc_cross_component_pred_sse2;
 
-                    // only 4X4 needs update for Rext                   c->transform_skip    = ff_hevc_transform_skip_8_sse;
                     c->idct_4x4_luma = ff_hevc_transform_4x4_luma_8_sse4;
                     c->idct[0] = ff_hevc_transform_4x4_8_sse4;
                     c->idct[1] = ff_hevc_transform_8x8_8_sse4;
@@ -471,6 +481,7 @@ void ff_hevcdsp_init_x86(HEVCDSPContext *c, const int bit_depth)
                     c->hevc_v_loop_filter_luma = ff_hevc_v_loop_filter_luma_8_ssse3;
                     c->hevc_h_loop_filter_luma = ff_hevc_h_loop_filter_luma_8_ssse3;
 #endif
+                    c->transform_skip  = ff_hevc_transform_skip_8_ssse3;
                     EPEL_LINKS(c->put_hevc_epel, 0, 0, pel_pixels,  8, sse4);
                     EPEL_LINKS(c->put_hevc_epel, 0, 1, epel_h,      8, sse4);
                     EPEL_LINKS(c->put_hevc_epel, 1, 0, epel_v,      8, sse4);
@@ -532,6 +543,8 @@ void ff_hevcdsp_init_x86(HEVCDSPContext *c, const int bit_depth)
                 if (EXTERNAL_SSE2(mm_flags)) {
                     c->hevc_v_loop_filter_chroma = ff_hevc_v_loop_filter_chroma_10_sse2;
                     c->hevc_h_loop_filter_chroma = ff_hevc_h_loop_filter_chroma_10_sse2;
+                    c->hevc_v_loop_filter_luma_edge = ff_hevc_v_loop_filter_luma_edge_10_sse2;
+                    c->hevc_h_loop_filter_luma_edge = ff_hevc_h_loop_filter_luma_edge_10_sse2;
 
 #ifdef OPTI_ASM
                     c->transform_dc_add[1]    =  ff_hevc_idct8_dc_add_10_sse2;
@@ -548,6 +561,12 @@ void ff_hevcdsp_init_x86(HEVCDSPContext *c, const int bit_depth)
                     c->transform_add[2] = ff_hevc_transform_16x16_add_10_sse4;
                     c->transform_add[3] = ff_hevc_transform_32x32_add_10_sse4;
 
+                    c->idct_dc[0]       = ff_hevc_idct_4x4_dc_10_sse2;
+                    c->idct_dc[1]       = ff_hevc_idct_8x8_dc_10_sse2;
+                    c->idct_dc[2]       = ff_hevc_idct_16x16_dc_10_sse2;
+                    c->idct_dc[3]       = ff_hevc_idct_32x32_dc_10_sse2;
+                    c->transform_rdpcm  = ff_hevc_transform_rdpcm_sse2;
+                    c->cross_component_pred = ff_hevc_cross_component_pred_sse2;
                 }
 #endif // HAVE_SSE2
 #if HAVE_SSSE3
@@ -556,6 +575,7 @@ void ff_hevcdsp_init_x86(HEVCDSPContext *c, const int bit_depth)
                     c->hevc_v_loop_filter_luma = ff_hevc_v_loop_filter_luma_10_ssse3;
                     c->hevc_h_loop_filter_luma = ff_hevc_h_loop_filter_luma_10_ssse3;
 #endif
+                    c->transform_skip  = ff_hevc_transform_skip_10_ssse3;
 
                     EPEL_LINKS(c->put_hevc_epel, 0, 0, pel_pixels, 10, sse4);
                     EPEL_LINKS(c->put_hevc_epel, 0, 1, epel_h,     10, sse4);
@@ -607,8 +627,10 @@ void ff_hevcdsp_init_x86(HEVCDSPContext *c, const int bit_depth)
 #endif
 #if HAVE_SSE2
                 if (EXTERNAL_SSE2(mm_flags)) {
-                    //                    c->hevc_v_loop_filter_chroma = ff_hevc_v_loop_filter_chroma_10_sse2;
-                    //                    c->hevc_h_loop_filter_chroma = ff_hevc_h_loop_filter_chroma_10_sse2;
+                    c->hevc_v_loop_filter_chroma = ff_hevc_v_loop_filter_chroma_12_sse2;
+                    c->hevc_h_loop_filter_chroma = ff_hevc_h_loop_filter_chroma_12_sse2;
+                    c->hevc_v_loop_filter_luma_edge = ff_hevc_v_loop_filter_luma_edge_12_sse2;
+                    c->hevc_h_loop_filter_luma_edge = ff_hevc_h_loop_filter_luma_edge_12_sse2;
 
 #ifdef OPTI_ASM
                     //                    c->transform_dc_add[1]    =  ff_hevc_idct8_dc_add_10_sse2;
@@ -625,14 +647,21 @@ void ff_hevcdsp_init_x86(HEVCDSPContext *c, const int bit_depth)
                     c->transform_add[2] = ff_hevc_transform_16x16_add_12_sse4;
                     c->transform_add[3] = ff_hevc_transform_32x32_add_12_sse4;
 
+                    c->idct_dc[0]       = ff_hevc_idct_4x4_dc_12_sse2;
+                    c->idct_dc[1]       = ff_hevc_idct_8x8_dc_12_sse2;
+                    c->idct_dc[2]       = ff_hevc_idct_16x16_dc_12_sse2;
+                    c->idct_dc[3]       = ff_hevc_idct_32x32_dc_12_sse2;
+                    c->transform_rdpcm  = ff_hevc_transform_rdpcm_sse2;
+                    c->cross_component_pred = ff_hevc_cross_component_pred_sse2;
                 }
 #endif // HAVE_SSE2
 #if HAVE_SSSE3
                 if (EXTERNAL_SSSE3(mm_flags)) {
 #if ARCH_X86_64
-                    //                    c->hevc_v_loop_filter_luma = ff_hevc_v_loop_filter_luma_10_ssse3;
-                    //                    c->hevc_h_loop_filter_luma = ff_hevc_h_loop_filter_luma_10_ssse3;
+                    c->hevc_v_loop_filter_luma = ff_hevc_v_loop_filter_luma_12_ssse3;
+                    c->hevc_h_loop_filter_luma = ff_hevc_h_loop_filter_luma_12_ssse3;
 #endif
+                    c->transform_skip  = ff_hevc_transform_skip_12_ssse3;
 
                     EPEL_LINKS(c->put_hevc_epel, 0, 0, pel_pixels, 12, sse4);
                     EPEL_LINKS(c->put_hevc_epel, 0, 1, epel_h,     12, sse4);
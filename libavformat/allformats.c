@@ -64,5 +64,6 @@ void av_register_all(void)
     REGISTER_DEMUXER(MATROSKA, matroska);
 
 	/* protocols */
+	REGISTER_PROTOCOL(ASYNC, async);
 	REGISTER_PROTOCOL(FILE, file);
 }
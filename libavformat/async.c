@@ -0,0 +1,298 @@
+/*
+ * Asynchronous read-ahead protocol
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * Read the nested URL on a background thread, filling a ring buffer ahead
+ * of the consumer. Usage: async:<url>, e.g. async:file:stream.bit
+ */
+
+#include "config.h"
+
+#include "libavutil/avstring.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+#include "libavutil/time.h"
+#include "url.h"
+
+#if HAVE_PTHREADS
+#include <pthread.h>
+#elif HAVE_W32THREADS
+#include "compat/w32pthreads.h"
+#endif
+
+#define ASYNC_CHUNK_SIZE (256 * 1024)
+
+typedef struct AsyncContext {
+    const AVClass *class;
+    int depth;                  ///< bytes buffered ahead of the consumer
+    URLContext *inner;
+
+    uint8_t *ring;
+    int      read_idx;          ///< consumer position in ring
+    int      fill;              ///< bytes available from read_idx
+    int64_t  logical_pos;       ///< stream offset of ring[read_idx]
+    int64_t  logical_size;
+    int      io_eof;
+    int      io_error;
+
+    int64_t  seek_pos;          ///< seek requested from the worker, -1 if none
+    int64_t  seek_ret;
+    int      seek_count;        ///< completed seek requests
+    int      abort_request;
+
+    int64_t  stall_time;        ///< microseconds the consumer waited for data
+    int      stall_count;
+    int64_t  bytes_read;
+
+    pthread_t       worker;
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond_wakeup_main;
+    pthread_cond_t  cond_wakeup_worker;
+} AsyncContext;
+
+static void *async_worker(void *arg)
+{
+    URLContext   *h = arg;
+    AsyncContext *c = h->priv_data;
+
+    pthread_mutex_lock(&c->mutex);
+    while (!c->abort_request) {
+        int write_idx, len, ret;
+
+        if (c->seek_pos >= 0) {
+            int64_t pos = c->seek_pos;
+
+            pthread_mutex_unlock(&c->mutex);
+            pos = ffurl_seek(c->inner, pos, SEEK_SET);
+            pthread_mutex_lock(&c->mutex);
+            if (pos >= 0) {
+                /* everything buffered belongs to the old position */
+                c->logical_pos = pos;
+                c->read_idx    = 0;
+                c->fill        = 0;
+                c->io_eof      = 0;
+                c->io_error    = 0;
+            }
+            c->seek_ret = pos;
+            c->seek_pos = -1;
+            c->seek_count++;
+            pthread_cond_signal(&c->cond_wakeup_main);
+            continue;
+        }
+
+        if (c->io_eof || c->io_error || c->fill == c->depth) {
+            pthread_cond_wait(&c->cond_wakeup_worker, &c->mutex);
+            continue;
+        }
+
+        /* the consumer only advances read_idx and shrinks fill, so the free
+         * space after write_idx stays ours while the lock is released */
+        write_idx = (c->read_idx + c->fill) % c->depth;
+        len       = FFMIN(c->depth - c->fill, c->depth - write_idx);
+        len       = FFMIN(len, ASYNC_CHUNK_SIZE);
+
+        pthread_mutex_unlock(&c->mutex);
+        ret = ffurl_read(c->inner, c->ring + write_idx, len);
+        pthread_mutex_lock(&c->mutex);
+
+        if (c->seek_pos >= 0)
+            continue;
+        if (ret > 0)
+            c->fill += ret;
+        else if (!ret || ret == AVERROR_EOF)
+            c->io_eof = 1;
+        else
+            c->io_error = ret;
+        pthread_cond_signal(&c->cond_wakeup_main);
+    }
+    pthread_mutex_unlock(&c->mutex);
+
+    return NULL;
+}
+
+static int async_open(URLContext *h, const char *arg, int flags, AVDictionary **options)
+{
+    AsyncContext *c = h->priv_data;
+    int ret;
+
+    if (flags & AVIO_FLAG_WRITE)
+        return AVERROR(ENOSYS);
+
+    av_strstart(arg, "async:", &arg);
+    ret = ffurl_open(&c->inner, arg, flags, &h->interrupt_callback, options);
+    if (ret < 0)
+        return ret;
+
+    h->is_streamed  = c->inner->is_streamed;
+    c->logical_size = ffurl_size(c->inner);
+    c->seek_pos     = -1;
+
+    c->ring = av_malloc(c->depth);
+    if (!c->ring) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    pthread_mutex_init(&c->mutex, NULL);
+    pthread_cond_init(&c->cond_wakeup_main, NULL);
+    pthread_cond_init(&c->cond_wakeup_worker, NULL);
+    if ((ret = pthread_create(&c->worker, NULL, async_worker, h))) {
+        ret = AVERROR(ret);
+        pthread_cond_destroy(&c->cond_wakeup_worker);
+        pthread_cond_destroy(&c->cond_wakeup_main);
+        pthread_mutex_destroy(&c->mutex);
+        goto fail;
+    }
+
+    return 0;
+fail:
+    av_freep(&c->ring);
+    ffurl_close(c->inner);
+    return ret;
+}
+
+static int async_read(URLContext *h, unsigned char *buf, int size)
+{
+    AsyncContext *c = h->priv_data;
+    int len, ret = 0;
+
+    pthread_mutex_lock(&c->mutex);
+    if (!c->fill && !c->io_eof && !c->io_error) {
+        int64_t start = av_gettime();
+
+        while (!c->fill && !c->io_eof && !c->io_error)
+            pthread_cond_wait(&c->cond_wakeup_main, &c->mutex);
+        c->stall_time += av_gettime() - start;
+        c->stall_count++;
+    }
+
+    if (c->fill) {
+        len = FFMIN(size, c->fill);
+        len = FFMIN(len, c->depth - c->read_idx);
+        memcpy(buf, c->ring + c->read_idx, len);
+        c->read_idx     = (c->read_idx + len) % c->depth;
+        c->fill        -= len;
+        c->logical_pos += len;
+        c->bytes_read  += len;
+        ret = len;
+        pthread_cond_signal(&c->cond_wakeup_worker);
+    } else if (c->io_error) {
+        ret = c->io_error;
+    } else {
+        ret = AVERROR_EOF;
+    }
+    pthread_mutex_unlock(&c->mutex);
+
+    return ret;
+}
+
+static int64_t async_seek(URLContext *h, int64_t pos, int whence)
+{
+    AsyncContext *c = h->priv_data;
+    int64_t ret;
+    int seek_count;
+
+    if (whence == AVSEEK_SIZE)
+        return c->logical_size;
+
+    pthread_mutex_lock(&c->mutex);
+    if (whence == SEEK_CUR) {
+        pos += c->logical_pos;
+    } else if (whence == SEEK_END) {
+        if (c->logical_size < 0) {
+            pthread_mutex_unlock(&c->mutex);
+            return AVERROR(EINVAL);
+        }
+        pos += c->logical_size;
+    }
+    if (pos < 0) {
+        pthread_mutex_unlock(&c->mutex);
+        return AVERROR(EINVAL);
+    }
+
+    if (pos >= c->logical_pos && pos <= c->logical_pos + c->fill) {
+        /* forward seek inside the read-ahead data, just drop it */
+        int skip = pos - c->logical_pos;
+        c->read_idx     = (c->read_idx + skip) % c->depth;
+        c->fill        -= skip;
+        c->logical_pos  = pos;
+        pthread_cond_signal(&c->cond_wakeup_worker);
+        pthread_mutex_unlock(&c->mutex);
+        return pos;
+    }
+
+    seek_count  = c->seek_count;
+    c->seek_pos = pos;
+    pthread_cond_signal(&c->cond_wakeup_worker);
+    while (seek_count == c->seek_count)
+        pthread_cond_wait(&c->cond_wakeup_main, &c->mutex);
+    ret = c->seek_ret;
+    pthread_mutex_unlock(&c->mutex);
+
+    return ret;
+}
+
+static int async_close(URLContext *h)
+{
+    AsyncContext *c = h->priv_data;
+
+    pthread_mutex_lock(&c->mutex);
+    c->abort_request = 1;
+    pthread_cond_signal(&c->cond_wakeup_worker);
+    pthread_mutex_unlock(&c->mutex);
+    pthread_join(c->worker, NULL);
+
+    pthread_cond_destroy(&c->cond_wakeup_worker);
+    pthread_cond_destroy(&c->cond_wakeup_main);
+    pthread_mutex_destroy(&c->mutex);
+
+    av_log(h, AV_LOG_VERBOSE,
+           "Statistics: %"PRId64" bytes read, %d stalls, %"PRId64" us stalled\n",
+           c->bytes_read, c->stall_count, c->stall_time);
+
+    av_freep(&c->ring);
+    return ffurl_close(c->inner);
+}
+
+#define OFFSET(x) offsetof(AsyncContext, x)
+#define D AV_OPT_FLAG_DECODING_PARAM
+static const AVOption options[] = {
+    { "async_depth", "bytes read ahead of the consumer", OFFSET(depth), AV_OPT_TYPE_INT, { .i64 = 8 << 20 }, ASYNC_CHUNK_SIZE, INT_MAX, D },
+    { NULL }
+};
+
+static const AVClass async_context_class = {
+    .class_name = "async",
+    .item_name  = av_default_item_name,
+    .option     = options,
+    .version    = LIBAVUTIL_VERSION_INT,
+};
+
+URLProtocol ff_async_protocol = {
+    .name            = "async",
+    .url_open2       = async_open,
+    .url_read        = async_read,
+    .url_seek        = async_seek,
+    .url_close       = async_close,
+    .priv_data_size  = sizeof(AsyncContext),
+    .priv_data_class = &async_context_class,
+    .flags           = URL_PROTOCOL_FLAG_NESTED_SCHEME,
+};
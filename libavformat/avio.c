@@ -341,6 +341,16 @@ int ffurl_read_complete(URLContext *h, unsigned char *buf, int size)
     return retry_transfer_wrapper(h, buf, size, size, h->prot->url_read);
 }
 
+int ffurl_read_view(URLContext *h, int64_t pos, int size,
+                    AVBufferRef **buf, uint8_t **data)
+{
+    if (!(h->flags & AVIO_FLAG_READ))
+        return AVERROR(EIO);
+    if (!h->prot->url_read_view)
+        return AVERROR(ENOSYS);
+    return h->prot->url_read_view(h, pos, size, buf, data);
+}
+
 int ffurl_write(URLContext *h, const unsigned char *buf, int size)
 {
     if (!(h->flags & AVIO_FLAG_WRITE))
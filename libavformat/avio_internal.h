@@ -62,6 +62,18 @@ int ffio_read_indirect(AVIOContext *s, unsigned char *buf, int size, const unsig
  */
 int ffio_read_partial(AVIOContext *s, unsigned char *buf, int size);
 
+/**
+ * Reference up to size bytes from AVIOContext without copying them and
+ * advance the read position past them.
+ * Only available for contexts opened on a protocol providing views, such
+ * as the file protocol with the mmap option.
+ * @param buf set to a new reference keeping the data alive
+ * @param data set to the first byte read
+ * @return number of bytes referenced, 0 at end of file, AVERROR(ENOSYS)
+ *         if views are not available or AVERROR
+ */
+int ffio_read_view(AVIOContext *s, int size, AVBufferRef **buf, uint8_t **data);
+
 void ffio_fill(AVIOContext *s, int b, int count);
 
 static av_always_inline void ffio_wfourcc(AVIOContext *pb, const uint8_t *s)
@@ -611,6 +611,30 @@ int ffio_read_partial(AVIOContext *s, unsigned char *buf, int size)
     return len;
 }
 
+int ffio_read_view(AVIOContext *s, int size, AVBufferRef **buf, uint8_t **data)
+{
+    int64_t ret;
+    int len;
+
+    if (s->read_packet != (void*)ffurl_read || s->write_flag || s->update_checksum)
+        return AVERROR(ENOSYS);
+
+    len = ffurl_read_view(s->opaque, avio_tell(s), size, buf, data);
+    if (len <= 0) {
+        if (!len)
+            s->eof_reached = 1;
+        return len;
+    }
+
+    ret = avio_skip(s, len);
+    if (ret < 0) {
+        av_buffer_unref(buf);
+        return ret;
+    }
+    s->bytes_read += len;
+    return len;
+}
+
 unsigned int avio_rl16(AVIOContext *s)
 {
     unsigned int val;
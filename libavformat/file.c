@@ -32,6 +32,9 @@
 #endif
 #include <sys/stat.h>
 #include <stdlib.h>
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
 #include "os_support.h"
 #include "url.h"
 
@@ -51,11 +54,19 @@ typedef struct FileContext {
     int fd;
     int trunc;
     int blocksize;
+    int use_mmap;
+    int readahead;
+    AVBufferRef *map;   ///< read-only mapping of the whole file, shared with views
+    int64_t map_size;
+    int64_t map_pos;    ///< read position inside the mapping
+    int64_t advised;    ///< end of the range already announced with MADV_WILLNEED
 } FileContext;
 
 static const AVOption file_options[] = {
     { "truncate", "truncate existing files on write", offsetof(FileContext, trunc), AV_OPT_TYPE_INT, { .i64 = 1 }, 0, 1, AV_OPT_FLAG_ENCODING_PARAM },
     { "blocksize", "set I/O operation maximum block size", offsetof(FileContext, blocksize), AV_OPT_TYPE_INT, { .i64 = INT_MAX }, 1, INT_MAX, AV_OPT_FLAG_ENCODING_PARAM },
+    { "mmap", "map regular files into memory when reading", offsetof(FileContext, use_mmap), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 1, AV_OPT_FLAG_DECODING_PARAM },
+    { "readahead", "bytes ahead of the read position to prefetch when mapped", offsetof(FileContext, readahead), AV_OPT_TYPE_INT, { .i64 = 8 << 20 }, 0, INT_MAX, AV_OPT_FLAG_DECODING_PARAM },
     { NULL }
 };
 
@@ -78,15 +89,103 @@ static const AVClass pipe_class = {
     .version    = LIBAVUTIL_VERSION_INT,
 };
 
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+static void file_unmap(void *opaque, uint8_t *data)
+{
+    munmap(data, (size_t)(uintptr_t)opaque);
+}
+
+static int file_map(URLContext *h, struct stat *st)
+{
+    FileContext *c = h->priv_data;
+    void *map;
+
+    if (!S_ISREG(st->st_mode) || st->st_size <= 0 || st->st_size > SIZE_MAX)
+        return AVERROR(ENOSYS);
+
+    map = mmap(NULL, st->st_size, PROT_READ, MAP_SHARED, c->fd, 0);
+    if (map == MAP_FAILED)
+        return AVERROR(errno);
+#ifdef MADV_SEQUENTIAL
+    madvise(map, st->st_size, MADV_SEQUENTIAL);
+#endif
+
+    /* the buffer size is informative only, the real length is kept in opaque */
+    c->map = av_buffer_create(map, FFMIN(st->st_size, INT_MAX), file_unmap,
+                              (void *)(uintptr_t)st->st_size, AV_BUFFER_FLAG_READONLY);
+    if (!c->map) {
+        munmap(map, st->st_size);
+        return AVERROR(ENOMEM);
+    }
+    c->map_size = st->st_size;
+    c->map_pos  = 0;
+    c->advised  = 0;
+    return 0;
+}
+
+/* Keep the kernel readahead window in front of the consumer. */
+static void file_advise(FileContext *c, int64_t end)
+{
+#ifdef MADV_WILLNEED
+    int64_t page = 4096, start;
+
+    end = FFMIN(end + c->readahead, c->map_size);
+    if (!c->readahead || end - c->advised < c->readahead / 2)
+        return;
+#if HAVE_SYSCONF && defined(_SC_PAGESIZE)
+    page = sysconf(_SC_PAGESIZE);
+#endif
+    start = FFMAX(c->advised, c->map_pos) & ~(page - 1);
+    if (end > start)
+        madvise(c->map->data + start, end - start, MADV_WILLNEED);
+    c->advised = end;
+#endif
+}
+#endif
+
 static int file_read(URLContext *h, unsigned char *buf, int size)
 {
     FileContext *c = h->priv_data;
     int r;
     size = FFMIN(size, c->blocksize);
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+    if (c->map) {
+        if (c->map_pos >= c->map_size)
+            return 0;
+        size = FFMIN(size, c->map_size - c->map_pos);
+        file_advise(c, c->map_pos + size);
+        memcpy(buf, c->map->data + c->map_pos, size);
+        c->map_pos += size;
+        return size;
+    }
+#endif
     r = read(c->fd, buf, size);
     return (-1 == r)?AVERROR(errno):r;
 }
 
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+static int file_read_view(URLContext *h, int64_t pos, int size,
+                          AVBufferRef **buf, uint8_t **data)
+{
+    FileContext *c = h->priv_data;
+
+    if (!c->map)
+        return AVERROR(ENOSYS);
+    if (pos < 0)
+        return AVERROR(EINVAL);
+    if (pos >= c->map_size)
+        return 0;
+
+    size = FFMIN(size, c->map_size - pos);
+    file_advise(c, pos + size);
+    *buf = av_buffer_ref(c->map);
+    if (!*buf)
+        return AVERROR(ENOMEM);
+    *data = c->map->data + pos;
+    return size;
+}
+#endif
+
 static int file_write(URLContext *h, const unsigned char *buf, int size)
 {
     FileContext *c = h->priv_data;
@@ -163,6 +262,14 @@ static int file_open(URLContext *h, const char *filename, int flags)
 
     h->is_streamed = !fstat(fd, &st) && S_ISFIFO(st.st_mode);
 
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+    if (c->use_mmap && access == O_RDONLY && !h->is_streamed) {
+        int ret = file_map(h, &st);
+        if (ret < 0)
+            av_log(h, AV_LOG_VERBOSE, "Falling back to read(), cannot map %s\n", filename);
+    }
+#endif
+
     return 0;
 }
 
@@ -178,6 +285,20 @@ static int64_t file_seek(URLContext *h, int64_t pos, int whence)
         return ret < 0 ? AVERROR(errno) : (S_ISFIFO(st.st_mode) ? 0 : st.st_size);
     }
 
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+    if (c->map) {
+        if (whence == SEEK_CUR)
+            pos += c->map_pos;
+        else if (whence == SEEK_END)
+            pos += c->map_size;
+        if (pos < 0)
+            return AVERROR(EINVAL);
+        c->map_pos = pos;
+        c->advised = FFMIN(c->advised, pos);
+        return pos;
+    }
+#endif
+
     ret = lseek(c->fd, pos, whence);
 
     return ret < 0 ? AVERROR(errno) : ret;
@@ -186,6 +307,8 @@ static int64_t file_seek(URLContext *h, int64_t pos, int whence)
 static int file_close(URLContext *h)
 {
     FileContext *c = h->priv_data;
+    /* the mapping stays alive as long as views reference it */
+    av_buffer_unref(&c->map);
     return close(c->fd);
 }
 
@@ -200,6 +323,9 @@ URLProtocol ff_file_protocol = {
     .url_check           = file_check,
     .priv_data_size      = sizeof(FileContext),
     .priv_data_class     = &file_class,
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+    .url_read_view       = file_read_view,
+#endif
 };
 
 #endif /* CONFIG_FILE_PROTOCOL */
@@ -22,8 +22,26 @@
 #include "libavcodec/hevc.h"
 
 #include "avformat.h"
+#include "avio_internal.h"
+#include "internal.h"
 #include "rawdec.h"
 
+#define HEVC_BLOCK_SIZE (1 << 20)
+
+typedef struct HEVCDemuxContext {
+    FFRawVideoDemuxerContext raw; ///< must be first, shared with ff_raw_video_read_header
+    AVBufferRef *block;           ///< current read block, packets reference it
+    uint8_t *base;                ///< first byte of the block data
+    int64_t  block_pos;           ///< file offset of base[0]
+    int      is_view;             ///< block is a zero-copy view of the input
+    int      size;                ///< valid bytes in block
+    int      start;               ///< first byte of the access unit being scanned
+    int      scan;                ///< next byte to be scanned
+    uint32_t state;               ///< start code search state
+    int      frame_start_found;
+    int      eof;
+} HEVCDemuxContext;
+
 static int hevc_probe(AVProbeData *p)
 {
     uint32_t code = -1;
@@ -61,4 +79,239 @@ static int hevc_probe(AVProbeData *p)
     return 0;
 }
 
-FF_DEF_RAWVIDEO_DEMUXER(hevc, "raw HEVC video", hevc_probe, "hevc,h265,265", AV_CODEC_ID_HEVC)
+static void hevc_reset(HEVCDemuxContext *h, int64_t pos)
+{
+    av_buffer_unref(&h->block);
+    h->base              = NULL;
+    h->is_view           = 0;
+    h->block_pos         = pos;
+    h->size              = 0;
+    h->start             = 0;
+    h->scan              = 0;
+    h->state             = -1;
+    h->frame_start_found = 0;
+    h->eof               = 0;
+}
+
+static int hevc_read_header(AVFormatContext *s)
+{
+    int ret = ff_raw_video_read_header(s);
+    if (ret < 0)
+        return ret;
+
+    /* packets are complete access units, the parser only reads the headers */
+    s->streams[0]->need_parsing = AVSTREAM_PARSE_HEADERS;
+    hevc_reset(s->priv_data, avio_tell(s->pb));
+    return 0;
+}
+
+/**
+ * Find the end of the access unit starting at h->start.
+ * @return the offset of the first byte of the next access unit in the block,
+ *         or -1 if more data is needed
+ */
+static int hevc_find_au_end(HEVCDemuxContext *h)
+{
+    const uint8_t *buf = h->base;
+    const uint8_t *end = buf + h->size;
+    const uint8_t *p   = buf + h->scan;
+
+    while (p < end) {
+        int nut, layer_id, au_end;
+
+        p = avpriv_find_start_code(p, end, &h->state);
+        if ((h->state & 0xFFFFFF00) != 0x100)
+            break;
+        /* the second NAL header byte and the first slice segment flag */
+        if (end - p < 2) {
+            p -= 4;
+            break;
+        }
+
+        nut      = (h->state >> 1) & 0x3F;
+        layer_id = ((h->state & 0x01) << 5) | (p[0] >> 3);
+        au_end   = p - 4 - buf;
+        if (au_end > h->start && !buf[au_end - 1])
+            au_end--;
+
+        if ((nut >= NAL_VPS && nut <= NAL_AUD) || nut == NAL_SEI_PREFIX ||
+            (nut >= 41 && nut <= 44) || (nut >= 48 && nut <= 55)) {
+            if (h->frame_start_found && !layer_id) {
+                h->frame_start_found = 0;
+                h->scan              = p - buf;
+                return au_end;
+            }
+        } else if (nut <= NAL_RASL_R ||
+                   (nut >= NAL_BLA_W_LP && nut <= NAL_CRA_NUT)) {
+            int first_slice_segment_in_pic_flag = p[1] >> 7;
+            if (first_slice_segment_in_pic_flag && !layer_id) {
+                if (h->frame_start_found) {
+                    h->scan = p - buf;
+                    return au_end;
+                }
+                h->frame_start_found = 1;
+            }
+        }
+    }
+    /* rescan a start code that may straddle the end of the data */
+    h->scan  = FFMAX(FFMIN(p - buf, h->size - 3), h->start);
+    h->state = -1;
+    return -1;
+}
+
+/**
+ * Extend the block with a view of the next bytes of the input when the
+ * protocol exposes them as memory. Consecutive views of a mapping are
+ * contiguous, so the pending access unit never needs to be copied.
+ */
+static int hevc_refill_view(AVFormatContext *s, HEVCDemuxContext *h)
+{
+    AVBufferRef *buf;
+    uint8_t *data;
+    int ret = ffio_read_view(s->pb, HEVC_BLOCK_SIZE, &buf, &data);
+
+    if (ret == AVERROR_EOF || !ret) {
+        h->eof = 1;
+        return 0;
+    } else if (ret < 0) {
+        return ret;
+    }
+
+    if (!h->block) {
+        h->block   = buf;
+        h->base    = data;
+        h->is_view = 1;
+    } else {
+        av_buffer_unref(&buf);
+        if (data != h->base + h->size)
+            return AVERROR_BUG;
+        /* keep the offsets small, the mapping can be larger than INT_MAX */
+        h->base      += h->start;
+        h->block_pos += h->start;
+        h->scan      -= h->start;
+        h->size      -= h->start;
+        h->start      = 0;
+    }
+    h->size += ret;
+    return ret;
+}
+
+/**
+ * Make room for more input, moving the pending access unit to the head of
+ * a new block when the current one is full or a packet references it.
+ * A referenced block is never written again.
+ */
+static int hevc_refill(AVFormatContext *s, HEVCDemuxContext *h)
+{
+    int pending = h->size - h->start;
+    int ret;
+
+    if (!h->block || h->is_view) {
+        ret = hevc_refill_view(s, h);
+        if (ret != AVERROR(ENOSYS))
+            return ret;
+    }
+
+    if (!h->block || !av_buffer_is_writable(h->block) ||
+        h->block->size - FF_INPUT_BUFFER_PADDING_SIZE - h->size < HEVC_BLOCK_SIZE / 4) {
+        int size = FFMAX(HEVC_BLOCK_SIZE, 2 * pending);
+        AVBufferRef *block = av_buffer_alloc(size + FF_INPUT_BUFFER_PADDING_SIZE);
+        if (!block)
+            return AVERROR(ENOMEM);
+        if (pending)
+            memcpy(block->data, h->base + h->start, pending);
+        av_buffer_unref(&h->block);
+        h->block      = block;
+        h->base       = block->data;
+        h->block_pos += h->start;
+        h->scan      -= h->start;
+        h->size       = pending;
+        h->start      = 0;
+    }
+
+    ret = avio_read(s->pb, h->base + h->size,
+                    h->block->size - FF_INPUT_BUFFER_PADDING_SIZE - h->size);
+    if (ret == AVERROR_EOF || !ret) {
+        h->eof = 1;
+        ret    = 0;
+    } else if (ret < 0) {
+        return ret;
+    }
+    h->size += ret;
+    memset(h->base + h->size, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+    return ret;
+}
+
+static int hevc_read_packet(AVFormatContext *s, AVPacket *pkt)
+{
+    HEVCDemuxContext *h = s->priv_data;
+    int au_end, ret;
+
+    /* the generic seeking code moved the I/O context under us */
+    if (avio_tell(s->pb) != h->block_pos + h->size)
+        hevc_reset(h, avio_tell(s->pb));
+
+    while ((au_end = h->block ? hevc_find_au_end(h) : -1) < 0) {
+        if (h->eof) {
+            if (h->size == h->start)
+                return AVERROR_EOF;
+            au_end = h->size;
+            break;
+        }
+        if ((ret = hevc_refill(s, h)) < 0)
+            return ret;
+    }
+
+    /* a view must be followed by readable padding: extend it, the scan
+     * state is kept, and copy the access unit only at the end of the file */
+    if (h->is_view && !h->eof && h->size - au_end < FF_INPUT_BUFFER_PADDING_SIZE) {
+        int start = h->start;
+        if ((ret = hevc_refill(s, h)) < 0)
+            return ret;
+        au_end -= start - h->start;
+    }
+
+    if (h->is_view && h->size - au_end < FF_INPUT_BUFFER_PADDING_SIZE) {
+        if ((ret = ff_packet_pool_new_packet(s, pkt, au_end - h->start)) < 0)
+            return ret;
+        memcpy(pkt->data, h->base + h->start, pkt->size);
+    } else {
+        /* The bytes after the access unit are the next one rather than
+         * zeros, as after any NAL unit but the last of an access unit.
+         * They are readable, which is what the bitstream readers need,
+         * and a read block itself ends in zeroed padding. A view holds a
+         * reference to the mapping, which outlives the demuxer. */
+        av_init_packet(pkt);
+        pkt->buf = av_buffer_ref(h->block);
+        if (!pkt->buf)
+            return AVERROR(ENOMEM);
+        pkt->data = h->base + h->start;
+        pkt->size = au_end - h->start;
+    }
+    pkt->pos          = h->block_pos + h->start;
+    pkt->stream_index = 0;
+    h->start          = au_end;
+    return pkt->size;
+}
+
+static int hevc_read_close(AVFormatContext *s)
+{
+    HEVCDemuxContext *h = s->priv_data;
+    av_buffer_unref(&h->block);
+    return 0;
+}
+
+FF_RAWVIDEO_DEMUXER_CLASS(hevc)
+AVInputFormat ff_hevc_demuxer = {
+    .name           = "hevc",
+    .long_name      = NULL_IF_CONFIG_SMALL("raw HEVC video"),
+    .read_probe     = hevc_probe,
+    .read_header    = hevc_read_header,
+    .read_packet    = hevc_read_packet,
+    .read_close     = hevc_read_close,
+    .extensions     = "hevc,h265,265",
+    .flags          = AVFMT_GENERIC_INDEX,
+    .raw_codec_id   = AV_CODEC_ID_HEVC,
+    .priv_data_size = sizeof(HEVCDemuxContext),
+    .priv_class     = &hevc_demuxer_class,
+};
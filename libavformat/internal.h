@@ -31,6 +31,11 @@
 #define PROBE_BUF_MIN 2048
 #define PROBE_BUF_MAX (1 << 20)
 
+/** packet payload pools: one 1 KiB class, then 4 classes per octave up to 4 MiB */
+#define PACKET_POOL_MIN_SIZE (1 << 10)
+#define PACKET_POOL_MAX_SIZE (1 << 22)
+#define PACKET_POOL_CLASSES  (1 + 4 * 12)
+
 #ifdef DEBUG
 #    define hex_dump_debug(class, buf, size) av_hex_dump_log(class, AV_LOG_DEBUG, buf, size)
 #else
@@ -55,6 +60,20 @@ struct AVFormatInternal {
     int nb_interleaved_streams;
 
     int inject_global_side_data;
+
+    /**
+     * Pools of the demuxed packet payloads, see ff_packet_pool_get().
+     * Demuxing only.
+     */
+    AVBufferPool *packet_pools[PACKET_POOL_CLASSES];
+
+    /**
+     * Payloads requested from the packet pools, and those that had to be
+     * allocated because no buffer was free, logged when the context is freed.
+     * Demuxing only.
+     */
+    int64_t packet_pool_requests;
+    int64_t packet_pool_misses;
 };
 
 #ifdef __GNUC__
@@ -312,6 +331,34 @@ int ff_framehash_write_header(AVFormatContext *s);
  */
 int ff_read_packet(AVFormatContext *s, AVPacket *pkt);
 
+/**
+ * Get a buffer of at least size bytes from the packet payload pools of s.
+ * The size is rounded up to its size class, by at most 25%, and the
+ * contents are undefined. The pools are freed with the context once every
+ * buffer has been returned.
+ *
+ * @param s media file handle, NULL for a plain allocation
+ */
+AVBufferRef *ff_packet_pool_get(AVFormatContext *s, int size);
+
+/**
+ * av_new_packet() with the payload taken from the packet pools of s.
+ */
+int ff_packet_pool_new_packet(AVFormatContext *s, AVPacket *pkt, int size);
+
+/**
+ * av_get_packet() with the payload taken from the packet pools of s.
+ */
+int ff_packet_pool_get_packet(AVFormatContext *s, AVIOContext *pb,
+                              AVPacket *pkt, int size);
+
+/**
+ * av_dup_packet() with the payload taken from the packet pools of s.
+ * Nothing in libavformat sets the deprecated destruct callback, so a packet
+ * without a buffer reference points to data owned by a parser or demuxer.
+ */
+int ff_packet_pool_dup_packet(AVFormatContext *s, AVPacket *pkt);
+
 /**
  * Interleave a packet per dts in an output media file.
  *
@@ -94,6 +94,28 @@ typedef struct MOVSbgp {
     unsigned int index;
 } MOVSbgp;
 
+/**
+ * Position in a walk over the stco/stsc/stsz/stts/stss tables,
+ * one sample at a time.
+ */
+typedef struct MOVSampleCursor {
+    unsigned int entry;             ///< index of the next sample handed out
+    unsigned int sample;            ///< next sample in stsz order
+    unsigned int chunk;
+    unsigned int chunk_sample;      ///< samples already taken from chunk
+    unsigned int stsc_index;
+    unsigned int stts_index;
+    unsigned int stts_sample;
+    unsigned int stss_index;
+    unsigned int stps_index;
+    unsigned int rap_group_index;
+    unsigned int rap_group_sample;
+    unsigned int distance;          ///< samples since the last keyframe
+    int64_t offset;
+    int64_t dts;
+    uint64_t stream_size;           ///< bytes of all samples walked so far
+} MOVSampleCursor;
+
 typedef struct MOVFragmentIndexItem {
     int64_t moof_offset;
     int64_t time;
@@ -161,6 +183,16 @@ typedef struct MOVStreamContext {
     int64_t duration_for_fps;
 
     int32_t *display_matrix;
+
+    int lazy_index;       ///< index_entries only holds seek points, samples come from the tables
+    unsigned int lazy_sample_count; ///< sample count, lowered if the tables end early
+    MOVSampleCursor lazy_start;     ///< cursor on the first sample
+    MOVSampleCursor *lazy_points;   ///< cursors on the samples in index_entries
+    unsigned int lazy_points_size;  ///< allocated size of lazy_points in bytes
+    MOVSampleCursor lazy_walk;      ///< cursor after the last sample checked for a seek point
+    int64_t lazy_last_point;        ///< sample number of the last seek point
+    MOVSampleCursor lazy_cursor;    ///< cursor behind lazy_entry
+    AVIndexEntry lazy_entry;        ///< sample number current_sample
 } MOVStreamContext;
 
 typedef struct MOVContext {
@@ -189,6 +221,7 @@ typedef struct MOVContext {
     int has_looked_for_mfra;
     MOVFragmentIndex** fragment_index_data;
     unsigned fragment_index_count;
+    int lazy_index;         ///< sample count from which a track is indexed lazily, 0 for never
 } MOVContext;
 
 int ff_mp4_read_descr_len(AVIOContext *pb);
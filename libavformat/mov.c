@@ -2230,17 +2230,259 @@ static int mov_read_sbgp(MOVContext *c, AVIOContext *pb, MOVAtom atom)
     return pb->eof_reached ? AVERROR_EOF : 0;
 }
 
+static void mov_cursor_enter_chunk(MOVContext *mov, MOVStreamContext *sc,
+                                   MOVSampleCursor *c)
+{
+    int64_t next_offset = c->chunk + 1 < sc->chunk_count ?
+                          sc->chunk_offsets[c->chunk + 1] : INT64_MAX;
+
+    c->offset       = sc->chunk_offsets[c->chunk];
+    c->chunk_sample = 0;
+    while (c->stsc_index + 1 < sc->stsc_count &&
+           c->chunk + 1 == sc->stsc_data[c->stsc_index + 1].first)
+        c->stsc_index++;
+
+    if (next_offset > c->offset && sc->sample_size>0 && sc->sample_size < sc->stsz_sample_size &&
+        sc->stsc_data[c->stsc_index].count * (int64_t)sc->stsz_sample_size > next_offset - c->offset) {
+        av_log(mov->fc, AV_LOG_WARNING, "STSZ sample size %d invalid (too large), ignoring\n", sc->stsz_sample_size);
+        sc->stsz_sample_size = sc->sample_size;
+    }
+    if (sc->stsz_sample_size>0 && sc->stsz_sample_size < sc->sample_size) {
+        av_log(mov->fc, AV_LOG_WARNING, "STSZ sample size %d invalid (too small), ignoring\n", sc->stsz_sample_size);
+        sc->stsz_sample_size = sc->sample_size;
+    }
+}
+
+static void mov_cursor_init(MOVContext *mov, AVStream *st, MOVSampleCursor *c,
+                            int64_t dts)
+{
+    MOVStreamContext *sc = st->priv_data;
+
+    memset(c, 0, sizeof(*c));
+    c->dts = dts;
+    if (sc->chunk_count)
+        mov_cursor_enter_chunk(mov, sc, c);
+}
+
+/**
+ * Walk the sample tables up to the next sample of this stream.
+ * @return 0 with e filled in, AVERROR_EOF after the last sample
+ */
+static int mov_cursor_next(MOVContext *mov, AVStream *st, MOVSampleCursor *c,
+                           AVIndexEntry *e)
+{
+    MOVStreamContext *sc = st->priv_data;
+    int rap_group_present = sc->rap_group_count && sc->rap_group;
+    int key_off = (sc->keyframe_count && sc->keyframes[0] > 0) || (sc->stps_count && sc->stps_data[0] > 0);
+
+    for (;;) {
+        unsigned int sample_size;
+        int keyframe = 0, found;
+
+        while (c->chunk < sc->chunk_count &&
+               c->chunk_sample >= sc->stsc_data[c->stsc_index].count) {
+            if (++c->chunk < sc->chunk_count)
+                mov_cursor_enter_chunk(mov, sc, c);
+        }
+        if (c->chunk >= sc->chunk_count)
+            return AVERROR_EOF;
+
+        if (c->sample >= sc->sample_count) {
+            av_log(mov->fc, AV_LOG_ERROR, "wrong sample count\n");
+            return AVERROR_INVALIDDATA;
+        }
+
+        if (!sc->keyframe_absent && (!sc->keyframe_count || c->sample+key_off == sc->keyframes[c->stss_index])) {
+            keyframe = 1;
+            if (c->stss_index + 1 < sc->keyframe_count)
+                c->stss_index++;
+        } else if (sc->stps_count && c->sample+key_off == sc->stps_data[c->stps_index]) {
+            keyframe = 1;
+            if (c->stps_index + 1 < sc->stps_count)
+                c->stps_index++;
+        }
+        if (rap_group_present && c->rap_group_index < sc->rap_group_count) {
+            if (sc->rap_group[c->rap_group_index].index > 0)
+                keyframe = 1;
+            if (++c->rap_group_sample == sc->rap_group[c->rap_group_index].count) {
+                c->rap_group_sample = 0;
+                c->rap_group_index++;
+            }
+        }
+        if (sc->keyframe_absent
+            && !sc->stps_count
+            && !rap_group_present
+            && (st->codec->codec_type == AVMEDIA_TYPE_AUDIO || (c->chunk == 0 && c->chunk_sample == 0)))
+             keyframe = 1;
+        if (keyframe)
+            c->distance = 0;
+        sample_size = sc->stsz_sample_size > 0 ? sc->stsz_sample_size : sc->sample_sizes[c->sample];
+        found = sc->pseudo_stream_id == -1 ||
+                sc->stsc_data[c->stsc_index].id - 1 == sc->pseudo_stream_id;
+        if (found) {
+            e->pos = c->offset;
+            e->timestamp = c->dts;
+            e->size = sample_size;
+            e->min_distance = c->distance;
+            e->flags = keyframe ? AVINDEX_KEYFRAME : 0;
+            av_dlog(mov->fc, "AVIndex stream %d, sample %d, offset %"PRIx64", dts %"PRId64", "
+                    "size %d, distance %d, keyframe %d\n", st->index, c->sample,
+                    c->offset, c->dts, sample_size, c->distance, keyframe);
+            c->entry++;
+        }
+
+        c->offset += sample_size;
+        c->stream_size += sample_size;
+        c->dts += sc->stts_data[c->stts_index].duration;
+        c->distance++;
+        c->stts_sample++;
+        c->sample++;
+        c->chunk_sample++;
+        if (c->stts_index + 1 < sc->stts_count && c->stts_sample == sc->stts_data[c->stts_index].count) {
+            c->stts_sample = 0;
+            c->stts_index++;
+        }
+        if (found)
+            return 0;
+    }
+}
+
+/* samples between two seek points of a lazily indexed track, at least */
+#define MOV_LAZY_INDEX_INTERVAL 32
+
+/**
+ * Account for the sample e, read from the cursor prev up to c, in the seek
+ * points: keyframes at least MOV_LAZY_INDEX_INTERVAL samples apart are kept.
+ * Samples must be passed in order, starting after sc->lazy_walk.
+ */
+static int mov_lazy_add_sample(AVStream *st, const MOVSampleCursor *prev,
+                               const MOVSampleCursor *c, const AVIndexEntry *e)
+{
+    MOVStreamContext *sc = st->priv_data;
+    MOVSampleCursor *points;
+    AVIndexEntry *entries;
+
+    sc->lazy_walk = *c;
+    if (!(e->flags & AVINDEX_KEYFRAME) ||
+        (int64_t)prev->entry - sc->lazy_last_point < MOV_LAZY_INDEX_INTERVAL)
+        return 0;
+
+    entries = av_fast_realloc(st->index_entries, &st->index_entries_allocated_size,
+                              (st->nb_index_entries + 1) * sizeof(*entries));
+    if (!entries)
+        return AVERROR(ENOMEM);
+    st->index_entries = entries;
+    points = av_fast_realloc(sc->lazy_points, &sc->lazy_points_size,
+                             (st->nb_index_entries + 1) * sizeof(*points));
+    if (!points)
+        return AVERROR(ENOMEM);
+    sc->lazy_points = points;
+
+    st->index_entries[st->nb_index_entries] = *e;
+    sc->lazy_points[st->nb_index_entries++] = *prev;
+    sc->lazy_last_point = prev->entry;
+    return 0;
+}
+
+/**
+ * Extend the seek points of a lazily indexed track up to the first sample
+ * later than timestamp.
+ */
+static int mov_lazy_walk(MOVContext *mov, AVStream *st, int64_t timestamp)
+{
+    MOVStreamContext *sc = st->priv_data;
+    MOVSampleCursor c = sc->lazy_walk, prev;
+    AVIndexEntry e;
+    int ret;
+
+    while (c.entry < sc->lazy_sample_count) {
+        prev = c;
+        if (mov_cursor_next(mov, st, &c, &e) < 0) {
+            sc->lazy_sample_count = c.entry;
+            break;
+        }
+        if ((ret = mov_lazy_add_sample(st, &prev, &c, &e)) < 0)
+            return ret;
+        if (e.timestamp > timestamp)
+            break;
+    }
+    return 0;
+}
+
+/**
+ * Set up a track to be read through a cursor on its sample tables instead
+ * of a full index. The tables are not walked here: the seek points are
+ * collected as packets are read, and ahead of that when seeking.
+ */
+static int mov_build_lazy_index(MOVContext *mov, AVStream *st, int64_t dts)
+{
+    MOVStreamContext *sc = st->priv_data;
+    MOVSampleCursor c;
+    AVIndexEntry e;
+    int64_t stream_size = 0;
+    unsigned int i;
+
+    mov_cursor_init(mov, st, &c, dts);
+    sc->lazy_index        = 1;
+    sc->lazy_sample_count = sc->sample_count;
+    sc->lazy_start        = c;
+    sc->lazy_walk         = c;
+    sc->lazy_last_point   = -MOV_LAZY_INDEX_INTERVAL;
+
+    if (st->codec->codec_type == AVMEDIA_TYPE_VIDEO)
+        while (c.entry < 99 && mov_cursor_next(mov, st, &c, &e) >= 0)
+            ff_rfps_add_frame(mov->fc, st, e.timestamp);
+
+    sc->lazy_cursor = sc->lazy_start;
+    if (mov_cursor_next(mov, st, &sc->lazy_cursor, &sc->lazy_entry) < 0)
+        sc->lazy_sample_count = 0;
+    else if (mov_lazy_add_sample(st, &sc->lazy_start, &sc->lazy_cursor, &sc->lazy_entry) < 0)
+        return AVERROR(ENOMEM);
+
+    if (st->duration > 0) {
+        if (sc->stsz_sample_size > 0)
+            stream_size = (int64_t)sc->stsz_sample_size * sc->sample_count;
+        else
+            for (i = 0; i < sc->sample_count; i++)
+                stream_size += sc->sample_sizes[i];
+        st->codec->bit_rate = stream_size*8*sc->time_scale/st->duration;
+    }
+
+    av_log(mov->fc, AV_LOG_VERBOSE, "stream %d: %u samples read through the sample tables\n",
+           st->index, sc->lazy_sample_count);
+    return 0;
+}
+
+/* expand the index of a lazily indexed track into one entry per sample */
+static int mov_fill_index(MOVContext *mov, AVStream *st)
+{
+    MOVStreamContext *sc = st->priv_data;
+    MOVSampleCursor c = sc->lazy_start;
+
+    if (av_reallocp_array(&st->index_entries, sc->lazy_sample_count,
+                          sizeof(*st->index_entries)) < 0) {
+        st->nb_index_entries = 0;
+        return AVERROR(ENOMEM);
+    }
+    st->index_entries_allocated_size = sc->lazy_sample_count * sizeof(*st->index_entries);
+    st->nb_index_entries = 0;
+    while (st->nb_index_entries < sc->lazy_sample_count &&
+           mov_cursor_next(mov, st, &c, &st->index_entries[st->nb_index_entries]) >= 0)
+        st->nb_index_entries++;
+
+    sc->lazy_index = 0;
+    av_freep(&sc->lazy_points);
+    sc->lazy_points_size = 0;
+    return 0;
+}
+
 static void mov_build_index(MOVContext *mov, AVStream *st)
 {
     MOVStreamContext *sc = st->priv_data;
     int64_t current_offset;
     int64_t current_dts = 0;
-    unsigned int stts_index = 0;
     unsigned int stsc_index = 0;
-    unsigned int stss_index = 0;
-    unsigned int stps_index = 0;
-    unsigned int i, j;
-    uint64_t stream_size = 0;
+    unsigned int i;
 
     /* adjust first dts according to edit list */
     if ((sc->empty_duration || sc->start_time) && mov->time_scale > 0) {
@@ -2260,19 +2502,16 @@ static void mov_build_index(MOVContext *mov, AVStream *st)
     /* only use old uncompressed audio chunk demuxing when stts specifies it */
     if (!(st->codec->codec_type == AVMEDIA_TYPE_AUDIO &&
           sc->stts_count == 1 && sc->stts_data[0].duration == 1)) {
-        unsigned int current_sample = 0;
-        unsigned int stts_sample = 0;
-        unsigned int sample_size;
-        unsigned int distance = 0;
-        unsigned int rap_group_index = 0;
-        unsigned int rap_group_sample = 0;
-        int rap_group_present = sc->rap_group_count && sc->rap_group;
-        int key_off = (sc->keyframe_count && sc->keyframes[0] > 0) || (sc->stps_count && sc->stps_data[0] > 0);
+        MOVSampleCursor c;
 
         current_dts -= sc->dts_shift;
 
         if (!sc->sample_count || st->nb_index_entries)
             return;
+        if (mov->lazy_index > 0 && sc->sample_count >= mov->lazy_index) {
+            mov_build_lazy_index(mov, st, current_dts);
+            return;
+        }
         if (sc->sample_count >= UINT_MAX / sizeof(*st->index_entries) - st->nb_index_entries)
             return;
         if (av_reallocp_array(&st->index_entries,
@@ -2283,84 +2522,14 @@ static void mov_build_index(MOVContext *mov, AVStream *st)
         }
         st->index_entries_allocated_size = (st->nb_index_entries + sc->sample_count) * sizeof(*st->index_entries);
 
-        for (i = 0; i < sc->chunk_count; i++) {
-            int64_t next_offset = i+1 < sc->chunk_count ? sc->chunk_offsets[i+1] : INT64_MAX;
-            current_offset = sc->chunk_offsets[i];
-            while (stsc_index + 1 < sc->stsc_count &&
-                i + 1 == sc->stsc_data[stsc_index + 1].first)
-                stsc_index++;
-
-            if (next_offset > current_offset && sc->sample_size>0 && sc->sample_size < sc->stsz_sample_size &&
-                sc->stsc_data[stsc_index].count * (int64_t)sc->stsz_sample_size > next_offset - current_offset) {
-                av_log(mov->fc, AV_LOG_WARNING, "STSZ sample size %d invalid (too large), ignoring\n", sc->stsz_sample_size);
-                sc->stsz_sample_size = sc->sample_size;
-            }
-            if (sc->stsz_sample_size>0 && sc->stsz_sample_size < sc->sample_size) {
-                av_log(mov->fc, AV_LOG_WARNING, "STSZ sample size %d invalid (too small), ignoring\n", sc->stsz_sample_size);
-                sc->stsz_sample_size = sc->sample_size;
-            }
-
-            for (j = 0; j < sc->stsc_data[stsc_index].count; j++) {
-                int keyframe = 0;
-                if (current_sample >= sc->sample_count) {
-                    av_log(mov->fc, AV_LOG_ERROR, "wrong sample count\n");
-                    return;
-                }
-
-                if (!sc->keyframe_absent && (!sc->keyframe_count || current_sample+key_off == sc->keyframes[stss_index])) {
-                    keyframe = 1;
-                    if (stss_index + 1 < sc->keyframe_count)
-                        stss_index++;
-                } else if (sc->stps_count && current_sample+key_off == sc->stps_data[stps_index]) {
-                    keyframe = 1;
-                    if (stps_index + 1 < sc->stps_count)
-                        stps_index++;
-                }
-                if (rap_group_present && rap_group_index < sc->rap_group_count) {
-                    if (sc->rap_group[rap_group_index].index > 0)
-                        keyframe = 1;
-                    if (++rap_group_sample == sc->rap_group[rap_group_index].count) {
-                        rap_group_sample = 0;
-                        rap_group_index++;
-                    }
-                }
-                if (sc->keyframe_absent
-                    && !sc->stps_count
-                    && !rap_group_present
-                    && (st->codec->codec_type == AVMEDIA_TYPE_AUDIO || (i==0 && j==0)))
-                     keyframe = 1;
-                if (keyframe)
-                    distance = 0;
-                sample_size = sc->stsz_sample_size > 0 ? sc->stsz_sample_size : sc->sample_sizes[current_sample];
-                if (sc->pseudo_stream_id == -1 ||
-                   sc->stsc_data[stsc_index].id - 1 == sc->pseudo_stream_id) {
-                    AVIndexEntry *e = &st->index_entries[st->nb_index_entries++];
-                    e->pos = current_offset;
-                    e->timestamp = current_dts;
-                    e->size = sample_size;
-                    e->min_distance = distance;
-                    e->flags = keyframe ? AVINDEX_KEYFRAME : 0;
-                    av_dlog(mov->fc, "AVIndex stream %d, sample %d, offset %"PRIx64", dts %"PRId64", "
-                            "size %d, distance %d, keyframe %d\n", st->index, current_sample,
-                            current_offset, current_dts, sample_size, distance, keyframe);
-                    if (st->codec->codec_type == AVMEDIA_TYPE_VIDEO && st->nb_index_entries < 100)
-                        ff_rfps_add_frame(mov->fc, st, current_dts);
-                }
-
-                current_offset += sample_size;
-                stream_size += sample_size;
-                current_dts += sc->stts_data[stts_index].duration;
-                distance++;
-                stts_sample++;
-                current_sample++;
-                if (stts_index + 1 < sc->stts_count && stts_sample == sc->stts_data[stts_index].count) {
-                    stts_sample = 0;
-                    stts_index++;
-                }
-            }
+        mov_cursor_init(mov, st, &c, current_dts);
+        while (mov_cursor_next(mov, st, &c, &st->index_entries[st->nb_index_entries]) >= 0) {
+            AVIndexEntry *e = &st->index_entries[st->nb_index_entries++];
+            if (st->codec->codec_type == AVMEDIA_TYPE_VIDEO && st->nb_index_entries < 100)
+                ff_rfps_add_frame(mov->fc, st, e->timestamp);
         }
         if (st->duration > 0)
-            st->codec->bit_rate = stream_size*8*sc->time_scale/st->duration;
+            st->codec->bit_rate = c.stream_size*8*sc->time_scale/st->duration;
     } else {
         unsigned chunk_samples, total = 0;
 
@@ -2593,7 +2762,9 @@ static int mov_read_trak(MOVContext *c, AVIOContext *pb, MOVAtom atom)
         break;
     }
 
-    /* Do not need those anymore. */
+    /* Do not need those anymore, unless samples are read through them. */
+    if (sc->lazy_index)
+        return 0;
     av_freep(&sc->chunk_offsets);
     av_freep(&sc->stsc_data);
     av_freep(&sc->sample_sizes);
@@ -2990,6 +3161,9 @@ static int mov_read_trun(MOVContext *c, AVIOContext *pb, MOVAtom atom)
     sc = st->priv_data;
     if (sc->pseudo_stream_id+1 != frag->stsd_id && sc->pseudo_stream_id != -1)
         return 0;
+    /* fragment samples are appended to a full index */
+    if (sc->lazy_index && (err = mov_fill_index(c, st)) < 0)
+        return err;
     avio_r8(pb); /* version */
     flags = avio_rb24(pb);
     entries = avio_rb32(pb);
@@ -3711,6 +3885,7 @@ static int mov_read_close(AVFormatContext *s)
         av_freep(&sc->stps_data);
         av_freep(&sc->rap_group);
         av_freep(&sc->display_matrix);
+        av_freep(&sc->lazy_points);
     }
 
     if (mov->dv_demux) {
@@ -4013,6 +4188,16 @@ static int mov_read_header(AVFormatContext *s)
     return 0;
 }
 
+static AVIndexEntry *mov_current_sample(AVStream *st)
+{
+    MOVStreamContext *sc = st->priv_data;
+
+    if (sc->lazy_index)
+        return sc->current_sample < sc->lazy_sample_count ? &sc->lazy_entry : NULL;
+    return sc->current_sample < st->nb_index_entries ?
+           &st->index_entries[sc->current_sample] : NULL;
+}
+
 static AVIndexEntry *mov_find_next_sample(AVFormatContext *s, AVStream **st)
 {
     AVIndexEntry *sample = NULL;
@@ -4021,8 +4206,8 @@ static AVIndexEntry *mov_find_next_sample(AVFormatContext *s, AVStream **st)
     for (i = 0; i < s->nb_streams; i++) {
         AVStream *avst = s->streams[i];
         MOVStreamContext *msc = avst->priv_data;
-        if (msc->pb && msc->current_sample < avst->nb_index_entries) {
-            AVIndexEntry *current_sample = &avst->index_entries[msc->current_sample];
+        AVIndexEntry *current_sample = mov_current_sample(avst);
+        if (msc->pb && current_sample) {
             int64_t dts = av_rescale(current_sample->timestamp, AV_TIME_BASE, msc->time_scale);
             av_dlog(s, "stream %d, sample %d, dts %"PRId64"\n", i, msc->current_sample, dts);
             if (!sample || (!s->pb->seekable && current_sample->pos < sample->pos) ||
@@ -4043,7 +4228,7 @@ static int mov_read_packet(AVFormatContext *s, AVPacket *pkt)
 {
     MOVContext *mov = s->priv_data;
     MOVStreamContext *sc;
-    AVIndexEntry *sample;
+    AVIndexEntry *sample, lazy_sample;
     AVStream *st = NULL;
     int ret;
     mov->fc = s;
@@ -4064,6 +4249,18 @@ static int mov_read_packet(AVFormatContext *s, AVPacket *pkt)
     sc = st->priv_data;
     /* must be done just before reading, to avoid infinite loop on sample */
     sc->current_sample++;
+    if (sc->lazy_index) {
+        lazy_sample = *sample;
+        sample = &lazy_sample;
+        if (sc->current_sample < sc->lazy_sample_count) {
+            MOVSampleCursor prev = sc->lazy_cursor;
+            if (mov_cursor_next(mov, st, &sc->lazy_cursor, &sc->lazy_entry) < 0)
+                sc->lazy_sample_count = sc->current_sample;
+            else if (prev.entry == sc->lazy_walk.entry &&
+                     (ret = mov_lazy_add_sample(st, &prev, &sc->lazy_cursor, &sc->lazy_entry)) < 0)
+                return ret;
+        }
+    }
 
     if (mov->next_root_atom) {
         sample->pos = FFMIN(sample->pos, mov->next_root_atom);
@@ -4076,7 +4273,7 @@ static int mov_read_packet(AVFormatContext *s, AVPacket *pkt)
                    sc->ffindex, sample->pos);
             return AVERROR_INVALIDDATA;
         }
-        ret = av_get_packet(sc->pb, pkt, sample->size);
+        ret = ff_packet_pool_get_packet(s, sc->pb, pkt, sample->size);
         if (ret < 0)
             return ret;
         if (sc->has_palette) {
@@ -4116,8 +4313,8 @@ static int mov_read_packet(AVFormatContext *s, AVPacket *pkt)
         if (sc->wrong_dts)
             pkt->dts = AV_NOPTS_VALUE;
     } else {
-        int64_t next_dts = (sc->current_sample < st->nb_index_entries) ?
-            st->index_entries[sc->current_sample].timestamp : st->duration;
+        AVIndexEntry *next = mov_current_sample(st);
+        int64_t next_dts = next ? next->timestamp : st->duration;
         pkt->duration = next_dts - pkt->dts;
         pkt->pts = pkt->dts;
     }
@@ -4130,16 +4327,69 @@ static int mov_read_packet(AVFormatContext *s, AVPacket *pkt)
     return 0;
 }
 
+/**
+ * Lazily indexed counterpart of av_index_search_timestamp(): collect the
+ * seek points up to timestamp, start from the last one before it and walk
+ * the sample tables from there.
+ * On success the cursor is left on the returned sample.
+ */
+static int mov_lazy_search_timestamp(MOVContext *mov, AVStream *st,
+                                     int64_t timestamp, int flags)
+{
+    MOVStreamContext *sc = st->priv_data;
+    MOVSampleCursor c, prev;
+    AVIndexEntry e;
+    int backward = flags & AVSEEK_FLAG_BACKWARD;
+    int point, sample = -1;
+
+    if ((point = mov_lazy_walk(mov, st, timestamp)) < 0)
+        return point;
+
+    /* strictly before timestamp, samples may share a dts */
+    point = timestamp > INT64_MIN ?
+            av_index_search_timestamp(st, timestamp - 1,
+                                      AVSEEK_FLAG_BACKWARD | AVSEEK_FLAG_ANY) : -1;
+    c = point >= 0 ? sc->lazy_points[point] : sc->lazy_start;
+
+    for (prev = c; mov_cursor_next(mov, st, &c, &e) >= 0; prev = c) {
+        if (backward && e.timestamp > timestamp)
+            break;
+        if (!(flags & AVSEEK_FLAG_ANY) && !(e.flags & AVINDEX_KEYFRAME))
+            continue;
+        if (backward || e.timestamp >= timestamp) {
+            sample          = prev.entry;
+            sc->lazy_cursor = c;
+            sc->lazy_entry  = e;
+            if (!backward)
+                break;
+        }
+    }
+
+    if (sample < 0) {
+        c = sc->lazy_start;
+        if (mov_cursor_next(mov, st, &c, &e) >= 0 && timestamp < e.timestamp) {
+            sample          = 0;
+            sc->lazy_cursor = c;
+            sc->lazy_entry  = e;
+        }
+    }
+    return sample;
+}
+
 static int mov_seek_stream(AVFormatContext *s, AVStream *st, int64_t timestamp, int flags)
 {
     MOVStreamContext *sc = st->priv_data;
     int sample, time_sample;
     int i;
 
-    sample = av_index_search_timestamp(st, timestamp, flags);
+    if (sc->lazy_index) {
+        sample = mov_lazy_search_timestamp(s->priv_data, st, timestamp, flags);
+    } else {
+        sample = av_index_search_timestamp(st, timestamp, flags);
+        if (sample < 0 && st->nb_index_entries && timestamp < st->index_entries[0].timestamp)
+            sample = 0;
+    }
     av_dlog(s, "stream %d, timestamp %"PRId64", sample %d\n", st->index, timestamp, sample);
-    if (sample < 0 && st->nb_index_entries && timestamp < st->index_entries[0].timestamp)
-        sample = 0;
     if (sample < 0) /* not sure what to do */
         return AVERROR_INVALIDDATA;
     sc->current_sample = sample;
@@ -4176,7 +4426,7 @@ static int mov_read_seek(AVFormatContext *s, int stream_index, int64_t sample_ti
         return sample;
 
     /* adjust seek timestamp to found sample timestamp */
-    seek_timestamp = st->index_entries[sample].timestamp;
+    seek_timestamp = mov_current_sample(st)->timestamp;
 
     for (i = 0; i < s->nb_streams; i++) {
         MOVStreamContext *sc = s->streams[i]->priv_data;
@@ -4214,6 +4464,9 @@ static const AVOption mov_options[] = {
         AV_OPT_FLAG_VIDEO_PARAM|AV_OPT_FLAG_DECODING_PARAM, "use_mfra_for" },
     { "export_all", "Export unrecognized metadata entries", OFFSET(export_all),
         AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 1, .flags = FLAGS },
+    { "lazy_index", "Read tracks with at least this many samples from their sample tables "
+        "instead of a full index (0 = never)", OFFSET(lazy_index),
+        AV_OPT_TYPE_INT, { .i64 = 1 << 18 }, 0, INT_MAX, .flags = FLAGS },
     { NULL },
 };
 
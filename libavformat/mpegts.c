@@ -1002,8 +1002,8 @@ static int mpegts_push_data(MpegTSFilter *filter,
                         pes->total_size = MAX_PES_PAYLOAD;
 
                     /* allocate pes buffer */
-                    pes->buffer = av_buffer_alloc(pes->total_size +
-                                                  FF_INPUT_BUFFER_PADDING_SIZE);
+                    pes->buffer = ff_packet_pool_get(pes->stream, pes->total_size +
+                                                     FF_INPUT_BUFFER_PADDING_SIZE);
                     if (!pes->buffer)
                         return AVERROR(ENOMEM);
 
@@ -1153,8 +1153,8 @@ skip:
                     pes->data_index + buf_size > pes->total_size) {
                     new_pes_packet(pes, ts->pkt);
                     pes->total_size = MAX_PES_PAYLOAD;
-                    pes->buffer = av_buffer_alloc(pes->total_size +
-                                                  FF_INPUT_BUFFER_PADDING_SIZE);
+                    pes->buffer = ff_packet_pool_get(pes->stream, pes->total_size +
+                                                     FF_INPUT_BUFFER_PADDING_SIZE);
                     if (!pes->buffer)
                         return AVERROR(ENOMEM);
                     ts->stop_parse = 1;
@@ -2325,6 +2325,72 @@ static void finished_reading_packet(AVFormatContext *s, int raw_packet_size)
         avio_skip(pb, skip);
 }
 
+/* return 1 if nothing downstream wants this packet, so that it can be
+ * dropped without going through handle_packet() */
+static int skip_packet(MpegTSContext *ts, const uint8_t *packet)
+{
+    int pid = AV_RB16(packet + 1) & 0x1fff;
+    MpegTSFilter *tss = ts->pids[pid];
+    PESContext *pes;
+
+    if (!tss)
+        return !(ts->auto_guess && (packet[1] & 0x40));
+    /* the adaptation field may carry a PCR, keep those */
+    if (tss->type != MPEGTS_PES || (packet[3] & 0x20))
+        return 0;
+    pes = tss->u.pes_filter.opaque;
+    if (!pes->st || pes->st->discard != AVDISCARD_ALL ||
+        (pes->sub_st && pes->sub_st->discard != AVDISCARD_ALL))
+        return 0;
+
+    /* stream discarded: resume at the next PES header once it is wanted */
+    if (pes->state != MPEGTS_SKIP) {
+        av_buffer_unref(&pes->buffer);
+        pes->data_index = 0;
+        pes->state      = MPEGTS_SKIP;
+    }
+    tss->last_cc = -1;
+    return 1;
+}
+
+/**
+ * Handle the 188-byte packets already sitting in the I/O buffer without
+ * copying them out. The sync bytes of the whole run are checked first and
+ * the run is cut at the first lost sync, which read_packet() then resyncs.
+ * The buffer pointer is advanced packet by packet so that avio_tell() stays
+ * exact for handle_packet() and unprocessed packets remain unread when
+ * parsing stops early.
+ * @return number of packets consumed
+ */
+static int handle_packet_run(MpegTSContext *ts, int64_t max_packets, int *ret)
+{
+    AVIOContext *pb = ts->stream->pb;
+    uint8_t *run = pb->buf_ptr;
+    int64_t n = (pb->buf_end - run) / TS_PACKET_SIZE;
+    int i;
+
+    *ret = 0;
+    if (pb->write_flag)
+        return 0;
+    if (max_packets > 0)
+        n = FFMIN(n, max_packets);
+    for (i = 0; i < n; i++)
+        if (run[i * TS_PACKET_SIZE] != 0x47)
+            break;
+    n = i;
+
+    for (i = 0; i < n;) {
+        uint8_t *packet = run + i++ * TS_PACKET_SIZE;
+
+        pb->buf_ptr = packet + TS_PACKET_SIZE;
+        if (skip_packet(ts, packet))
+            continue;
+        if ((*ret = handle_packet(ts, packet)) || ts->stop_parse)
+            break;
+    }
+    return i;
+}
+
 static int handle_packets(MpegTSContext *ts, int64_t nb_packets)
 {
     AVFormatContext *s = ts->stream;
@@ -2364,6 +2430,17 @@ static int handle_packets(MpegTSContext *ts, int64_t nb_packets)
         if (ts->stop_parse > 0)
             break;
 
+        if (ts->raw_packet_size == TS_PACKET_SIZE) {
+            int n = handle_packet_run(ts, nb_packets ? nb_packets - packet_num : 0,
+                                      &ret);
+            if (n > 0) {
+                packet_num += n - 1;
+                if (ret != 0)
+                    break;
+                continue;
+            }
+        }
+
         ret = read_packet(s, packet, ts->raw_packet_size, &data);
         if (ret != 0)
             break;
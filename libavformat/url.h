@@ -28,6 +28,7 @@
 #include "avio.h"
 #include "libavformat/version.h"
 
+#include "libavutil/buffer.h"
 #include "libavutil/dict.h"
 #include "libavutil/log.h"
 
@@ -87,6 +88,13 @@ typedef struct URLProtocol {
     const AVClass *priv_data_class;
     int flags;
     int (*url_check)(URLContext *h, int mask);
+    /**
+     * Return a reference to up to size bytes of the resource starting at
+     * pos without copying them. Only implemented by protocols that can
+     * expose the resource as memory, e.g. a mapped file.
+     */
+    int (*url_read_view)(URLContext *h, int64_t pos, int size,
+                         AVBufferRef **buf, uint8_t **data);
 } URLProtocol;
 
 /**
@@ -154,6 +162,18 @@ int ffurl_read(URLContext *h, unsigned char *buf, int size);
  */
 int ffurl_read_complete(URLContext *h, unsigned char *buf, int size);
 
+/**
+ * Get a zero-copy view of up to size bytes of the resource accessed by h,
+ * starting at byte offset pos. The read position of h is not changed.
+ *
+ * @param buf set to a new reference keeping the viewed memory alive
+ * @param data set to the first viewed byte
+ * @return the number of bytes viewed, 0 at the end of the resource, or
+ * AVERROR(ENOSYS) if the protocol does not support views
+ */
+int ffurl_read_view(URLContext *h, int64_t pos, int size,
+                    AVBufferRef **buf, uint8_t **data);
+
 /**
  * Write size bytes from buf to the resource accessed by h.
  *
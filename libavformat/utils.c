@@ -252,6 +252,123 @@ int av_append_packet(AVIOContext *s, AVPacket *pkt, int size)
     return append_packet_chunked(s, pkt, size);
 }
 
+/* The payloads of the demuxed packets are recycled through pools owned by
+ * the context, so the steady stream of packets does not go through the
+ * allocator. Sizes are rounded up to a quarter of an octave. */
+static int packet_pool_class(int size, int *class_size)
+{
+    int shift, m;
+
+    if (size <= PACKET_POOL_MIN_SIZE) {
+        *class_size = PACKET_POOL_MIN_SIZE;
+        return 0;
+    }
+    shift       = av_log2(size - 1) - 2;
+    m           = ((size - 1) >> shift) + 1; // 5 to 8
+    *class_size = m << shift;
+    return 1 + 4 * (shift - 8) + m - 5;
+}
+
+/* only called from av_buffer_pool_get(), in the demuxing thread */
+static AVBufferRef *packet_pool_alloc(void *opaque, int size)
+{
+    AVFormatInternal *internal = opaque;
+
+    internal->packet_pool_misses++;
+    return av_buffer_alloc(size);
+}
+
+AVBufferRef *ff_packet_pool_get(AVFormatContext *s, int size)
+{
+    AVBufferPool **pool;
+    int class_size, idx;
+
+    if (!s)
+        return av_buffer_alloc(size);
+
+    s->internal->packet_pool_requests++;
+    if (size > PACKET_POOL_MAX_SIZE) {
+        s->internal->packet_pool_misses++;
+        return av_buffer_alloc(size);
+    }
+
+    idx  = packet_pool_class(size, &class_size);
+    pool = &s->internal->packet_pools[idx];
+    if (!*pool) {
+        *pool = av_buffer_pool_init2(class_size, s->internal,
+                                     packet_pool_alloc, NULL);
+        if (!*pool)
+            return NULL;
+    }
+    return av_buffer_pool_get(*pool);
+}
+
+int ff_packet_pool_new_packet(AVFormatContext *s, AVPacket *pkt, int size)
+{
+    AVBufferRef *buf;
+
+    if ((unsigned)size >= (unsigned)size + FF_INPUT_BUFFER_PADDING_SIZE)
+        return AVERROR(EINVAL);
+
+    buf = ff_packet_pool_get(s, size + FF_INPUT_BUFFER_PADDING_SIZE);
+    if (!buf)
+        return AVERROR(ENOMEM);
+    memset(buf->data + size, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+
+    av_init_packet(pkt);
+    pkt->buf  = buf;
+    pkt->data = buf->data;
+    pkt->size = size;
+    return 0;
+}
+
+int ff_packet_pool_get_packet(AVFormatContext *s, AVIOContext *pb,
+                              AVPacket *pkt, int size)
+{
+    int64_t pos = avio_tell(pb);
+    int ret;
+
+    /* larger reads are chunked against truncated files */
+    if (size <= 0 || size > PACKET_POOL_MAX_SIZE - FF_INPUT_BUFFER_PADDING_SIZE)
+        return av_get_packet(pb, pkt, size);
+
+    if ((ret = ff_packet_pool_new_packet(s, pkt, size)) < 0)
+        return ret;
+    pkt->pos = pos;
+
+    ret = avio_read(pb, pkt->data, size);
+    if (ret != size) {
+        av_shrink_packet(pkt, FFMAX(ret, 0));
+        pkt->flags |= AV_PKT_FLAG_CORRUPT;
+    }
+    if (!pkt->size) {
+        av_free_packet(pkt);
+        return ret;
+    }
+    return pkt->size;
+}
+
+int ff_packet_pool_dup_packet(AVFormatContext *s, AVPacket *pkt)
+{
+    AVBufferRef *buf;
+
+    if (pkt->buf || !pkt->data)
+        return 0;
+
+    if ((unsigned)pkt->size > INT_MAX - FF_INPUT_BUFFER_PADDING_SIZE)
+        return AVERROR(EINVAL);
+
+    buf = ff_packet_pool_get(s, pkt->size + FF_INPUT_BUFFER_PADDING_SIZE);
+    if (!buf)
+        return AVERROR(ENOMEM);
+    memcpy(buf->data, pkt->data, pkt->size);
+    memset(buf->data + pkt->size, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+
+    pkt->buf  = buf;
+    pkt->data = buf->data;
+    return 0;
+}
+
 int av_filename_number_test(const char *filename)
 {
     char buf[1024];
@@ -1245,7 +1362,7 @@ FF_DISABLE_DEPRECATION_WARNINGS
 FF_ENABLE_DEPRECATION_WARNINGS
 #endif
         }
-        if ((ret = av_dup_packet(&out_pkt)) < 0)
+        if ((ret = ff_packet_pool_dup_packet(s, &out_pkt)) < 0)
             goto fail;
 
         if (!add_to_pktbuf(&s->parse_queue, &out_pkt, &s->parse_queue_end)) {
@@ -1518,8 +1635,8 @@ int av_read_frame(AVFormatContext *s, AVPacket *pkt)
                 return ret;
         }
 
-        if (av_dup_packet(add_to_pktbuf(&s->packet_buffer, pkt,
-                                        &s->packet_buffer_end)) < 0)
+        if (ff_packet_pool_dup_packet(s, add_to_pktbuf(&s->packet_buffer, pkt,
+                                                       &s->packet_buffer_end)) < 0)
             return AVERROR(ENOMEM);
     }
 
@@ -3167,7 +3284,7 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
                 ret = AVERROR(ENOMEM);
                 goto find_stream_info_err;
             }
-            if ((ret = av_dup_packet(pkt)) < 0)
+            if ((ret = ff_packet_pool_dup_packet(ic, pkt)) < 0)
                 goto find_stream_info_err;
         }
 
@@ -3588,6 +3705,16 @@ void avformat_free_context(AVFormatContext *s)
     av_freep(&s->chapters);
     av_dict_free(&s->metadata);
     av_freep(&s->streams);
+    if (s->internal) {
+        int64_t requests = s->internal->packet_pool_requests;
+        if (requests)
+            av_log(s, AV_LOG_VERBOSE,
+                   "Packet pools: %"PRId64" payloads, %"PRId64" allocated, %.1f%% reused\n",
+                   requests, s->internal->packet_pool_misses,
+                   100.0 * (requests - s->internal->packet_pool_misses) / requests);
+        for (i = 0; i < PACKET_POOL_CLASSES; i++)
+            av_buffer_pool_uninit(&s->internal->packet_pools[i]);
+    }
     av_freep(&s->internal);
     flush_packet_queue(s);
     av_free(s);
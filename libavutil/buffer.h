@@ -248,6 +248,23 @@ typedef struct AVBufferPool AVBufferPool;
  */
 AVBufferPool *av_buffer_pool_init(int size, AVBufferRef* (*alloc)(int size));
 
+/**
+ * Allocate and initialize a buffer pool with an allocator that takes user
+ * data.
+ *
+ * @param size size of each buffer in this pool
+ * @param opaque arbitrary user data passed to alloc and pool_free
+ * @param alloc a function that will be used to allocate new buffers when the
+ * pool is empty
+ * @param pool_free a function that will be called right before the pool is
+ * freed, i.e. once av_buffer_pool_uninit() has been called and all the
+ * buffers have been returned. May be NULL.
+ * @return newly created buffer pool on success, NULL on error.
+ */
+AVBufferPool *av_buffer_pool_init2(int size, void *opaque,
+                                   AVBufferRef* (*alloc)(void *opaque, int size),
+                                   void (*pool_free)(void *opaque));
+
 /**
  * Mark the pool as being available for freeing. It will actually be freed only
  * once all the allocated buffers associated with the pool are released. Thus it
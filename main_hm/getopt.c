@@ -51,7 +51,7 @@ void print_usage() {
     printf(usage, program);
     printf("     -a : disable AU\n");
     printf("     -c : no check md5\n");
-    printf("     -f <thread type> (1: frame, 2: slice, 4: frameslice)\n");
+    printf("     -f <thread type> (1: frame, 2: slice, 4: frameslice, 8: auto)\n");
     printf("     -i <input file>\n");
     printf("     -n : no display\n");
     printf("     -o <output file>\n");
@@ -60,6 +60,10 @@ void print_usage() {
     printf("     -w : Do not apply cropping windows\n");
     printf("     -l <Quality layer id> \n");
     printf("     -s <num> Stop after num frames \n");
+    printf("     -r <bytes> Read the input ahead on a separate thread\n");
+    printf("     -j <seconds> Start at this time, decoding from the preceding IRAP\n");
+    printf("     -k <mode> Skip pictures (1: non-reference, 2: all but IRAP)\n");
+    printf("     -m : Map the input file into memory, raw HEVC packets point into it\n");
 }
 
 /*
@@ -131,7 +135,7 @@ int getopt(int nargc, char * const *nargv, const char *ostr) {
 void init_main(int argc, char *argv[]) {
     // every command line option must be followed by ':' if it takes an
     // argument, and '::' if this argument is optional
-    const char *ostr = "achi:no:p:f:s:t:wl:";
+    const char *ostr = "achi:mno:p:f:s:t:wl:r:j:k:";
 
     int c;
     check_md5_flags   = ENABLE;
@@ -144,6 +148,10 @@ void init_main(int argc, char *argv[]) {
     no_cropping       = DISABLE;
     quality_layer_id  = 0; // Base layer
     num_frames        = 0;
+    read_ahead        = 0;
+    seek_time         = 0;
+    skip_mode         = 0;
+    map_input         = DISABLE;
 
     program           = argv[0];
     
@@ -156,7 +164,7 @@ void init_main(int argc, char *argv[]) {
             break;
         case 'f':
             thread_type = atoi(optarg);
-            if (thread_type!=1 && thread_type!=2 && thread_type!=4) {
+            if (thread_type!=1 && thread_type!=2 && thread_type!=4 && thread_type!=8) {
                 print_usage();
                 exit(1);
             }
@@ -187,6 +195,18 @@ void init_main(int argc, char *argv[]) {
         case 's':
             num_frames = atoi(optarg);
             break;
+        case 'r':
+            read_ahead = atoi(optarg);
+            break;
+        case 'j':
+            seek_time = atof(optarg);
+            break;
+        case 'k':
+            skip_mode = atoi(optarg);
+            break;
+        case 'm':
+            map_input = ENABLE;
+            break;
         default:
             print_usage();
             exit(1);
@@ -52,6 +52,10 @@ int temporal_layer_id;
 int quality_layer_id;
 int no_cropping;
 int num_frames;
+int read_ahead;
+float seek_time;
+int skip_mode;
+int map_input;
 
 // initialize APR and parse command-line options
 void init_main(int argc, char *argv[]);
@@ -0,0 +1,198 @@
+/*
+ * HEVC conformance stream runner
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Decodes one stream through the wrapper with the given threading and
+ * prints a single line with the number of output pictures, the MD5 of these
+ * pictures as the test application writes them with -o, the decoding speed
+ * and the number of pictures whose SEI decoded picture hash did not match.
+ *
+ * MyCMakeScripts/Conformance.cmake runs it on every stream of a directory
+ * for each thread configuration and compares the results.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "openHevcWrapper.h"
+#include "libavformat/avformat.h"
+#include "libavutil/atomic.h"
+#include "libavutil/log.h"
+#include "libavutil/md5.h"
+#include "libavutil/time.h"
+
+/* counted from the log callback, which the decoder threads call */
+static volatile int nb_md5_errors;
+
+static void log_callback(void *avcl, int level, const char *fmt, va_list vl)
+{
+    if (strstr(fmt, "Incorrect MD5"))
+        avpriv_atomic_int_add_and_fetch(&nb_md5_errors, 1);
+    av_log_default_callback(avcl, level, fmt, vl);
+}
+
+static int decode(const char *filename, int nb_pthreads, int thread_type,
+                  int num_frames)
+{
+    AVFormatContext *fmt_ctx = NULL;
+    AVCodecContext *avctx;
+    AVPacket packet;
+    OpenHevc_Handle handle;
+    OpenHevc_Frame_cpy frame;
+    struct AVMD5 *md5;
+    uint8_t digest[16];
+    int64_t start, elapsed;
+    int video_stream_idx, got_picture, i;
+    int nb_frames = 0, stop = 0, stop_dec = 0, width = 0, height = 0;
+    int size_y = 0, size_u = 0, size_v = 0;
+
+    handle = libOpenHevcInit(nb_pthreads, thread_type);
+    md5    = av_md5_alloc();
+    if (!handle || !md5) {
+        fprintf(stderr, "cannot initialize the decoder\n");
+        return 1;
+    }
+    libOpenHevcSetCheckMD5(handle, 1);
+
+    av_register_all();
+    if (avformat_open_input(&fmt_ctx, filename, NULL, NULL) < 0) {
+        fprintf(stderr, "cannot open %s\n", filename);
+        return 1;
+    }
+    if ((video_stream_idx = av_find_best_stream(fmt_ctx, AVMEDIA_TYPE_VIDEO, -1, -1, NULL, 0)) < 0) {
+        fprintf(stderr, "no video stream in %s\n", filename);
+        return 1;
+    }
+    avctx = fmt_ctx->streams[video_stream_idx]->codec;
+    if (avctx->extradata_size > 0)
+        libOpenHevcCopyExtraData(handle, avctx->extradata,
+                                 avctx->extradata_size + FF_INPUT_BUFFER_PADDING_SIZE);
+
+    libOpenHevcSetDebugMode(handle, 0);
+    libOpenHevcStartDecoder(handle);
+    libOpenHevcSetTemporalLayer_id(handle, 7);
+    libOpenHevcSetActiveDecoders(handle, 0);
+    libOpenHevcSetViewLayers(handle, 0);
+
+    memset(&frame, 0, sizeof(frame));
+    av_md5_init(md5);
+    av_init_packet(&packet);
+
+    start = av_gettime_relative();
+    while (!stop) {
+        if (!stop_dec && av_read_frame(fmt_ctx, &packet) < 0) {
+            stop_dec    = 1;
+            packet.data = NULL;
+            packet.size = 0;
+        }
+        if (packet.stream_index == video_stream_idx || stop_dec) {
+            got_picture = libOpenHevcDecode(handle, packet.data, packet.size, packet.pts);
+            if (got_picture > 0) {
+                libOpenHevcGetPictureInfo(handle, &frame.frameInfo);
+                if (width != frame.frameInfo.nWidth || height != frame.frameInfo.nHeight) {
+                    int format = frame.frameInfo.chromat_format == YUV420 ? 1 : 0;
+
+                    width  = frame.frameInfo.nWidth;
+                    height = frame.frameInfo.nHeight;
+                    size_y = frame.frameInfo.nYPitch * height;
+                    size_u = frame.frameInfo.nUPitch * ((height + format) >> format);
+                    size_v = frame.frameInfo.nVPitch * ((height + format) >> format);
+                    free(frame.pvY);
+                    free(frame.pvU);
+                    free(frame.pvV);
+                    frame.pvY = calloc(size_y, 1);
+                    frame.pvU = calloc(size_u, 1);
+                    frame.pvV = calloc(size_v, 1);
+                    if (!frame.pvY || !frame.pvU || !frame.pvV) {
+                        fprintf(stderr, "out of memory\n");
+                        return 1;
+                    }
+                }
+                libOpenHevcGetOutputCpy(handle, 1, &frame);
+                av_md5_update(md5, frame.pvY, size_y);
+                av_md5_update(md5, frame.pvU, size_u);
+                av_md5_update(md5, frame.pvV, size_v);
+                if (++nb_frames == num_frames)
+                    stop = 1;
+            } else if (stop_dec) {
+                stop = 1;
+            }
+        }
+        if (!stop_dec)
+            av_free_packet(&packet);
+    }
+    elapsed = av_gettime_relative() - start;
+    av_md5_final(md5, digest);
+
+    printf("frames=%d md5=", nb_frames);
+    for (i = 0; i < 16; i++)
+        printf("%02x", digest[i]);
+    printf(" fps=%.2f md5_errors=%d\n",
+           elapsed > 0 ? nb_frames * 1000000.0 / elapsed : 0.0,
+           avpriv_atomic_int_get(&nb_md5_errors));
+
+    free(frame.pvY);
+    free(frame.pvU);
+    free(frame.pvV);
+    av_free(md5);
+    avformat_close_input(&fmt_ctx);
+    libOpenHevcClose(handle);
+    return 0;
+}
+
+static void print_usage(const char *prog)
+{
+    printf("usage: %s -i input [-p threads] [-f thread_type] [-s frames]\n"
+           "  -i input        stream to decode\n"
+           "  -p threads      number of decoding threads\n"
+           "  -f thread_type  1 frame, 2 slice, 4 frame and slice\n"
+           "  -s frames       stop after this number of pictures\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *input = NULL;
+    int nb_pthreads = 1, thread_type = 1, num_frames = 0;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-i") && i + 1 < argc) {
+            input = argv[++i];
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            nb_pthreads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-f") && i + 1 < argc) {
+            thread_type = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            num_frames = atoi(argv[++i]);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!input || nb_pthreads < 1) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    av_log_set_callback(log_callback);
+    return decode(input, nb_pthreads, thread_type, num_frames);
+}
@@ -0,0 +1,1059 @@
+/*
+ * HEVC DSP and intra prediction kernel check and benchmark
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Every HEVCDSPContext and HEVCPredContext function that the architecture
+ * specific init code replaces is run on random input against the C version,
+ * for all block sizes and for the 8, 10 and 12 bit depths. Each instruction
+ * set tier supported by the host is checked in turn, and with -b the cycles
+ * (or nanoseconds when no cycle counter is available) per call of the C and
+ * the optimized version are printed.
+ *
+ * Only the samples of the block are compared, the SIMD versions are free to
+ * write past its right edge up to their vector width as the decoder pads
+ * its buffers for that.
+ *
+ * intra_pred[] needs a whole HEVCContext and the SHVC upsampling functions
+ * a base layer frame, they are not covered here.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "libavutil/common.h"
+#include "libavutil/cpu.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem.h"
+#include "libavutil/time.h"
+#include "libavutil/timer.h"
+#include "libavcodec/get_bits.h"
+#include "libavcodec/hevc.h"
+
+#define BUF_STRIDE   256
+#define BUF_SIZE     (BUF_STRIDE * 96)
+#define BUF_OFFSET   (BUF_STRIDE * 8 + 32)
+#define BENCH_RUNS   32
+#define BENCH_CALLS  64
+
+typedef struct CPUTier {
+    const char *name;
+    int flags;          ///< flags this tier adds to the previous ones
+} CPUTier;
+
+static const CPUTier tiers[] = {
+#if ARCH_X86
+    { "SSE2",  AV_CPU_FLAG_MMX   | AV_CPU_FLAG_MMXEXT | AV_CPU_FLAG_SSE |
+               AV_CPU_FLAG_SSE2 },
+    { "SSSE3", AV_CPU_FLAG_SSE3  | AV_CPU_FLAG_SSSE3 },
+    { "SSE4",  AV_CPU_FLAG_SSE4  | AV_CPU_FLAG_SSE42 },
+    { "AVX",   AV_CPU_FLAG_AVX },
+    { "AVX2",  AV_CPU_FLAG_AVX2  | AV_CPU_FLAG_FMA3 },
+#elif ARCH_ARM
+    { "ARMV6", AV_CPU_FLAG_ARMV5TE | AV_CPU_FLAG_ARMV6 | AV_CPU_FLAG_ARMV6T2 |
+               AV_CPU_FLAG_VFP },
+    { "NEON",  AV_CPU_FLAG_VFPV3 | AV_CPU_FLAG_NEON },
+#elif ARCH_AARCH64
+    { "NEON",  AV_CPU_FLAG_ARMV8 | AV_CPU_FLAG_VFP | AV_CPU_FLAG_NEON },
+#endif
+};
+
+static const int pel_widths[10] = { 2, 4, 6, 8, 12, 16, 24, 32, 48, 64 };
+
+static struct {
+    int bench;
+    const char *filter;
+    int bit_depth;
+    const char *tier;
+    int nb_checked;
+    int nb_failed;
+    uint32_t seed;
+} state;
+
+static uint32_t rnd(void)
+{
+    state.seed ^= state.seed << 13;
+    state.seed ^= state.seed >> 17;
+    state.seed ^= state.seed << 5;
+    return state.seed;
+}
+
+static int rnd_range(int min, int max)
+{
+    return min + (int)(rnd() % (unsigned)(max - min + 1));
+}
+
+#ifdef AV_READ_TIME
+#define BENCH_UNIT "cycles"
+#else
+#define BENCH_UNIT "ns"
+#endif
+
+static uint64_t bench_time(void)
+{
+#ifdef AV_READ_TIME
+    return AV_READ_TIME();
+#else
+    return av_gettime_relative() * 1000;
+#endif
+}
+
+#define BENCH(t, call)                                                      \
+    do {                                                                    \
+        uint64_t best_ = UINT64_MAX;                                        \
+        int r_, i_;                                                         \
+        for (r_ = 0; r_ < BENCH_RUNS; r_++) {                               \
+            uint64_t t0_ = bench_time();                                    \
+            for (i_ = 0; i_ < BENCH_CALLS; i_++)                            \
+                call;                                                       \
+            t0_   = bench_time() - t0_;                                     \
+            best_ = FFMIN(best_, t0_);                                      \
+        }                                                                   \
+        t = (double)best_ / BENCH_CALLS;                                    \
+    } while (0)
+
+/**
+ * Decide whether the function called name has to be checked: it has to
+ * differ from the one of the previous tier and match the -f filter.
+ */
+static int check_func(const void *opt, const void *prev, char *name, int size,
+                      const char *fmt, ...)
+{
+    va_list ap;
+
+    if (!opt || opt == prev)
+        return 0;
+    va_start(ap, fmt);
+    vsnprintf(name, size, fmt, ap);
+    va_end(ap);
+    return !state.filter || strstr(name, state.filter);
+}
+
+static void report(const char *name, int ok, double t_ref, double t_opt)
+{
+    state.nb_checked++;
+    if (!ok)
+        state.nb_failed++;
+    printf("  %-36s %s", name, ok ? "OK" : "FAILED");
+    if (state.bench && ok)
+        printf("%*s C %9.1f  %-5s %9.1f  %5.2fx", 8, "", t_ref, state.tier,
+               t_opt, t_opt > 0 ? t_ref / t_opt : 0.0);
+    printf("\n");
+}
+
+static int get_pixel(const uint8_t *p, int x)
+{
+    return state.bit_depth > 8 ? AV_RN16(p + 2 * x) : p[x];
+}
+
+static void set_pixel(uint8_t *p, int x, int v)
+{
+    if (state.bit_depth > 8)
+        AV_WN16(p + 2 * x, v);
+    else
+        p[x] = v;
+}
+
+static void fill_pixels(uint8_t *buf, ptrdiff_t stride, int w, int h)
+{
+    int x, y;
+
+    for (y = 0; y < h; y++)
+        for (x = 0; x < w; x++)
+            set_pixel(buf + y * stride, x, rnd() & ((1 << state.bit_depth) - 1));
+}
+
+/**
+ * Fill a w x h block with a smooth random surface, a random step between
+ * the p and q sides of the edge at qx/qy and a little noise, so that the
+ * deblocking filters take their strong, normal and no filtering paths.
+ */
+static void fill_edge(uint8_t *buf, ptrdiff_t stride, int w, int h, int qx, int qy)
+{
+    int max  = (1 << state.bit_depth) - 1;
+    int base = rnd_range(0, max);
+    int amp  = rnd() & 3 ? rnd_range(0, 2) : 1 << (state.bit_depth - 4);
+    int step = rnd_range(-(1 << (state.bit_depth - 4)), 1 << (state.bit_depth - 4));
+    int x, y;
+
+    for (y = 0; y < h; y++)
+        for (x = 0; x < w; x++) {
+            int v = base + rnd_range(-amp, amp);
+            if (x >= qx && y >= qy)
+                v += step;
+            set_pixel(buf + y * stride, x, av_clip(v, 0, max));
+        }
+}
+
+static int cmp_pixels(const uint8_t *a, const uint8_t *b, ptrdiff_t stride, int w, int h)
+{
+    int y;
+
+    for (y = 0; y < h; y++)
+        if (memcmp(a + y * stride, b + y * stride, w << (state.bit_depth > 8)))
+            return 0;
+    return 1;
+}
+
+static int cmp_coeffs(const int16_t *a, const int16_t *b, ptrdiff_t stride, int w, int h)
+{
+    int y;
+
+    for (y = 0; y < h; y++)
+        if (memcmp(a + y * stride, b + y * stride, w * sizeof(*a)))
+            return 0;
+    return 1;
+}
+
+static void fill_coeffs(int16_t *coeffs, int n, int range)
+{
+    int i;
+
+    for (i = 0; i < n; i++)
+        coeffs[i] = rnd_range(-range, range);
+}
+
+typedef struct Buffers {
+    uint8_t *src;
+    uint8_t *dst_ref;
+    uint8_t *dst_opt;
+    int16_t *tmp;
+    int16_t *coeffs_ref;
+    int16_t *coeffs_opt;
+} Buffers;
+
+/*
+ * motion compensation
+ */
+
+enum MCType { MC_PEL, MC_UNI, MC_UNI_W, MC_BI, MC_BI_W, MC_NB };
+
+static const char * const mc_names[MC_NB] = { "", "_uni", "_uni_w", "_bi", "_bi_w" };
+
+typedef struct MCArgs {
+    uint8_t *src;
+    int16_t *src2;
+    int width, height;
+    intptr_t mx, my;
+    int denom, wx0, wx1, ox0, ox1;
+} MCArgs;
+
+static const void *mc_func(const HEVCDSPContext *c, int qpel, int type, int idx, int j, int i)
+{
+    switch (type) {
+    case MC_PEL:   return qpel ? (const void *)c->put_hevc_qpel[idx][j][i]      : (const void *)c->put_hevc_epel[idx][j][i];
+    case MC_UNI:   return qpel ? (const void *)c->put_hevc_qpel_uni[idx][j][i]  : (const void *)c->put_hevc_epel_uni[idx][j][i];
+    case MC_UNI_W: return qpel ? (const void *)c->put_hevc_qpel_uni_w[idx][j][i]: (const void *)c->put_hevc_epel_uni_w[idx][j][i];
+    case MC_BI:    return qpel ? (const void *)c->put_hevc_qpel_bi[idx][j][i]   : (const void *)c->put_hevc_epel_bi[idx][j][i];
+    default:       return qpel ? (const void *)c->put_hevc_qpel_bi_w[idx][j][i] : (const void *)c->put_hevc_epel_bi_w[idx][j][i];
+    }
+}
+
+static void call_mc(const HEVCDSPContext *c, int qpel, int type, int idx, int j, int i,
+                    const MCArgs *a, uint8_t *dst)
+{
+    switch (type) {
+    case MC_PEL:
+        if (qpel)
+            c->put_hevc_qpel[idx][j][i]((int16_t *)dst, MAX_PB_SIZE, a->src, BUF_STRIDE,
+                                        a->height, a->mx, a->my, a->width);
+        else
+            c->put_hevc_epel[idx][j][i]((int16_t *)dst, MAX_PB_SIZE, a->src, BUF_STRIDE,
+                                        a->height, a->mx, a->my, a->width);
+        break;
+    case MC_UNI:
+        if (qpel)
+            c->put_hevc_qpel_uni[idx][j][i](dst, BUF_STRIDE, a->src, BUF_STRIDE,
+                                            a->height, a->mx, a->my, a->width);
+        else
+            c->put_hevc_epel_uni[idx][j][i](dst, BUF_STRIDE, a->src, BUF_STRIDE,
+                                            a->height, a->mx, a->my, a->width);
+        break;
+    case MC_UNI_W:
+        if (qpel)
+            c->put_hevc_qpel_uni_w[idx][j][i](dst, BUF_STRIDE, a->src, BUF_STRIDE, a->height,
+                                              a->denom, a->wx0, a->ox0, a->mx, a->my, a->width);
+        else
+            c->put_hevc_epel_uni_w[idx][j][i](dst, BUF_STRIDE, a->src, BUF_STRIDE, a->height,
+                                              a->denom, a->wx0, a->ox0, a->mx, a->my, a->width);
+        break;
+    case MC_BI:
+        if (qpel)
+            c->put_hevc_qpel_bi[idx][j][i](dst, BUF_STRIDE, a->src, BUF_STRIDE, a->src2, MAX_PB_SIZE,
+                                           a->height, a->mx, a->my, a->width);
+        else
+            c->put_hevc_epel_bi[idx][j][i](dst, BUF_STRIDE, a->src, BUF_STRIDE, a->src2, MAX_PB_SIZE,
+                                           a->height, a->mx, a->my, a->width);
+        break;
+    default:
+        if (qpel)
+            c->put_hevc_qpel_bi_w[idx][j][i](dst, BUF_STRIDE, a->src, BUF_STRIDE, a->src2, MAX_PB_SIZE,
+                                             a->height, a->denom, a->wx0, a->wx1, a->ox0, a->ox1,
+                                             a->mx, a->my, a->width);
+        else
+            c->put_hevc_epel_bi_w[idx][j][i](dst, BUF_STRIDE, a->src, BUF_STRIDE, a->src2, MAX_PB_SIZE,
+                                             a->height, a->denom, a->wx0, a->wx1, a->ox0, a->ox1,
+                                             a->mx, a->my, a->width);
+        break;
+    }
+}
+
+static void random_mc_args(const HEVCDSPContext *ref, const Buffers *b, MCArgs *a,
+                           int qpel, int idx, int j, int i)
+{
+    int nb_frac = qpel ? 3 : 7;
+    int height  = pel_widths[rnd_range(0, 9)];
+    int idx2    = rnd_range(1, 9);
+
+    fill_pixels(b->src - BUF_OFFSET, BUF_STRIDE, BUF_STRIDE >> (state.bit_depth > 8),
+                BUF_SIZE / BUF_STRIDE);
+    a->src    = b->src + (rnd_range(0, 7) << (state.bit_depth > 8));
+    a->width  = pel_widths[idx];
+    a->height = FFMAX(height, qpel ? 4 : 2);
+    a->mx     = i ? rnd_range(1, nb_frac) : 0;
+    a->my     = j ? rnd_range(1, nb_frac) : 0;
+    a->denom  = rnd_range(0, 7);
+    a->wx0    = (1 << a->denom) + rnd_range(-128, 127);
+    a->wx1    = (1 << a->denom) + rnd_range(-128, 127);
+    /* the offsets are scaled to the bit depth by the functions */
+    a->ox0    = rnd_range(-128, 127);
+    a->ox1    = rnd_range(-128, 127);
+
+    /* the second prediction of a bi-predicted block is the output of the
+     * 14 bit put_hevc_qpel/epel functions */
+    a->src2 = b->tmp;
+    if (qpel)
+        ref->put_hevc_qpel[idx2][1][1](a->src2, MAX_PB_SIZE, b->src + 4 * BUF_STRIDE, BUF_STRIDE,
+                                       a->height, rnd_range(1, 3), rnd_range(1, 3), a->width);
+    else
+        ref->put_hevc_epel[idx2][1][1](a->src2, MAX_PB_SIZE, b->src + 4 * BUF_STRIDE, BUF_STRIDE,
+                                       a->height, rnd_range(1, 7), rnd_range(1, 7), a->width);
+}
+
+static void check_mc(const HEVCDSPContext *ref, const HEVCDSPContext *prev,
+                     const HEVCDSPContext *opt, const Buffers *b, int qpel)
+{
+    static const char * const frac_names[2][2] = { { "pixels", "h" }, { "v", "hv" } };
+    char name[64];
+    int type, idx, i, j, k;
+
+    for (type = 0; type < MC_NB; type++)
+        for (idx = 0; idx < 10; idx++)
+            for (j = 0; j < 2; j++)
+                for (i = 0; i < 2; i++) {
+                    MCArgs a;
+                    double t_ref = 0, t_opt = 0;
+                    int ok = 1;
+
+                    if (!check_func(mc_func(opt, qpel, type, idx, j, i),
+                                    mc_func(prev, qpel, type, idx, j, i),
+                                    name, sizeof(name), "put_hevc_%s%s_%s%d",
+                                    qpel ? "qpel" : "epel", mc_names[type],
+                                    frac_names[j][i], pel_widths[idx]))
+                        continue;
+
+                    for (k = 0; k < 8 && ok; k++) {
+                        random_mc_args(ref, b, &a, qpel, idx, j, i);
+                        call_mc(ref, qpel, type, idx, j, i, &a, b->dst_ref);
+                        call_mc(opt, qpel, type, idx, j, i, &a, b->dst_opt);
+                        if (type == MC_PEL)
+                            ok = cmp_coeffs((int16_t *)b->dst_ref, (int16_t *)b->dst_opt,
+                                            MAX_PB_SIZE, a.width, a.height);
+                        else
+                            ok = cmp_pixels(b->dst_ref, b->dst_opt, BUF_STRIDE, a.width, a.height);
+                        if (!ok)
+                            printf("  %s: mismatch for %dx%d mx %d my %d\n", name,
+                                   a.width, a.height, (int)a.mx, (int)a.my);
+                    }
+                    if (ok && state.bench) {
+                        a.height = a.width;
+                        BENCH(t_ref, call_mc(ref, qpel, type, idx, j, i, &a, b->dst_ref));
+                        BENCH(t_opt, call_mc(opt, qpel, type, idx, j, i, &a, b->dst_opt));
+                    }
+                    report(name, ok, t_ref, t_opt);
+                }
+}
+
+/*
+ * deblocking
+ */
+
+typedef struct DeblockArgs {
+    int beta[9];
+    int tc[18];
+    uint8_t no_p[18];
+    uint8_t no_q[18];
+} DeblockArgs;
+
+static void random_deblock_args(DeblockArgs *a, int nb_blocks, int pcm)
+{
+    int i;
+
+    // the filters scale beta and tc to the bit depth themselves
+    for (i = 0; i < nb_blocks; i++)
+        a->beta[i] = rnd_range(0, 64);
+    for (i = 0; i < 2 * nb_blocks; i++) {
+        a->tc[i]   = rnd() % 5 ? rnd_range(1, 24) : 0;
+        a->no_p[i] = pcm && !(rnd() % 4);
+        a->no_q[i] = pcm && !(rnd() % 4);
+    }
+}
+
+static void luma_edge_ref(const HEVCDSPContext *c, uint8_t *src, int vertical,
+                          const DeblockArgs *a, int nb_blocks)
+{
+    int i;
+
+    for (i = 0; i < nb_blocks; i++) {
+        uint8_t *pix = vertical ? src + 8 * i * BUF_STRIDE :
+                                  src + (8 * i << (state.bit_depth > 8));
+
+        if (!a->tc[2 * i] && !a->tc[2 * i + 1])
+            continue;
+        if (vertical)
+            c->hevc_v_loop_filter_luma_c(pix, BUF_STRIDE, a->beta[i], (int *)a->tc + 2 * i,
+                                         (uint8_t *)a->no_p + 2 * i, (uint8_t *)a->no_q + 2 * i);
+        else
+            c->hevc_h_loop_filter_luma_c(pix, BUF_STRIDE, a->beta[i], (int *)a->tc + 2 * i,
+                                         (uint8_t *)a->no_p + 2 * i, (uint8_t *)a->no_q + 2 * i);
+    }
+}
+
+static void check_deblock(const HEVCDSPContext *ref, const HEVCDSPContext *prev,
+                          const HEVCDSPContext *opt, const Buffers *b)
+{
+    int ps = state.bit_depth > 8;
+    char name[64];
+    int dir, k;
+
+    for (dir = 0; dir < 2; dir++) {
+        /* the edge at pix is the vertical one x == 0 for v, y == 0 for h */
+        uint8_t *pix_ref = b->dst_ref + BUF_OFFSET;
+        uint8_t *pix_opt = b->dst_opt + BUF_OFFSET;
+        uint8_t *blk_ref = pix_ref - (dir ? 4 << ps : 4 * BUF_STRIDE);
+        uint8_t *blk_opt = pix_opt - (dir ? 4 << ps : 4 * BUF_STRIDE);
+        int w = dir ? 8 : 72, h = dir ? 72 : 8;
+        DeblockArgs a;
+        double t_ref = 0, t_opt = 0;
+        int ok;
+
+        if (check_func(dir ? (const void *)opt->hevc_v_loop_filter_luma  : (const void *)opt->hevc_h_loop_filter_luma,
+                       dir ? (const void *)prev->hevc_v_loop_filter_luma : (const void *)prev->hevc_h_loop_filter_luma,
+                       name, sizeof(name), "hevc_%c_loop_filter_luma", dir ? 'v' : 'h')) {
+            for (k = 0, ok = 1; k < 64 && ok; k++) {
+                fill_edge(blk_ref, BUF_STRIDE, w, h, dir ? 4 : 0, dir ? 0 : 4);
+                memcpy(b->dst_opt, b->dst_ref, BUF_SIZE);
+                random_deblock_args(&a, 1, 0);
+                if (dir) {
+                    ref->hevc_v_loop_filter_luma(pix_ref, BUF_STRIDE, a.beta[0], a.tc, a.no_p, a.no_q);
+                    opt->hevc_v_loop_filter_luma(pix_opt, BUF_STRIDE, a.beta[0], a.tc, a.no_p, a.no_q);
+                } else {
+                    ref->hevc_h_loop_filter_luma(pix_ref, BUF_STRIDE, a.beta[0], a.tc, a.no_p, a.no_q);
+                    opt->hevc_h_loop_filter_luma(pix_opt, BUF_STRIDE, a.beta[0], a.tc, a.no_p, a.no_q);
+                }
+                ok = cmp_pixels(blk_ref, blk_opt, BUF_STRIDE, w, h);
+            }
+            if (ok && state.bench) {
+                if (dir) {
+                    BENCH(t_ref, ref->hevc_v_loop_filter_luma(pix_ref, BUF_STRIDE, a.beta[0], a.tc, a.no_p, a.no_q));
+                    BENCH(t_opt, opt->hevc_v_loop_filter_luma(pix_opt, BUF_STRIDE, a.beta[0], a.tc, a.no_p, a.no_q));
+                } else {
+                    BENCH(t_ref, ref->hevc_h_loop_filter_luma(pix_ref, BUF_STRIDE, a.beta[0], a.tc, a.no_p, a.no_q));
+                    BENCH(t_opt, opt->hevc_h_loop_filter_luma(pix_opt, BUF_STRIDE, a.beta[0], a.tc, a.no_p, a.no_q));
+                }
+            }
+            report(name, ok, t_ref, t_opt);
+        }
+
+        if (check_func(dir ? (const void *)opt->hevc_v_loop_filter_chroma  : (const void *)opt->hevc_h_loop_filter_chroma,
+                       dir ? (const void *)prev->hevc_v_loop_filter_chroma : (const void *)prev->hevc_h_loop_filter_chroma,
+                       name, sizeof(name), "hevc_%c_loop_filter_chroma", dir ? 'v' : 'h')) {
+            for (k = 0, ok = 1; k < 64 && ok; k++) {
+                fill_edge(blk_ref, BUF_STRIDE, w, h, dir ? 4 : 0, dir ? 0 : 4);
+                memcpy(b->dst_opt, b->dst_ref, BUF_SIZE);
+                random_deblock_args(&a, 1, 0);
+                if (dir) {
+                    ref->hevc_v_loop_filter_chroma(pix_ref, BUF_STRIDE, a.tc, a.no_p, a.no_q);
+                    opt->hevc_v_loop_filter_chroma(pix_opt, BUF_STRIDE, a.tc, a.no_p, a.no_q);
+                } else {
+                    ref->hevc_h_loop_filter_chroma(pix_ref, BUF_STRIDE, a.tc, a.no_p, a.no_q);
+                    opt->hevc_h_loop_filter_chroma(pix_opt, BUF_STRIDE, a.tc, a.no_p, a.no_q);
+                }
+                ok = cmp_pixels(blk_ref, blk_opt, BUF_STRIDE, w, h);
+            }
+            if (ok && state.bench) {
+                if (dir) {
+                    BENCH(t_ref, ref->hevc_v_loop_filter_chroma(pix_ref, BUF_STRIDE, a.tc, a.no_p, a.no_q));
+                    BENCH(t_opt, opt->hevc_v_loop_filter_chroma(pix_opt, BUF_STRIDE, a.tc, a.no_p, a.no_q));
+                } else {
+                    BENCH(t_ref, ref->hevc_h_loop_filter_chroma(pix_ref, BUF_STRIDE, a.tc, a.no_p, a.no_q));
+                    BENCH(t_opt, opt->hevc_h_loop_filter_chroma(pix_opt, BUF_STRIDE, a.tc, a.no_p, a.no_q));
+                }
+            }
+            report(name, ok, t_ref, t_opt);
+        }
+
+        /* whole CTB edges, checked against the 8 line C functions the
+         * decoder falls back to when they are not set */
+        if (check_func(dir ? (const void *)opt->hevc_v_loop_filter_luma_edge  : (const void *)opt->hevc_h_loop_filter_luma_edge,
+                       dir ? (const void *)prev->hevc_v_loop_filter_luma_edge : (const void *)prev->hevc_h_loop_filter_luma_edge,
+                       name, sizeof(name), "hevc_%c_loop_filter_luma_edge", dir ? 'v' : 'h')) {
+            int nb_blocks = 8;
+
+            for (k = 0, ok = 1; k < 64 && ok; k++) {
+                nb_blocks = rnd_range(1, 8);
+                fill_edge(blk_ref, BUF_STRIDE, w, h, dir ? 4 : 0, dir ? 0 : 4);
+                memcpy(b->dst_opt, b->dst_ref, BUF_SIZE);
+                random_deblock_args(&a, nb_blocks, 1);
+                luma_edge_ref(ref, pix_ref, dir, &a, nb_blocks);
+                if (dir)
+                    opt->hevc_v_loop_filter_luma_edge(pix_opt, BUF_STRIDE, a.beta, a.tc, a.no_p, a.no_q, nb_blocks);
+                else
+                    opt->hevc_h_loop_filter_luma_edge(pix_opt, BUF_STRIDE, a.beta, a.tc, a.no_p, a.no_q, nb_blocks);
+                ok = cmp_pixels(blk_ref, blk_opt, BUF_STRIDE, w, h);
+                if (!ok)
+                    printf("  %s: mismatch for %d blocks\n", name, nb_blocks);
+            }
+            if (ok && state.bench) {
+                random_deblock_args(&a, 8, 0);
+                BENCH(t_ref, luma_edge_ref(ref, pix_ref, dir, &a, 8));
+                if (dir)
+                    BENCH(t_opt, opt->hevc_v_loop_filter_luma_edge(pix_opt, BUF_STRIDE, a.beta, a.tc, a.no_p, a.no_q, 8));
+                else
+                    BENCH(t_opt, opt->hevc_h_loop_filter_luma_edge(pix_opt, BUF_STRIDE, a.beta, a.tc, a.no_p, a.no_q, 8));
+            }
+            report(name, ok, t_ref, t_opt);
+        }
+    }
+}
+
+/*
+ * SAO
+ */
+
+static void random_sao_params(SAOParams *sao, int c_idx, int band)
+{
+    int max = (1 << (FFMIN(state.bit_depth, 10) - 5)) - 1;
+    int shift = state.bit_depth - FFMIN(state.bit_depth, 10);
+    int i;
+
+    memset(sao, 0, sizeof(*sao));
+    sao->band_position[c_idx] = rnd_range(0, 31);
+    sao->eo_class[c_idx]      = rnd_range(0, 3);
+    for (i = 0; i < 4; i++) {
+        int v = rnd_range(0, max);
+        if (band)
+            v = rnd() & 1 ? -v : v;
+        else if (i >= 2)
+            v = -v;
+        sao->offset_val[c_idx][i + 1] = v << shift;
+    }
+}
+
+static void check_sao(const HEVCDSPContext *ref, const HEVCDSPContext *prev,
+                      const HEVCDSPContext *opt, const Buffers *b)
+{
+    int ps = state.bit_depth > 8;
+    char name[64];
+    int f, k;
+
+    for (f = -1; f < 2; f++) {
+        const void *fopt  = f < 0 ? (const void *)opt->sao_band_filter  : (const void *)opt->sao_edge_filter[f];
+        const void *fprev = f < 0 ? (const void *)prev->sao_band_filter : (const void *)prev->sao_edge_filter[f];
+        uint8_t vert_edge[2], horiz_edge[2], diag_edge[4];
+        int borders[4];
+        SAOParams sao;
+        int width = 64, height = 64, c_idx = 0;
+        double t_ref = 0, t_opt = 0;
+        int i, ok = 1;
+
+        if (!(f < 0 ? check_func(fopt, fprev, name, sizeof(name), "sao_band_filter") :
+                      check_func(fopt, fprev, name, sizeof(name), "sao_edge_filter_%d", f)))
+            continue;
+
+        for (k = 0; k < 64 && ok; k++) {
+            c_idx  = rnd_range(0, 2);
+            width  = c_idx ? 4 * rnd_range(1, 8) : 8 * rnd_range(1, 8);
+            height = c_idx ? 4 * rnd_range(1, 8) : 8 * rnd_range(1, 8);
+            random_sao_params(&sao, c_idx, f < 0);
+            for (i = 0; i < 4; i++)
+                borders[i] = rnd() & 1;
+            for (i = 0; i < 2; i++) {
+                vert_edge[i]  = rnd() & 1;
+                horiz_edge[i] = rnd() & 1;
+            }
+            for (i = 0; i < 4; i++)
+                diag_edge[i] = rnd() & 1;
+
+            fill_pixels(b->src - BUF_OFFSET, BUF_STRIDE, BUF_STRIDE >> ps, BUF_SIZE / BUF_STRIDE);
+            /* the edge filters only replace the samples they filter */
+            memcpy(b->dst_ref, b->src - BUF_OFFSET, BUF_SIZE);
+            memcpy(b->dst_opt, b->src - BUF_OFFSET, BUF_SIZE);
+            if (f < 0) {
+                ref->sao_band_filter(b->dst_ref + BUF_OFFSET, b->src, BUF_STRIDE, BUF_STRIDE,
+                                     &sao, borders, width, height, c_idx);
+                opt->sao_band_filter(b->dst_opt + BUF_OFFSET, b->src, BUF_STRIDE, BUF_STRIDE,
+                                     &sao, borders, width, height, c_idx);
+            } else {
+                ref->sao_edge_filter[f](b->dst_ref + BUF_OFFSET, b->src, BUF_STRIDE, BUF_STRIDE,
+                                        &sao, borders, width, height, c_idx,
+                                        vert_edge, horiz_edge, diag_edge);
+                opt->sao_edge_filter[f](b->dst_opt + BUF_OFFSET, b->src, BUF_STRIDE, BUF_STRIDE,
+                                        &sao, borders, width, height, c_idx,
+                                        vert_edge, horiz_edge, diag_edge);
+            }
+            ok = cmp_pixels(b->dst_ref + BUF_OFFSET, b->dst_opt + BUF_OFFSET, BUF_STRIDE, width, height);
+            if (!ok)
+                printf("  %s: mismatch for %dx%d c_idx %d class %d\n", name,
+                       width, height, c_idx, f < 0 ? -1 : sao.eo_class[c_idx]);
+        }
+        if (ok && state.bench) {
+            width = height = 64;
+            c_idx = 0;
+            memset(borders, 0, sizeof(borders));
+            if (f < 0) {
+                BENCH(t_ref, ref->sao_band_filter(b->dst_ref + BUF_OFFSET, b->src, BUF_STRIDE, BUF_STRIDE,
+                                                  &sao, borders, width, height, c_idx));
+                BENCH(t_opt, opt->sao_band_filter(b->dst_opt + BUF_OFFSET, b->src, BUF_STRIDE, BUF_STRIDE,
+                                                  &sao, borders, width, height, c_idx));
+            } else {
+                BENCH(t_ref, ref->sao_edge_filter[f](b->dst_ref + BUF_OFFSET, b->src, BUF_STRIDE, BUF_STRIDE,
+                                                     &sao, borders, width, height, c_idx,
+                                                     vert_edge, horiz_edge, diag_edge));
+                BENCH(t_opt, opt->sao_edge_filter[f](b->dst_opt + BUF_OFFSET, b->src, BUF_STRIDE, BUF_STRIDE,
+                                                     &sao, borders, width, height, c_idx,
+                                                     vert_edge, horiz_edge, diag_edge));
+            }
+        }
+        report(name, ok, t_ref, t_opt);
+    }
+}
+
+/*
+ * transforms and PCM
+ */
+
+/**
+ * Random coefficients inside the bounding box of the last significant
+ * coefficient, with the col_limit hevc_cabac.c derives from it.
+ */
+static int random_idct_coeffs(int16_t *coeffs, int size)
+{
+    int last_x = rnd_range(0, size - 1);
+    int last_y = rnd_range(0, size - 1);
+    int max_xy = FFMAX(last_x, last_y);
+    int col_limit = last_x + last_y + 4;
+    int x, y;
+
+    if (rnd() & 1)
+        last_x = last_y = max_xy = FFMIN(max_xy, 3);
+    for (y = 0; y < size; y++)
+        for (x = 0; x < size; x++)
+            coeffs[y * size + x] = x <= last_x && y <= last_y ? rnd_range(-2048, 2047) : 0;
+
+    col_limit = last_x + last_y + 4;
+    if (max_xy < 4)
+        col_limit = FFMIN(4, col_limit);
+    else if (max_xy < 8)
+        col_limit = FFMIN(8, col_limit);
+    else if (max_xy < 12)
+        col_limit = FFMIN(24, col_limit);
+    return col_limit;
+}
+
+static void check_transform(const HEVCDSPContext *ref, const HEVCDSPContext *prev,
+                            const HEVCDSPContext *opt, const Buffers *b)
+{
+    char name[64];
+    int i, k;
+
+    for (i = 0; i < 4; i++) {
+        int size = 4 << i, n = size * size;
+        double t_ref = 0, t_opt = 0;
+        int ok = 1;
+
+        if (check_func(opt->transform_add[i], prev->transform_add[i], name, sizeof(name),
+                       "transform_add%dx%d", size, size)) {
+            for (k = 0; k < 16 && ok; k++) {
+                fill_pixels(b->dst_ref, BUF_STRIDE, size, size);
+                memcpy(b->dst_opt, b->dst_ref, BUF_SIZE);
+                fill_coeffs(b->coeffs_ref, n, 1 << (state.bit_depth + 1));
+                memcpy(b->coeffs_opt, b->coeffs_ref, n * sizeof(*b->coeffs_ref));
+                ref->transform_add[i](b->dst_ref, b->coeffs_ref, BUF_STRIDE);
+                opt->transform_add[i](b->dst_opt, b->coeffs_opt, BUF_STRIDE);
+                ok = cmp_pixels(b->dst_ref, b->dst_opt, BUF_STRIDE, size, size);
+            }
+            if (ok && state.bench) {
+                BENCH(t_ref, ref->transform_add[i](b->dst_ref, b->coeffs_ref, BUF_STRIDE));
+                BENCH(t_opt, opt->transform_add[i](b->dst_opt, b->coeffs_opt, BUF_STRIDE));
+            }
+            report(name, ok, t_ref, t_opt);
+        }
+
+        if (check_func(opt->idct[i], prev->idct[i], name, sizeof(name),
+                       "idct_%dx%d", size, size)) {
+            int col_limit = size;
+
+            for (k = 0, ok = 1; k < 64 && ok; k++) {
+                col_limit = random_idct_coeffs(b->coeffs_ref, size);
+                memcpy(b->coeffs_opt, b->coeffs_ref, n * sizeof(*b->coeffs_ref));
+                ref->idct[i](b->coeffs_ref, col_limit);
+                opt->idct[i](b->coeffs_opt, col_limit);
+                ok = cmp_coeffs(b->coeffs_ref, b->coeffs_opt, size, size, size);
+                if (!ok)
+                    printf("  %s: mismatch for col_limit %d\n", name, col_limit);
+            }
+            if (ok && state.bench) {
+                BENCH(t_ref, ref->idct[i](b->coeffs_ref, 32));
+                BENCH(t_opt, opt->idct[i](b->coeffs_opt, 32));
+            }
+            report(name, ok, t_ref, t_opt);
+        }
+
+        if (check_func(opt->idct_dc[i], prev->idct_dc[i], name, sizeof(name),
+                       "idct_%dx%d_dc", size, size)) {
+            for (k = 0, ok = 1; k < 16 && ok; k++) {
+                fill_coeffs(b->coeffs_ref, n, 4096);
+                memcpy(b->coeffs_opt, b->coeffs_ref, n * sizeof(*b->coeffs_ref));
+                ref->idct_dc[i](b->coeffs_ref);
+                opt->idct_dc[i](b->coeffs_opt);
+                ok = cmp_coeffs(b->coeffs_ref, b->coeffs_opt, size, size, size);
+            }
+            if (ok && state.bench) {
+                BENCH(t_ref, ref->idct_dc[i](b->coeffs_ref));
+                BENCH(t_opt, opt->idct_dc[i](b->coeffs_opt));
+            }
+            report(name, ok, t_ref, t_opt);
+        }
+    }
+
+    if (check_func(opt->idct_4x4_luma, prev->idct_4x4_luma, name, sizeof(name), "idct_4x4_luma")) {
+        double t_ref = 0, t_opt = 0;
+        int ok = 1;
+
+        for (k = 0; k < 64 && ok; k++) {
+            fill_coeffs(b->coeffs_ref, 16, 2048);
+            memcpy(b->coeffs_opt, b->coeffs_ref, 16 * sizeof(*b->coeffs_ref));
+            ref->idct_4x4_luma(b->coeffs_ref);
+            opt->idct_4x4_luma(b->coeffs_opt);
+            ok = cmp_coeffs(b->coeffs_ref, b->coeffs_opt, 4, 4, 4);
+        }
+        if (ok && state.bench) {
+            BENCH(t_ref, ref->idct_4x4_luma(b->coeffs_ref));
+            BENCH(t_opt, opt->idct_4x4_luma(b->coeffs_opt));
+        }
+        report(name, ok, t_ref, t_opt);
+    }
+
+    if (check_func(opt->transform_skip, prev->transform_skip, name, sizeof(name), "transform_skip")) {
+        double t_ref = 0, t_opt = 0;
+        int log2_size = 2, ok = 1;
+
+        for (k = 0; k < 64 && ok; k++) {
+            log2_size = rnd_range(2, 5);
+            fill_coeffs(b->coeffs_ref, 1 << 2 * log2_size, 1 << 12);
+            memcpy(b->coeffs_opt, b->coeffs_ref, sizeof(*b->coeffs_ref) << 2 * log2_size);
+            ref->transform_skip(b->coeffs_ref, log2_size);
+            opt->transform_skip(b->coeffs_opt, log2_size);
+            ok = cmp_coeffs(b->coeffs_ref, b->coeffs_opt, 0, 1 << 2 * log2_size, 1);
+            if (!ok)
+                printf("  %s: mismatch for log2_size %d\n", name, log2_size);
+        }
+        if (ok && state.bench) {
+            BENCH(t_ref, ref->transform_skip(b->coeffs_ref, 2));
+            BENCH(t_opt, opt->transform_skip(b->coeffs_opt, 2));
+        }
+        report(name, ok, t_ref, t_opt);
+    }
+
+    if (check_func(opt->transform_rdpcm, prev->transform_rdpcm, name, sizeof(name), "transform_rdpcm")) {
+        double t_ref = 0, t_opt = 0;
+        int log2_size = 2, mode = 0, ok = 1;
+
+        for (k = 0; k < 64 && ok; k++) {
+            log2_size = rnd_range(2, 5);
+            mode      = rnd() & 1;
+            fill_coeffs(b->coeffs_ref, 1 << 2 * log2_size, 1 << 8);
+            memcpy(b->coeffs_opt, b->coeffs_ref, sizeof(*b->coeffs_ref) << 2 * log2_size);
+            ref->transform_rdpcm(b->coeffs_ref, log2_size, mode);
+            opt->transform_rdpcm(b->coeffs_opt, log2_size, mode);
+            ok = cmp_coeffs(b->coeffs_ref, b->coeffs_opt, 0, 1 << 2 * log2_size, 1);
+            if (!ok)
+                printf("  %s: mismatch for log2_size %d mode %d\n", name, log2_size, mode);
+        }
+        if (ok && state.bench) {
+            BENCH(t_ref, ref->transform_rdpcm(b->coeffs_ref, 3, 0));
+            BENCH(t_opt, opt->transform_rdpcm(b->coeffs_opt, 3, 0));
+        }
+        report(name, ok, t_ref, t_opt);
+    }
+
+    if (check_func(opt->cross_component_pred, prev->cross_component_pred, name, sizeof(name),
+                   "cross_component_pred")) {
+        int16_t *coeffs_y = b->tmp;
+        double t_ref = 0, t_opt = 0;
+        int log2_size = 2, res_scale_val = 1, ok = 1;
+
+        for (k = 0; k < 64 && ok; k++) {
+            log2_size     = rnd_range(2, 5);
+            res_scale_val = (1 << rnd_range(0, 3)) * (rnd() & 1 ? -1 : 1);
+            fill_coeffs(coeffs_y, 1 << 2 * log2_size, (1 << 15) - 1);
+            fill_coeffs(b->coeffs_ref, 1 << 2 * log2_size, (1 << 15) - 1);
+            memcpy(b->coeffs_opt, b->coeffs_ref, sizeof(*b->coeffs_ref) << 2 * log2_size);
+            ref->cross_component_pred(b->coeffs_ref, coeffs_y, res_scale_val, log2_size);
+            opt->cross_component_pred(b->coeffs_opt, coeffs_y, res_scale_val, log2_size);
+            ok = cmp_coeffs(b->coeffs_ref, b->coeffs_opt, 0, 1 << 2 * log2_size, 1);
+            if (!ok)
+                printf("  %s: mismatch for log2_size %d res_scale_val %d\n",
+                       name, log2_size, res_scale_val);
+        }
+        if (ok && state.bench) {
+            BENCH(t_ref, ref->cross_component_pred(b->coeffs_ref, coeffs_y, res_scale_val, 4));
+            BENCH(t_opt, opt->cross_component_pred(b->coeffs_opt, coeffs_y, res_scale_val, 4));
+        }
+        report(name, ok, t_ref, t_opt);
+    }
+
+    if (check_func(opt->put_pcm, prev->put_pcm, name, sizeof(name), "put_pcm")) {
+        uint8_t *bits = (uint8_t *)b->coeffs_ref;
+        GetBitContext gb;
+        double t_ref = 0, t_opt = 0;
+        int w = 8, h = 8, pcm_bd = 8, ok = 1, i;
+
+        for (k = 0; k < 64 && ok; k++) {
+            w      = 8 << rnd_range(0, 2);
+            h      = w;
+            pcm_bd = rnd_range(1, state.bit_depth);
+            for (i = 0; i < 32 * 32 * 2; i++)
+                bits[i] = rnd();
+            memset(b->dst_ref, 0, BUF_SIZE);
+            memset(b->dst_opt, 0, BUF_SIZE);
+            init_get_bits(&gb, bits, w * h * pcm_bd);
+            ref->put_pcm(b->dst_ref, BUF_STRIDE, w, h, &gb, pcm_bd);
+            init_get_bits(&gb, bits, w * h * pcm_bd);
+            opt->put_pcm(b->dst_opt, BUF_STRIDE, w, h, &gb, pcm_bd);
+            ok = cmp_pixels(b->dst_ref, b->dst_opt, BUF_STRIDE, w, h);
+        }
+        if (ok && state.bench) {
+            BENCH(t_ref, (init_get_bits(&gb, bits, w * h * pcm_bd),
+                          ref->put_pcm(b->dst_ref, BUF_STRIDE, w, h, &gb, pcm_bd)));
+            BENCH(t_opt, (init_get_bits(&gb, bits, w * h * pcm_bd),
+                          opt->put_pcm(b->dst_opt, BUF_STRIDE, w, h, &gb, pcm_bd)));
+        }
+        report(name, ok, t_ref, t_opt);
+    }
+}
+
+/*
+ * intra prediction
+ */
+
+/**
+ * Random top and left neighbours of a size x size block, both starting at
+ * index -1 with the shared top left sample.
+ */
+static void random_neighbours(uint8_t *top, uint8_t *left, int size)
+{
+    int i;
+
+    for (i = -1; i < 2 * size; i++) {
+        set_pixel(top,  i, rnd() & ((1 << state.bit_depth) - 1));
+        set_pixel(left, i, rnd() & ((1 << state.bit_depth) - 1));
+    }
+    set_pixel(left, -1, get_pixel(top, -1));
+}
+
+static void check_pred(const HEVCPredContext *ref, const HEVCPredContext *prev,
+                       const HEVCPredContext *opt, const Buffers *b)
+{
+    int ps = state.bit_depth > 8;
+    /* neighbour arrays live in the coefficient buffers, index -1 included */
+    uint8_t *top  = (uint8_t *)b->coeffs_ref + (16 << ps);
+    uint8_t *left = (uint8_t *)b->coeffs_opt + (16 << ps);
+    char name[64];
+    int i, k;
+
+    for (i = 0; i < 4; i++) {
+        int size = 4 << i;
+        double t_ref = 0, t_opt = 0;
+        int ok = 1;
+
+        if (check_func(opt->pred_planar[i], prev->pred_planar[i], name, sizeof(name),
+                       "pred_planar_%dx%d", size, size)) {
+            for (k = 0; k < 16 && ok; k++) {
+                random_neighbours(top, left, size);
+                ref->pred_planar[i](b->dst_ref, top, left, BUF_STRIDE);
+                opt->pred_planar[i](b->dst_opt, top, left, BUF_STRIDE);
+                ok = cmp_pixels(b->dst_ref, b->dst_opt, BUF_STRIDE, size, size);
+            }
+            if (ok && state.bench) {
+                BENCH(t_ref, ref->pred_planar[i](b->dst_ref, top, left, BUF_STRIDE));
+                BENCH(t_opt, opt->pred_planar[i](b->dst_opt, top, left, BUF_STRIDE));
+            }
+            report(name, ok, t_ref, t_opt);
+        }
+
+        if (check_func(opt->pred_angular[i], prev->pred_angular[i], name, sizeof(name),
+                       "pred_angular_%dx%d", size, size)) {
+            int mode = 2, c_idx = 0;
+
+            for (k = 0; k < 4 * 33 && ok; k++) {
+                mode  = 2 + k % 33;
+                c_idx = (k / 33) & 1;
+                random_neighbours(top, left, size);
+                ref->pred_angular[i](b->dst_ref, top, left, BUF_STRIDE, c_idx, mode);
+                opt->pred_angular[i](b->dst_opt, top, left, BUF_STRIDE, c_idx, mode);
+                ok = cmp_pixels(b->dst_ref, b->dst_opt, BUF_STRIDE, size, size);
+                if (!ok)
+                    printf("  %s: mismatch for mode %d c_idx %d\n", name, mode, c_idx);
+            }
+            if (ok && state.bench) {
+                BENCH(t_ref, ref->pred_angular[i](b->dst_ref, top, left, BUF_STRIDE, 0, 18));
+                BENCH(t_opt, opt->pred_angular[i](b->dst_opt, top, left, BUF_STRIDE, 0, 18));
+            }
+            report(name, ok, t_ref, t_opt);
+        }
+    }
+
+    if (check_func(opt->pred_dc, prev->pred_dc, name, sizeof(name), "pred_dc")) {
+        double t_ref = 0, t_opt = 0;
+        int ok = 1;
+
+        for (k = 0; k < 64 && ok; k++) {
+            int log2_size = rnd_range(2, 5), c_idx = rnd() & 1;
+
+            random_neighbours(top, left, 1 << log2_size);
+            ref->pred_dc(b->dst_ref, top, left, BUF_STRIDE, log2_size, c_idx);
+            opt->pred_dc(b->dst_opt, top, left, BUF_STRIDE, log2_size, c_idx);
+            ok = cmp_pixels(b->dst_ref, b->dst_opt, BUF_STRIDE, 1 << log2_size, 1 << log2_size);
+            if (!ok)
+                printf("  %s: mismatch for log2_size %d c_idx %d\n", name, log2_size, c_idx);
+        }
+        if (ok && state.bench) {
+            BENCH(t_ref, ref->pred_dc(b->dst_ref, top, left, BUF_STRIDE, 3, 0));
+            BENCH(t_opt, opt->pred_dc(b->dst_opt, top, left, BUF_STRIDE, 3, 0));
+        }
+        report(name, ok, t_ref, t_opt);
+    }
+}
+
+static void print_usage(const char *prog)
+{
+    printf("usage: %s [-b] [-d bit_depth] [-f name] [-s seed]\n"
+           "  -b            benchmark the checked functions\n"
+           "  -d bit_depth  only check this bit depth (8, 10 or 12)\n"
+           "  -f name       only check functions whose name contains name\n"
+           "  -s seed       random seed\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+    static const int bit_depths[] = { 8, 10, 12 };
+    HEVCDSPContext ref, prev, opt;
+    HEVCPredContext pred_ref, pred_prev, pred_opt;
+    Buffers b;
+    int host_flags, only_depth = 0;
+    int d, t, i;
+
+    state.seed = 0x2545f491;
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-b")) {
+            state.bench = 1;
+        } else if (!strcmp(argv[i], "-d") && i + 1 < argc) {
+            only_depth = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-f") && i + 1 < argc) {
+            state.filter = argv[++i];
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            state.seed = strtoul(argv[++i], NULL, 0);
+            if (!state.seed)
+                state.seed = 1;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    printf("seed 0x%08x\n", state.seed);
+    if (state.bench)
+        printf("timings in " BENCH_UNIT " per call\n");
+
+    b.src        = (uint8_t *)av_mallocz(BUF_SIZE) + BUF_OFFSET;
+    b.dst_ref    = av_mallocz(BUF_SIZE);
+    b.dst_opt    = av_mallocz(BUF_SIZE);
+    b.tmp        = av_mallocz(MAX_PB_SIZE * MAX_PB_SIZE * sizeof(int16_t));
+    b.coeffs_ref = av_mallocz(64 * 64 * sizeof(int16_t));
+    b.coeffs_opt = av_mallocz(64 * 64 * sizeof(int16_t));
+    if (b.src == (uint8_t *)BUF_OFFSET || !b.dst_ref || !b.dst_opt ||
+        !b.tmp || !b.coeffs_ref || !b.coeffs_opt) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    av_force_cpu_flags(-1);
+    host_flags = av_get_cpu_flags();
+
+    for (d = 0; d < FF_ARRAY_ELEMS(bit_depths); d++) {
+        int tier_flags = 0;
+
+        state.bit_depth = bit_depths[d];
+        if (only_depth && only_depth != state.bit_depth)
+            continue;
+
+        av_force_cpu_flags(0);
+        ff_hevc_dsp_init(&ref, state.bit_depth);
+        ff_hevc_pred_init(&pred_ref, state.bit_depth);
+        prev      = ref;
+        pred_prev = pred_ref;
+
+        for (t = 0; t < FF_ARRAY_ELEMS(tiers); t++) {
+            tier_flags |= tiers[t].flags;
+            if ((host_flags & tiers[t].flags) != tiers[t].flags)
+                break;
+
+            state.tier = tiers[t].name;
+            av_force_cpu_flags(tier_flags & host_flags);
+            ff_hevc_dsp_init(&opt, state.bit_depth);
+            ff_hevc_pred_init(&pred_opt, state.bit_depth);
+            printf("%d bit %s:\n", state.bit_depth, state.tier);
+
+            check_mc(&ref, &prev, &opt, &b, 1);
+            check_mc(&ref, &prev, &opt, &b, 0);
+            check_deblock(&ref, &prev, &opt, &b);
+            check_sao(&ref, &prev, &opt, &b);
+            check_transform(&ref, &prev, &opt, &b);
+            check_pred(&pred_ref, &pred_prev, &pred_opt, &b);
+
+            prev      = opt;
+            pred_prev = pred_opt;
+        }
+    }
+    av_force_cpu_flags(-1);
+
+    printf("%d functions checked, %d failed\n", state.nb_checked, state.nb_failed);
+
+    av_free(b.src - BUF_OFFSET);
+    av_free(b.dst_ref);
+    av_free(b.dst_opt);
+    av_free(b.tmp);
+    av_free(b.coeffs_ref);
+    av_free(b.coeffs_opt);
+    return state.nb_failed ? 1 : 0;
+}
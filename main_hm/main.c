@@ -136,6 +136,8 @@ static void video_decode_example(const char *filename)
 #endif
     int video_stream_idx;
     char output_file2[256];
+    AVDictionary *input_opts = NULL;
+    char async_filename[1024];
 
     OpenHevc_Frame     openHevcFrame;
     OpenHevc_Frame_cpy openHevcFrameCpy;
@@ -156,10 +158,18 @@ static void video_decode_example(const char *filename)
     av_register_all();
     pFormatCtx = avformat_alloc_context();
 
-    if(avformat_open_input(&pFormatCtx, filename, NULL, NULL)!=0) {
+    if (read_ahead > 0) {
+        snprintf(async_filename, sizeof(async_filename), "async:%s", filename);
+        av_dict_set_int(&input_opts, "async_depth", read_ahead, 0);
+        filename = async_filename;
+    }
+    if (map_input)
+        av_dict_set(&input_opts, "mmap", "1", 0);
+    if(avformat_open_input(&pFormatCtx, filename, NULL, &input_opts)!=0) {
         printf("%s",filename);
         exit(1); // Couldn't open file
     }
+    av_dict_free(&input_opts);
     if ( (video_stream_idx = av_find_best_stream(pFormatCtx, AVMEDIA_TYPE_VIDEO, -1, -1, NULL, 0)) < 0) {
         fprintf(stderr, "Could not find video stream in input file\n");
         exit(1);
@@ -189,6 +199,19 @@ static void video_decode_example(const char *filename)
     libOpenHevcSetTemporalLayer_id(openHevcHandle, temporal_layer_id);
     libOpenHevcSetActiveDecoders(openHevcHandle, quality_layer_id);
     libOpenHevcSetViewLayers(openHevcHandle, quality_layer_id);
+    libOpenHevcSetSkipFrame(openHevcHandle, skip_mode);
+    if (seek_time > 0) {
+        AVStream *st = pFormatCtx->streams[video_stream_idx];
+        int64_t seek_pts = av_rescale_q(seek_time * AV_TIME_BASE, AV_TIME_BASE_Q, st->time_base);
+
+        if (st->start_time != AV_NOPTS_VALUE)
+            seek_pts += st->start_time;
+        if (av_seek_frame(pFormatCtx, video_stream_idx, seek_pts, AVSEEK_FLAG_BACKWARD) < 0) {
+            fprintf(stderr, "Could not seek to %g s in input file\n", seek_time);
+            exit(1);
+        }
+        libOpenHevcSeek(openHevcHandle, seek_pts);
+    }
 #if FRAME_CONCEALMENT
     fin_loss = fopen( "/Users/wassim/Softwares/shvc_transmission/parser/hevc_parser/BascketBall_Loss.txt", "rb");
     fin1 = fopen( "/Users/wassim/Softwares/shvc_transmission/parser/hevc_parser/BascketBall.txt", "rb");
@@ -1637,6 +1637,7 @@
 #define CONFIG_VP3_PARSER 1
 #define CONFIG_VP8_PARSER 1
 #define CONFIG_VP9_PARSER 1
+#define CONFIG_ASYNC_PROTOCOL 1
 #define CONFIG_BLURAY_PROTOCOL 0
 #define CONFIG_CACHE_PROTOCOL 1
 #define CONFIG_CONCAT_PROTOCOL 1